@@ -0,0 +1,169 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Overlapping Allan and modified Allan deviation of IMU data.
+ *
+ * For rate samples x (e.g. ang in rad/s, acc in m/s^2) at hz, with
+ * tau = m/hz and the integrated series theta_k = sum_{i<k} x_i/hz
+ * (P = n+1 points),
+ *
+ *   d_k        = theta_{k+2m} - 2 theta_{k+m} + theta_k
+ *   adev^2     = sum_{k=0}^{P-2m-1} d_k^2 / (2 tau^2 (P-2m))
+ *   S_j        = sum_{i=j}^{j+m-1} d_i
+ *   mdev^2     = sum_{j=0}^{P-3m} S_j^2 / (2 m^2 tau^2 (P-3m+1))
+ *
+ * Every d_k is three reads of the prefix sum theta, and S_j is kept as a
+ * running sum (add d_{j+m-1}, drop d_{j-1}), so each tau costs O(n)
+ * whatever m is, instead of the O(n m) of summing the windows.  The mean
+ * is subtracted before integrating to keep theta small.
+ *
+ * The batch functions split each axis into ranges of k, one task per
+ * axis and range on a WorkStealingPool, and walk each range in
+ * cache-sized blocks, doing every tau on a block before moving on, so
+ * theta is read from memory about once per tau group rather than once
+ * per tau.  Partial sums are added in a fixed order, so the result does
+ * not depend on the number of threads beyond rounding.
+ *
+ * AllanStream computes the same sums sample by sample, for data that is
+ * still arriving: O(number of taus) per sample, with the last 3 m_max + 1
+ * points of theta kept in a ring.  It subtracts the first sample instead
+ * of the mean, so its results match the batch ones to rounding.
+ */
+
+
+#ifndef ALLAN_H
+#define ALLAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <helper_funcs/imu_batch.h>
+
+/**
+ * @brief Compute the Allan deviation.
+ */
+#define ALLAN_ADEV 1
+
+/**
+ * @brief Compute the modified Allan deviation.
+ */
+#define ALLAN_MDEV 2
+
+/**
+ * @brief Default tau spacing (units: points per decade).
+ */
+#define ALLAN_PER_DECADE 5
+
+
+/**
+ * @brief Deviations at one averaging time.
+ */
+struct AllanPoint
+{
+
+  double tau; /**< Averaging time m/hz (units: seconds). */
+  uint64_t m; /**< Averaging factor (units: samples). */
+  double adev; /**< Overlapping Allan deviation, 0 if not computed. */
+  double mdev; /**< Modified Allan deviation, 0 if not computed. */
+  uint64_t num; /**< Number of terms in the Allan variance, P-2m. */
+
+};
+
+
+/**
+ * @brief Log-spaced averaging factors for n samples.
+ *
+ * From 1 up to n/3, the largest m with both deviations defined.
+ * @param n Number of samples.
+ * @param m Output, increasing and without repeats.
+ * @param per_decade Points per decade.
+ */
+extern void allan_tau_m(size_t n, std::vector<uint64_t>& m, double per_decade = ALLAN_PER_DECADE);
+
+/**
+ * @brief Allan and/or modified Allan deviation of one series.
+ *
+ * @param x Rate samples.
+ * @param n Number of samples.
+ * @param hz Sampling rate (units: Hz).
+ * @param m Averaging factors.  Those above n/3 are skipped.
+ * @param out One point per averaging factor computed, by increasing m.
+ * @param flags ALLAN_ADEV, ALLAN_MDEV or both.
+ * @param num_threads Worker threads, or 0 for one per core.
+ * @return Number of points, or -1 on bad arguments.
+ */
+extern int allan_deviation(const double* x, size_t n, double hz, const std::vector<uint64_t>& m,
+			   std::vector<AllanPoint>& out, int flags = ALLAN_ADEV | ALLAN_MDEV,
+			   int num_threads = 0);
+
+/**
+ * @brief Deviations of the three axes of a vector quantity, in one pass.
+ *
+ * @param w Window.
+ * @param v Vector quantity, e.g. IMU_ANG.
+ * @param hz Sampling rate (units: Hz).
+ * @param m Averaging factors.
+ * @param out Points of the x, y and z axes.
+ * @param flags ALLAN_ADEV, ALLAN_MDEV or both.
+ * @param num_threads Worker threads, or 0 for one per core.
+ * @return Number of points per axis, or -1 on bad arguments.
+ */
+extern int allan_deviation(const ImuBatchView& w, ImuVec v, double hz, const std::vector<uint64_t>& m,
+			   std::vector<AllanPoint> out[3], int flags = ALLAN_ADEV | ALLAN_MDEV,
+			   int num_threads = 0);
+
+
+/**
+ * @brief Incremental deviations of one series.
+ */
+class AllanStream
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param hz Sampling rate (units: Hz).
+   * @param m Averaging factors to track.  The ring holds 3 max(m) + 1
+   *        points of theta.
+   * @param flags ALLAN_ADEV, ALLAN_MDEV or both.
+   */
+  AllanStream(double hz, const std::vector<uint64_t>& m, int flags = ALLAN_ADEV | ALLAN_MDEV);
+
+  /**
+   * @brief Add samples.
+   */
+  void add(const double* x, size_t n);
+
+  /**
+   * @brief Deviations of everything added so far, for the factors with
+   *        enough samples (m <= n/3).
+   */
+  void result(std::vector<AllanPoint>& out) const;
+
+  /**
+   * @brief Number of samples added.
+   */
+  uint64_t size(void) const { return num; }
+
+  void reset(void);
+
+private:
+
+  double hz;
+  int flags;
+  std::vector<uint64_t> m;
+
+  std::vector<double> theta; // ring of the last points of theta
+  uint64_t mask;
+  uint64_t num;
+  double offset; // first sample, subtracted before integrating
+  double theta_last;
+
+  std::vector<double> sum_adev;
+  std::vector<double> sum_mdev;
+  std::vector<double> window; // S, the sum of the last m d_k
+
+};
+
+#endif
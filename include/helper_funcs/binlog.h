@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Parsers for the binary sensor logs.
+ *
+ * Decodes the raw device streams that log_this_now(log_fid, data, len)
+ * writes to the LOG_FID_KVH_BINARY_FORMAT (BKVH),
+ * LOG_FID_MST_BINARY_FORMAT (BMS) and LOG_FID_PHINS_BINARY_FORMAT (BINS)
+ * channels.  Files are memory mapped and scanned for frame sync words;
+ * every frame is checked (CRC-32, Fletcher or byte sum) and decoded
+ * straight into the columns of an ImuBatch.  After a bad frame the
+ * scanner resyncs on the next sync word.
+ *
+ * Frame layouts:
+ *
+ *   KVH 1750/1775   FE 81 FF 55 | gyro[3] accel[3] (float BE) | status | seq | temp (int16 BE) | CRC-32 (BE)
+ *                   FE 81 FF 56 | as above with mag[3] after accel (1775 extended)
+ *                   CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF) over
+ *                   everything before the CRC.
+ *
+ *   Microstrain MIP 75 65 | descriptor set | payload length | fields | Fletcher-16
+ *                   IMU set 0x80: 0x04 accel, 0x05 gyro, 0x06 mag (float BE x3),
+ *                   0x17 ambient pressure (float BE), 0x12 GPS time (tow double BE).
+ *
+ *   PHINS STDBIN    'I' 'X' | version | nav bitmask | [v3: extended nav bitmask] |
+ *                   external bitmask | telegram size (uint16 BE) |
+ *                   validity time (uint32 BE, 100 us) | counter | blocks in
+ *                   bit order | byte-sum checksum (uint32 BE).
+ *                   Protocol versions 2 and 3 are read.  ang and acc come from
+ *                   the vessel-frame rotation rate and acceleration blocks
+ *                   (nav bits 5 and 6, 3 float BE each); the attitude,
+ *                   heave, smart heave and rate blocks before them (bits
+ *                   0-4) are skipped at their own sizes.
+ *
+ * Units are whatever the sensor is configured to send, except PHINS
+ * rotation rates which are converted from deg/s to rad/s.
+ *
+ * Throughput is about 0.5-0.65 GB/s per core (10-11 Msamples/s,
+ * parse_test), not multiple GB/s.  The frames are 36-70 bytes, so the
+ * cost is per frame: finding the sync word, walking the fields and
+ * writing a sample's columns.  The checksums alone run at about 2 GB/s
+ * (MIP Fletcher, a serial chain of byte adds that unrolling did not
+ * speed up on frames this short) and 3-5 GB/s (PHINS byte sum, which the
+ * compiler vectorizes).
+ */
+
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <helper_funcs/imu_batch.h>
+
+/**
+ * @brief Binary log formats.
+ */
+#define BINLOG_FORMAT_UNKNOWN  -1
+#define BINLOG_FORMAT_KVH       0
+#define BINLOG_FORMAT_MST       1
+#define BINLOG_FORMAT_PHINS     2
+
+/**
+ * @brief Largest frame of any format.
+ */
+#define BINLOG_MAX_FRAME 65535
+
+/**
+ * @brief Shortest frame that yields a sample: a Microstrain IMU frame
+ *        with one 14-byte field.
+ */
+#define BINLOG_MIN_SAMPLE_FRAME 20
+
+
+/**
+ * @brief Read-only memory-mapped file.
+ */
+class MappedFile
+{
+public:
+
+  MappedFile(void) : ptr(NULL), len(0), fd(-1) {}
+  ~MappedFile(void) { close(); }
+
+  /**
+   * @brief Map a file.
+   * @return 0 on success, -1 on failure.
+   */
+  int open(const char* filename);
+
+  /**
+   * @brief Unmap.
+   */
+  void close(void);
+
+  const uint8_t* data(void) const { return ptr; }
+  size_t size(void) const { return len; }
+
+private:
+
+  const uint8_t* ptr;
+  size_t len;
+  int fd;
+
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+};
+
+
+/**
+ * @brief Parser statistics.
+ */
+struct BinlogStats
+{
+
+  uint64_t frames; /**< Frames with a valid checksum. */
+  uint64_t samples; /**< IMU samples decoded. */
+  uint64_t bad_checksum; /**< Frames rejected by their checksum. */
+  uint64_t resync_bytes; /**< Bytes skipped looking for a sync word. */
+  uint64_t untimed_leading; /**< Samples before the first with a time of its own (all of them for KVH). */
+
+};
+
+
+/**
+ * @brief Streaming binary log parser.
+ *
+ * parse() may be fed consecutive pieces of a stream; it consumes whole
+ * frames only and reports where an incomplete trailing frame starts, so
+ * the caller can carry those bytes into the next call.
+ */
+class BinlogParser
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param format BINLOG_FORMAT_KVH, _MST or _PHINS.
+   * @param hz Sampling rate, used to timestamp formats that carry no
+   *        time (KVH, MIP without GPS time).  0 leaves t at 0.
+   */
+  BinlogParser(int format, double hz = 0.0);
+
+  /**
+   * @brief Parse a buffer.
+   *
+   * @param data Bytes.
+   * @param size Number of bytes.
+   * @param out Decoded samples are appended here.
+   * @param final True if no more data follows, so a trailing partial
+   *        frame is counted as resync bytes instead of left unconsumed.
+   * @return Number of bytes consumed.
+   */
+  size_t parse(const uint8_t* data, size_t size, ImuBatch& out, bool final = true);
+
+  /**
+   * @brief Offset of the first valid frame in a buffer.
+   *
+   * Frames are checked but not decoded, and statistics are not updated.
+   * Used to split a stream at frame boundaries.
+   * @return Offset, or size if no whole valid frame starts in the buffer.
+   */
+  size_t next_frame(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Set the time of the next untimed sample.
+   */
+  void set_time(double t) { t_next = t; }
+
+  int format(void) const { return fmt; }
+  const BinlogStats& stats(void) const { return st; }
+
+private:
+
+  // return frame length if a whole valid frame starts at p, 0 if the
+  // frame is incomplete, -1 if it is invalid.  Decode into out unless
+  // it is NULL.
+  long frame_kvh(const uint8_t* p, size_t avail, ImuBatch* out);
+  long frame_mst(const uint8_t* p, size_t avail, ImuBatch* out);
+  long frame_phins(const uint8_t* p, size_t avail, ImuBatch* out);
+  long frame(const uint8_t* p, size_t avail, ImuBatch* out);
+
+  // next sync word at or after p, or NULL
+  const uint8_t* find_sync(const uint8_t* p, const uint8_t* end) const;
+
+  size_t emit(ImuBatch& out);
+
+  int fmt;
+  double dt;
+  double t_next;
+  BinlogStats st;
+
+};
+
+
+/**
+ * @brief Format of a log file from its suffix (BKVH, BMS, BINS).
+ */
+extern int binlog_format_from_filename(const char* filename);
+
+/**
+ * @brief Map and parse a whole binary log file.
+ *
+ * @param filename Log file.
+ * @param out Decoded samples are appended here.
+ * @param stats Optional output statistics.
+ * @param hz Sampling rate for untimed formats, or 0.
+ * @param format Format, or BINLOG_FORMAT_UNKNOWN to take it from the suffix.
+ * @return Number of samples decoded, or -1 if the file could not be read.
+ */
+extern long binlog_parse_file(const char* filename, ImuBatch& out, BinlogStats* stats = NULL,
+			      double hz = 0.0, int format = BINLOG_FORMAT_UNKNOWN);
+
+/**
+ * @brief CRC-32/MPEG-2 as used by KVH, table driven.
+ */
+extern uint32_t binlog_crc32_kvh(const uint8_t* data, size_t len);
+
+/**
+ * @brief Encode a KVH frame (48 bytes with mag, else 36).
+ * @return Frame length.
+ */
+extern int binlog_encode_kvh(const ImuPacket& pkt, bool with_mag, uint8_t* buf);
+
+/**
+ * @brief Encode a Microstrain MIP IMU frame with accel, gyro, mag,
+ *        pressure and, if with_gps, GPS time fields.
+ * @return Frame length.
+ */
+extern int binlog_encode_mst(const ImuPacket& pkt, uint8_t* buf, bool with_gps = true);
+
+/**
+ * @brief Encode a PHINS STDBIN v2 frame with rotation rate and
+ *        acceleration blocks.
+ * @return Frame length.
+ */
+extern int binlog_encode_phins(const ImuPacket& pkt, uint8_t* buf);
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Schema-driven parser for config files.
+ *
+ * Every key load_params() knows is one row of a table: its name, whether
+ * it is required, and a typed handler (int, degrees, string, vec3, diag3
+ * or roll-pitch-yaw) bound to its config_params member.  A key is found
+ * by hashing it into a 64-slot table; the hash seed is chosen so that the
+ * schema's names land in distinct slots, which a static_assert checks at
+ * compile time, so a lookup is one hash and one compare.
+ *
+ * A file is read with one read() into one buffer and parsed in one pass
+ * over it: lines are "key = value", blank lines and lines starting with #
+ * are skipped, spaces around = are optional, a # after a space ends the
+ * value ("hz = 100  # rate"), and CRLF line ends are fine.  A value that
+ * does not parse leaves its member as it was.
+ * Nothing is allocated per line; only string values and problems found
+ * allocate.
+ *
+ * Problems go into a ConfigReport, one line each: unknown keys (with the
+ * nearest known key, to catch rpy_r0 for rpy_ro), required keys that are
+ * missing, values that do not parse, and keys given twice (the last
+ * wins).  Unknown keys are only warnings, so a file can carry keys for
+ * other programs.
+ *
+ *   hz, rate, baud               int
+ *   lat                          degrees, stored in radians
+ *   o_file, i_file, last_mod,
+ *   port, log_location, frameId  string, double quotes removed
+ *   k_acc ... k_north            [a,b,c] as diag(a,b,c)
+ *   rpy_align, rpy_ro            [r,p,y] as rpy2rot()
+ *   ang_bias ... w_E_north       [a,b,c]
+ *
+ * Required: hz, lat, the eight k_ gains, rpy_align, rpy_ro and the three
+ * biases.
+ */
+
+
+#ifndef CONFIG_PARSE_H
+#define CONFIG_PARSE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <helper_funcs/helper_funcs.h>
+
+
+/**
+ * @brief Problems found parsing one config file.
+ */
+struct ConfigReport
+{
+
+  int unknown; /**< Keys not in the schema. */
+  int missing; /**< Required keys not given. */
+  int malformed; /**< Values that did not parse, and lines without =. */
+  int duplicate; /**< Keys given more than once. */
+  std::string text; /**< One line per problem, "line 12: ...". */
+
+  ConfigReport(void) : unknown(0), missing(0), malformed(0), duplicate(0) {}
+
+};
+
+
+/**
+ * @brief Set params to what a file that sets nothing gives: hz, rate and
+ *        baud 0, gains, biases and rotations NaN, lat NaN, acc_hat and
+ *        w_E_north the sentinel -100, strings empty.
+ */
+extern void config_params_defaults(config_params& params);
+
+/**
+ * @brief Parse config text into params, starting from the defaults.
+ *
+ * @param text Text of the file; need not be NUL-terminated.
+ * @param len Length of text.
+ * @param params Output.
+ * @param report Problems found, or NULL.
+ * @return 0, or -1 if a required key is missing or a value is malformed.
+ */
+extern int config_parse(const char* text, size_t len, config_params& params, ConfigReport* report);
+
+/**
+ * @brief Read and parse a config file.
+ * @return 0, or -1 if it could not be read or config_parse() failed.
+ */
+extern int config_load(const char* config_file, config_params& params, ConfigReport* report);
+
+/**
+ * @brief Read and parse many config files in parallel, e.g. for a sweep.
+ *
+ * @param config_files Files.
+ * @param params Output, one per file.
+ * @param reports Output, one per file, or NULL.
+ * @param num_threads Number of worker threads, or 0 for one per core.
+ * @return Number of files that failed.
+ */
+extern int config_load_many(const std::vector<std::string>& config_files,
+			    std::vector<config_params>& params,
+			    std::vector<ConfigReport>* reports,
+			    int num_threads = 0);
+
+/**
+ * @brief Print a report, if it has anything, under the file name.
+ */
+extern void config_report_print(FILE* fp, const char* config_file, const ConfigReport& report);
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Hot reload of a config file with lock-free reads of the params.
+ *
+ * ConfigWatcher owns the config_params of one config file.  It watches
+ * the file's directory with inotify, so edits in place and editors that
+ * write a new file and rename it over the old one are both seen, and on
+ * every change re-parses the file with config_load() (config_parse.h)
+ * and checks it with config_params_check().  A file with a missing or
+ * malformed key, or that fails the check, is reported and ignored: the
+ * params in use stay as they were.
+ *
+ * Each accepted load is a new config_params that is never written again,
+ * published by swapping one atomic pointer (read-copy-update).  Readers
+ * call current() for the params in use, which is one acquire load: no
+ * lock, no copy, and a reader is never blocked by a reload.  A pointer
+ * from current() stays valid for the life of the watcher, so a filter
+ * loop can take it once per sample and keep it for the sample.  Old
+ * snapshots are freed with the watcher; a reload per edit of a file of a
+ * few dozen lines costs about a kilobyte.
+ *
+ * version() counts the accepted loads, so a reader that caches values
+ * derived from the gains (observer_gains(), a Decimator) rebuilds them
+ * only when it changes.
+ */
+
+
+#ifndef CONFIG_WATCH_H
+#define CONFIG_WATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <helper_funcs/helper_funcs.h>
+
+
+/**
+ * @brief Check loaded params for values the estimator cannot run with.
+ *
+ * hz must be positive, rate (0 if not given) at most hz,
+ * lat a latitude, every gain and bias finite (config_load() leaves
+ * missing ones NaN), and R0 and R_align rotations.
+ * @param params Params to check.
+ * @param why Set to the first problem found, if not NULL.
+ * @param len Size of why.
+ * @return 0 if the params are usable, -1 if not.
+ */
+extern int config_params_check(const config_params& params, char* why, size_t len);
+
+
+/**
+ * @brief Watched config file with RCU publication of its params.
+ */
+class ConfigWatcher
+{
+public:
+
+  /**
+   * @brief Constructor.  Nothing is loaded until reload().
+   *
+   * @param config_file Config file.
+   */
+  ConfigWatcher(const char* config_file);
+
+  /**
+   * @brief Destructor.  Stops the thread and frees every snapshot, so no
+   *        pointer from current() may be used after it.
+   */
+  ~ConfigWatcher(void);
+
+  /**
+   * @brief Params in use, or NULL before the first good load.  Any thread.
+   */
+  const config_params* current(void) const { return cur.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Number of loads accepted so far.  Any thread.
+   */
+  uint64_t version(void) const { return num_loads.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Number of loads rejected.
+   */
+  uint64_t rejected(void) const { return num_rejected.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Load, check and publish the file now.
+   * @return 0 if published, -1 if the file was rejected.
+   */
+  int reload(void);
+
+  /**
+   * @brief Wait for and handle one round of file events.
+   *
+   * For callers that run their own loop instead of start().
+   * @param timeout_ms Longest wait, or -1 to wait forever.
+   * @return Number of reloads tried, or -1 on error.
+   */
+  int poll_once(int timeout_ms);
+
+  /**
+   * @brief Run poll_once() on a thread until stop().
+   * @return 0, or -1 if already running or the watch could not be set.
+   */
+  int start(void);
+
+  void stop(void);
+
+private:
+
+  std::string path;
+  std::string name; // file name within its directory, for the events
+
+  std::atomic<const config_params*> cur;
+  std::atomic<uint64_t> num_loads;
+  std::atomic<uint64_t> num_rejected;
+
+  std::mutex load_mutex; // one reload at a time
+  std::vector<config_params*> snapshots; // every snapshot published
+
+  int inotify_fd;
+  int wake_fd; // eventfd that interrupts poll() on stop()
+  std::thread thread;
+  std::atomic<bool> stopping;
+
+  ConfigWatcher(const ConfigWatcher&);
+  ConfigWatcher& operator=(const ConfigWatcher&);
+
+};
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Streaming anti-alias decimation of IMU batches from hz to rate.
+ *
+ * Decimator low-pass filters the nine ang/acc/mag axes of an ImuBatch
+ * and keeps one sample in M, M = round(hz/rate), so that a sensor logged
+ * at config_params::hz comes out at config_params::rate without the
+ * aliasing of plain subsampling.
+ *
+ * The filter is a linear-phase FIR, a Kaiser-windowed sinc designed at
+ * construction: its stopband starts at the output Nyquist frequency
+ * rate/2 and its DC gain is 1.  The length is taps_per_phase*M, so the
+ * cost per input sample is taps_per_phase multiply-adds per axis
+ * whatever the ratio.
+ *
+ * It runs in polyphase form: each block of input is split into its M
+ * phases, and every tap becomes one multiply-add over a contiguous run
+ * of outputs, a loop the compiler vectorizes.  Blocks of any size may be
+ * passed; the state carried between them is the last taps-1 samples of
+ * each axis plus the samples of an incomplete group.
+ *
+ * Each output sample is aligned with the last input of its group of M:
+ * its seq_num and fluid_pressure are that input's, and its t is that
+ * input's minus the filter's group delay, so t stays the time the
+ * filtered value describes.  dt is the spacing of the outputs.  Before
+ * the first input the filter state holds copies of it, so a constant
+ * signal (gravity on acc) comes out constant from the start.
+ */
+
+
+#ifndef DECIMATE_H
+#define DECIMATE_H
+
+#include <stddef.h>
+#include <vector>
+#include <helper_funcs/helper_funcs.h>
+#include <helper_funcs/imu_batch.h>
+
+/**
+ * @brief Default filter taps per polyphase branch.
+ */
+#define DECIMATE_TAPS_PER_PHASE 16
+
+/**
+ * @brief Default stopband attenuation (units: dB).
+ */
+#define DECIMATE_ATTEN_DB 60.0
+
+/**
+ * @brief Most outputs computed per internal block.
+ */
+#define DECIMATE_BLOCK 256
+
+
+/**
+ * @brief Streaming FIR decimator over the ang, acc and mag axes.
+ */
+class Decimator
+{
+public:
+
+  /**
+   * @brief Constructor.  Designs the filter.
+   *
+   * @param hz Input sampling rate (units: Hz).
+   * @param rate Output rate (units: Hz).  The output rate is hz/M with M
+   *        the nearest integer to hz/rate, at least 1; M = 1 passes
+   *        samples through unfiltered.
+   * @param taps_per_phase Filter length over M.  Longer is sharper.
+   * @param atten_db Stopband attenuation (units: dB).
+   */
+  Decimator(double hz, double rate, int taps_per_phase = DECIMATE_TAPS_PER_PHASE,
+	    double atten_db = DECIMATE_ATTEN_DB);
+
+  /**
+   * @brief Constructor from config_params::hz and config_params::rate.
+   */
+  Decimator(const config_params& params, int taps_per_phase = DECIMATE_TAPS_PER_PHASE,
+	    double atten_db = DECIMATE_ATTEN_DB);
+
+  /**
+   * @brief Filter a block and append the decimated samples.
+   *
+   * @param in Input samples, continuing the previous block.
+   * @param out Batch the output samples are appended to.
+   * @return Number of samples appended.
+   */
+  size_t process(const ImuBatchView& in, ImuBatch& out);
+
+  /**
+   * @brief Forget the stream.  The next input primes the filter again.
+   */
+  void reset(void);
+
+  int factor(void) const { return M; }
+  int taps(void) const { return (int) h.size(); }
+
+  /**
+   * @brief Output rate, hz/M (units: Hz).
+   */
+  double output_rate(void) const { return hz/M; }
+
+  /**
+   * @brief Delay of the filter (units: seconds).
+   */
+  double group_delay(void) const { return 0.5*(h.size() - 1)/hz; }
+
+  /**
+   * @brief Filter coefficients, tap 0 first.
+   */
+  const std::vector<double>& coefficients(void) const { return h; }
+
+private:
+
+  void design(int taps_per_phase, double atten_db);
+  size_t process_block(const ImuBatchView& in, ImuBatch& out);
+
+  double hz;
+  int M;
+  int Q; // taps per phase
+  std::vector<double> h;
+
+  bool primed;
+  int pending; // inputs of the incomplete group, in hist after the taps-1 samples
+  double t_prev; // time of the last output
+
+  std::vector<double> hist[9]; // last taps-1 + pending samples of each axis
+  std::vector<double> work; // hist followed by the block
+  std::vector<double> phase; // the block split into its M phases
+
+};
+
+
+#endif
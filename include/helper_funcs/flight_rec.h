@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Crash-surviving flight recorder in a shared-memory ring.
+ *
+ * A FlightRecorder is a ring of bytes in a POSIX shared-memory segment
+ * (/dev/shm/<name>).  The pages belong to the kernel, not the process,
+ * so what was written survives a segfault or a kill -9, unlike data
+ * still in a stdio buffer.  log.cpp keeps one per log channel when
+ * log_set_flight_recorder() turns it on (log.h), holding the same bytes
+ * as the log file.
+ *
+ * Each record is a FlightRecFrame (position, length, wall clock time)
+ * and its bytes, padded to 8.  write() reserves the space with one
+ * fetch_add of the header's head, copies the bytes in, and stores the
+ * frame's magic last, so any number of threads can write at once and a
+ * record cut off by a crash has no magic and is skipped.  A record over
+ * a quarter of the ring keeps only its first quarter-ring of bytes.
+ *
+ * The ring holds the newest capacity bytes.  flight_rec_dump() scans it
+ * from the oldest end for frames whose position matches where they lie,
+ * so partly overwritten and stale frames are skipped, and writes the
+ * records' bytes in order, optionally only the last N seconds of them.
+ * flight_rec_recover() does that for a segment whose writer died
+ * without close(); close() marks the segment clean and removes it.
+ * open() refuses a segment another running process still writes, so a
+ * second run of the same program neither clobbers the first's ring nor
+ * has it removed under it.
+ * Dumping a segment that is still being written can tear its oldest
+ * records.
+ */
+
+
+#ifndef FLIGHT_REC_H
+#define FLIGHT_REC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <string>
+
+#if ATOMIC_LLONG_LOCK_FREE != 2
+#error "flight_rec.h needs lock-free 64-bit atomics to share them between processes"
+#endif
+
+/**
+ * @brief Magic at the start of a segment.
+ */
+#define FLIGHT_REC_MAGIC "FLTREC01"
+
+/**
+ * @brief Magic at the start of each record.
+ */
+#define FLIGHT_REC_FRAME_MAGIC 0x46524543u
+
+/**
+ * @brief Bytes before the ring: one page for the header.
+ */
+#define FLIGHT_REC_HEADER_SIZE 4096
+
+/**
+ * @brief Segment header state while a writer has it open.
+ */
+#define FLIGHT_REC_OPEN 1
+
+/**
+ * @brief Segment header state after close().
+ */
+#define FLIGHT_REC_CLOSED 2
+
+
+/**
+ * @brief Start of a segment.
+ */
+struct FlightRecHeader
+{
+
+  char magic[8]; /**< FLIGHT_REC_MAGIC, not NUL terminated. */
+  uint32_t header_size; /**< FLIGHT_REC_HEADER_SIZE. */
+  uint32_t state; /**< FLIGHT_REC_OPEN or FLIGHT_REC_CLOSED. */
+  uint64_t capacity; /**< Ring size (power of two). */
+  int32_t pid; /**< Writer. */
+  int32_t reserved;
+  std::atomic<uint64_t> head; /**< Bytes reserved since the start. */
+
+};
+
+/**
+ * @brief Start of a record in the ring, 8-byte aligned.
+ */
+struct FlightRecFrame
+{
+
+  uint32_t magic; /**< FLIGHT_REC_FRAME_MAGIC once the record is complete. */
+  uint32_t len; /**< Bytes of the record after the frame. */
+  uint64_t pos; /**< Position of the frame, counted from the start. */
+  int64_t time_ns; /**< CLOCK_REALTIME_COARSE when written (units: ns). */
+
+};
+
+
+/**
+ * @brief Writer of one shared-memory ring.
+ */
+class FlightRecorder
+{
+public:
+
+  FlightRecorder(void) : hdr(NULL), ring(NULL), mask(0), max_len(0) {}
+
+  /**
+   * @brief Destructor.  Calls close().
+   */
+  ~FlightRecorder(void);
+
+  /**
+   * @brief Create the segment, replacing one of the same name that is
+   *        closed, or whose writer is gone or is this process.
+   *
+   * @param name Segment name, "/name" with no other slash.
+   * @param capacity Ring size, rounded up to a power of two, at least 4096.
+   * @return 0, or -1 if the segment could not be created (errno EBUSY if
+   *         another running process has it open).
+   */
+  int open(const char* name, size_t capacity);
+
+  /**
+   * @brief Mark the segment clean and remove it.
+   */
+  void close(void);
+
+  bool is_open(void) const { return hdr != NULL; }
+
+  /**
+   * @brief Append one record made of the pieces in iov.  Any thread.
+   */
+  void write(const struct iovec* iov, int iovcnt);
+
+  void write(const void* data, size_t len)
+  {
+    struct iovec iov;
+    iov.iov_base = (void*) data;
+    iov.iov_len = len;
+    write(&iov, 1);
+  }
+
+private:
+
+  FlightRecHeader* hdr;
+  uint8_t* ring;
+  uint64_t mask;
+  size_t max_len;
+  std::string seg_name;
+
+  FlightRecorder(const FlightRecorder&);
+  FlightRecorder& operator=(const FlightRecorder&);
+
+};
+
+
+/**
+ * @brief Write the records of a segment to fp, oldest first.
+ *
+ * @param name Segment name.
+ * @param fp Output; the records' bytes, back to back.
+ * @param seconds Only records at most this long before the newest one,
+ *        or 0 for all.
+ * @return Number of records written, or -1 if there is no valid segment.
+ */
+extern int flight_rec_dump(const char* name, FILE* fp, double seconds);
+
+/**
+ * @brief Dump a segment left by a writer that died without close().
+ *
+ * Does nothing if there is no segment, it was closed, or its writer is
+ * still running.
+ * @param name Segment name.
+ * @param out_file File to write, as flight_rec_dump(); created only if
+ *        there is something to recover.
+ * @param seconds As flight_rec_dump().
+ * @return Number of records recovered, 0 if there was nothing to
+ *         recover, or -1 if out_file could not be written.
+ */
+extern int flight_rec_recover(const char* name, const char* out_file, double seconds);
+
+#endif
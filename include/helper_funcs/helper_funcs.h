@@ -14,13 +14,15 @@
 #include <stdio.h>
 #include <Eigen/Core>
 #include <unsupported/Eigen/MatrixFunctions>
+#include <helper_funcs/so3.h>
 
 
 
 /**
  * @brief Skew function.
  * 
- * Skew operator on \f${\rm I\!R}^3\f$.
+ * Skew operator on \f${\rm I\!R}^3\f$.  For hot loops prefer the
+ * inline so3::skew() and friends in so3.h.
  * @param w Input vector.
  */
 extern Eigen::Matrix3d skew(Eigen::Vector3d w);
@@ -168,10 +170,15 @@ struct config_params {
  *
  * @brief Load params from config_file.
  *
+ * Parsed by config_load() (config_parse.h); problems with the file are
+ * printed.  Params the file does not set are left 0 (hz, rate, baud) or
+ * NaN, except acc_hat and w_E_north, which get the sentinel -100; check
+ * the result with config_params_check() in config_watch.h.
+ *
  * @param Config file to parse.
  *
  */
-extern config_params load_params(char* config_file);
+extern config_params load_params(const char* config_file);
 
 /**
  *
@@ -180,7 +187,7 @@ extern config_params load_params(char* config_file);
  * @param Parameter struct.
  *
  */
-extern void print_loaded_params(config_params params);
+extern void print_loaded_params(const config_params& params);
 
   
 #endif
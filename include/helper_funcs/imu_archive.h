@@ -0,0 +1,226 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Memory-mapped columnar IMU archive.
+ *
+ * Native on-disk format for IMU streams, so that a run does not have to
+ * re-parse its text or binary logs.  Samples are stored in blocks of
+ * IMU_ARCHIVE_BLOCK samples, one column per ImuPacket field, followed by
+ * a block index holding each block's time range:
+ *
+ *   ImuArchiveHeader | block 0 | block 1 | ... | ImuArchiveBlock[num_blocks]
+ *
+ * Columns are either raw arrays, 64-byte aligned in the file so they can
+ * be used in place from the mapping, or compressed:
+ *
+ *   IMU_ARCHIVE_DELTA  t (as its IEEE bit pattern) and seq_num: first
+ *                      value, then deltas less their minimum, bit-packed
+ *                      at the width of the largest.
+ *   IMU_ARCHIVE_XOR    sensor axes, dt and fluid_pressure: each value
+ *                      XORed with the previous one and the meaningful
+ *                      bits stored with a leading/trailing zero count.
+ *
+ * Both are lossless.  A compressed column that would not be smaller is
+ * stored raw.  Opening an archive maps it and reads the header and
+ * index only; a time-range read decodes only the blocks that overlap
+ * the range.  Files are in host byte order (little endian).
+ */
+
+
+#ifndef IMU_ARCHIVE_H
+#define IMU_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <helper_funcs/imu_batch.h>
+#include <helper_funcs/binlog.h>
+
+/**
+ * @brief Default samples per block.
+ */
+#define IMU_ARCHIVE_BLOCK 4096
+
+/**
+ * @brief Columns: ang, acc, mag (x,y,z each), t, dt, seq_num, fluid_pressure.
+ */
+#define IMU_ARCHIVE_NUM_COLUMNS 13
+#define IMU_ARCHIVE_COL_T        9
+#define IMU_ARCHIVE_COL_DT      10
+#define IMU_ARCHIVE_COL_SEQ     11
+#define IMU_ARCHIVE_COL_PRESS   12
+
+/**
+ * @brief Column encodings.
+ */
+#define IMU_ARCHIVE_RAW   0
+#define IMU_ARCHIVE_DELTA 1
+#define IMU_ARCHIVE_XOR   2
+
+/**
+ * @brief Header flags.
+ */
+#define IMU_ARCHIVE_COMPRESSED 0x1  /* columns may be compressed */
+#define IMU_ARCHIVE_SORTED     0x2  /* block time ranges are in order */
+
+
+/**
+ * @brief File header.
+ */
+struct ImuArchiveHeader
+{
+
+  char magic[8]; /**< "IMUARCH1" */
+  uint32_t version;
+  uint32_t flags;
+  uint32_t block_size; /**< Samples per block (the last may hold fewer). */
+  uint32_t num_blocks;
+  uint64_t num_samples;
+  uint64_t index_offset; /**< File offset of the block index. */
+  double t_begin; /**< Smallest t. */
+  double t_end; /**< Largest t. */
+  uint64_t reserved;
+
+};
+
+/**
+ * @brief Block index entry.
+ */
+struct ImuArchiveBlock
+{
+
+  double t_min;
+  double t_max;
+  uint64_t first; /**< Index of the block's first sample. */
+  uint64_t offset; /**< File offset of the block. */
+  uint32_t num; /**< Samples in the block. */
+  uint32_t col_offset[IMU_ARCHIVE_NUM_COLUMNS]; /**< Column offsets from the block start. */
+  uint32_t col_bytes[IMU_ARCHIVE_NUM_COLUMNS]; /**< Column sizes. */
+  uint8_t col_encoding[IMU_ARCHIVE_NUM_COLUMNS];
+  uint8_t reserved[7];
+
+};
+
+
+/**
+ * @brief Streaming archive writer.
+ */
+class ImuArchiveWriter
+{
+public:
+
+  ImuArchiveWriter(void);
+  ~ImuArchiveWriter(void);
+
+  /**
+   * @brief Create an archive.
+   *
+   * @param filename Archive file.
+   * @param compress Compress the columns.
+   * @param block_size Samples per block.
+   * @return 0 on success, -1 on failure.
+   */
+  int open(const char* filename, bool compress = true, int block_size = IMU_ARCHIVE_BLOCK);
+
+  void append(const ImuPacket& pkt);
+  void append(const ImuBatch& batch);
+
+  /**
+   * @brief Write the last block, the index and the header.
+   * @return 0 on success, -1 on a write error.
+   */
+  int close(void);
+
+private:
+
+  void flush_block(void);
+
+  FILE* fp;
+  bool compress;
+  bool write_error;
+  ImuArchiveHeader header;
+  std::vector<ImuArchiveBlock> index;
+  ImuBatch block;
+
+  ImuArchiveWriter(const ImuArchiveWriter&);
+  ImuArchiveWriter& operator=(const ImuArchiveWriter&);
+
+};
+
+
+/**
+ * @brief Read-only archive.
+ */
+class ImuArchive
+{
+public:
+
+  ImuArchive(void) : header(NULL), blocks(NULL) {}
+
+  /**
+   * @brief Map an archive and check its header and index.
+   *
+   * Every block must have 1 to block_size samples and every column must
+   * lie inside the file; a raw column must hold exactly num values.
+   * @return 0 on success, -1 on failure.
+   */
+  int open(const char* filename);
+
+  void close(void);
+
+  size_t size(void) const { return header ? (size_t) header->num_samples : 0; }
+  int num_blocks(void) const { return header ? (int) header->num_blocks : 0; }
+  double t_begin(void) const { return header ? header->t_begin : 0.0; }
+  double t_end(void) const { return header ? header->t_end : 0.0; }
+  const ImuArchiveBlock& block(int b) const { return blocks[b]; }
+
+  /**
+   * @brief Column of a block in place in the mapping, or NULL if it is
+   *        compressed.  Columns 0-10 are double, seq_num int32_t,
+   *        fluid_pressure float.
+   */
+  const void* raw_column(int b, int col) const;
+
+  /**
+   * @brief Decode one block, appending to out.
+   */
+  void read_block(int b, ImuBatch& out) const;
+
+  /**
+   * @brief Append all samples with t0 <= t <= t1 to out.
+   * @return Number of samples appended.
+   */
+  long read(double t0, double t1, ImuBatch& out) const;
+
+  /**
+   * @brief Append every sample to out.
+   */
+  long read_all(ImuBatch& out) const;
+
+private:
+
+  MappedFile map;
+  const ImuArchiveHeader* header;
+  const ImuArchiveBlock* blocks;
+
+};
+
+
+/**
+ * @brief Convert KVH/MST text or binary logs to an archive.
+ *
+ * The logs are read with ingest_files(), so binary logs are recognized
+ * by their suffix.
+ *
+ * @param files Log files.
+ * @param archive Output archive.
+ * @param compress Compress the columns.
+ * @param hz Sampling rate for KVH binary logs.
+ * @return Number of samples written, or -1 on failure.
+ */
+extern long imu_archive_convert(const std::vector<std::string>& files, const char* archive,
+				bool compress = true, double hz = 0.0);
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Structure-of-arrays IMU sample store.
+ *
+ * ImuBatch keeps each field of ImuPacket in its own 64-byte aligned
+ * array (one per axis for ang, acc and mag), so window operations such as
+ * mean, variance and bias subtraction touch only the columns they need
+ * and compile to vectorized loops.
+ */
+
+
+#ifndef IMU_BATCH_H
+#define IMU_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Eigen/Core>
+#include <helper_funcs/helper_funcs.h>
+#include <helper_funcs/gyro_data.h>
+#include <helper_funcs/imu_sample.h>
+
+
+/**
+ * @brief Vector quantities of an IMU sample.
+ */
+enum ImuVec
+{
+  IMU_ANG = 0, /**< Angular velocity. */
+  IMU_ACC = 1, /**< Linear acceleration. */
+  IMU_MAG = 2  /**< Magnetometer. */
+};
+
+
+/**
+ * @brief Read-only view of a range of an ImuBatch.
+ *
+ * Holds pointers into the batch, no data is copied.  Valid until the
+ * batch is modified.
+ */
+struct ImuBatchView
+{
+
+  const double* axis[9]; /**< ang x,y,z, acc x,y,z, mag x,y,z columns. */
+  const double* t; /**< Timestamps. */
+  const double* dt; /**< Sample intervals. */
+  const int32_t* seq_num; /**< Sequence numbers. */
+  const float* fluid_pressure; /**< Fluid pressure. */
+  size_t size; /**< Number of samples. */
+
+  /**
+   * @brief One axis of a vector quantity as an Eigen array.
+   * @param v Vector quantity.
+   * @param k Axis, 0-2.
+   */
+  Eigen::Map<const Eigen::ArrayXd> column(ImuVec v, int k) const
+  {
+    return Eigen::Map<const Eigen::ArrayXd>(axis[3*v + k], size);
+  }
+
+  /**
+   * @brief Sub-range of this view.
+   * @param begin First sample.
+   * @param n Number of samples.
+   */
+  ImuBatchView sub(size_t begin, size_t n) const;
+
+};
+
+
+/**
+ * @brief Structure-of-arrays IMU sample store.
+ */
+class ImuBatch
+{
+public:
+
+  ImuBatch(void);
+  ImuBatch(const ImuBatch& other);
+  ImuBatch& operator=(const ImuBatch& other);
+  ~ImuBatch(void);
+
+  size_t size(void) const { return num; }
+  size_t capacity(void) const { return cap; }
+
+  /**
+   * @brief Make room for n samples without reallocating.
+   */
+  void reserve(size_t n);
+
+  /**
+   * @brief Set the number of samples.  New samples are uninitialized.
+   */
+  void resize(size_t n);
+
+  void clear(void) { num = 0; }
+
+  /**
+   * @brief Append one packet.  Storage grows geometrically.
+   */
+  void push_back(const ImuPacket& pkt);
+
+  /**
+   * @brief Append packets (AoS to SoA).
+   */
+  void append(const ImuPacket* pkts, size_t n);
+
+  /**
+   * @brief Append compact samples (AoS to SoA).
+   */
+  void append(const ImuSample* samples, size_t n);
+
+  /**
+   * @brief Append a GyroData sample.  timestamp and diff become t and dt.
+   */
+  void append(const GyroData& g);
+
+  /**
+   * @brief Gather one sample back into an ImuPacket.
+   */
+  ImuPacket packet(size_t i) const;
+
+  /**
+   * @brief Gather samples [begin, begin+n) into packets (SoA to AoS).
+   */
+  void to_packets(size_t begin, size_t n, ImuPacket* out) const;
+
+  /**
+   * @brief View of samples [begin, begin+n).
+   */
+  ImuBatchView view(size_t begin, size_t n) const;
+
+  /**
+   * @brief View of all samples.
+   */
+  ImuBatchView view(void) const { return view(0, num); }
+
+  double* axis(ImuVec v, int k) { return col_axis[3*v + k]; }
+  const double* axis(ImuVec v, int k) const { return col_axis[3*v + k]; }
+
+  double* t(void) { return col_t; }
+  const double* t(void) const { return col_t; }
+  double* dt(void) { return col_dt; }
+  const double* dt(void) const { return col_dt; }
+  int32_t* seq_num(void) { return col_seq_num; }
+  const int32_t* seq_num(void) const { return col_seq_num; }
+  float* fluid_pressure(void) { return col_fluid_pressure; }
+  const float* fluid_pressure(void) const { return col_fluid_pressure; }
+
+private:
+
+  void grow(size_t n);
+
+  size_t num;
+  size_t cap;
+
+  double* col_axis[9];
+  double* col_t;
+  double* col_dt;
+  int32_t* col_seq_num;
+  float* col_fluid_pressure;
+
+};
+
+
+/**
+ * @brief Per-axis mean of a vector quantity over a window.
+ *
+ * @param w Window.
+ * @param v Vector quantity.
+ */
+extern Eigen::Vector3d imu_batch_mean(const ImuBatchView& w, ImuVec v);
+
+/**
+ * @brief Per-axis variance of a vector quantity over a window.
+ *
+ * Two-pass, normalized by n-1.
+ * @param w Window.
+ * @param v Vector quantity.
+ * @param mean Optional output of the per-axis mean.
+ */
+extern Eigen::Vector3d imu_batch_variance(const ImuBatchView& w, ImuVec v, Eigen::Vector3d* mean = NULL);
+
+/**
+ * @brief Subtract a bias from a vector quantity over samples [begin, begin+n).
+ *
+ * @param batch Batch, modified in place.
+ * @param v Vector quantity.
+ * @param bias Bias to subtract.
+ * @param begin First sample.
+ * @param n Number of samples.
+ */
+extern void imu_batch_subtract_bias(ImuBatch& batch, ImuVec v, const Eigen::Vector3d& bias, size_t begin, size_t n);
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief IMU text log records.
+ *
+ * Reading and writing of ImuPacket records in the DSL text log format
+ * written by log_this_now_dsl_format():
+ *
+ *   RECORD_NAME YYYY/MM/DD HH:MM:SS.SSS t,seq_num,ang_x,ang_y,ang_z,acc_x,acc_y,acc_z,mag_x,mag_y,mag_z,fluid_pressure
+ *
+ * The payload fields may be separated by commas or whitespace, and
+ * fluid_pressure may be omitted.
+ */
+
+
+#ifndef IMU_LOG_H
+#define IMU_LOG_H
+
+#include <vector>
+#include <helper_funcs/helper_funcs.h>
+
+/**
+ * @brief Number of payload fields in an IMU record, including fluid_pressure.
+ */
+#define IMU_LOG_NUM_FIELDS 12
+
+/**
+ * @brief Maximum length of a formatted IMU record payload.
+ */
+#define IMU_LOG_MAX_PAYLOAD 512
+
+
+/**
+ * @brief Format the payload of an IMU record.
+ *
+ * The result is meant to be passed as record_data to
+ * log_this_now_dsl_format().
+ *
+ * @param str Output buffer of at least IMU_LOG_MAX_PAYLOAD bytes.
+ * @param pkt IMU packet.
+ * @return Number of characters written.
+ */
+extern int imu_log_sprintf_payload(char* str, const ImuPacket& pkt);
+
+/**
+ * @brief Parse the payload of an IMU record.
+ *
+ * @param str Payload, i.e. the record with name and timestamp removed.
+ * @param end One past the last character to parse, or NULL if str is
+ *        NUL terminated.
+ * @param pkt Output packet.  dt is not set.
+ * @return 0 on success, -1 if fewer than IMU_LOG_NUM_FIELDS-1 fields parse.
+ */
+extern int imu_log_parse_payload(const char* str, const char* end, ImuPacket& pkt);
+
+/**
+ * @brief Parse a full IMU record line.
+ *
+ * Skips the record name and the two DSL timestamp tokens, then parses
+ * the payload.
+ *
+ * @param line Record line.
+ * @param end One past the last character to parse, or NULL if line is
+ *        NUL terminated.
+ * @param pkt Output packet.  dt is not set.
+ * @return 0 on success, -1 on a malformed record.
+ */
+extern int imu_log_parse_record(const char* line, const char* end, ImuPacket& pkt);
+
+/**
+ * @brief Load all IMU records of a text log into memory.
+ *
+ * Lines that do not parse are skipped.  dt is set from consecutive t.
+ *
+ * @param filename Log file.
+ * @param pkts Output packets, appended to.
+ * @return Number of packets loaded, or -1 if the file could not be read.
+ */
+extern int imu_log_load(const char* filename, std::vector<ImuPacket>& pkts);
+
+#endif
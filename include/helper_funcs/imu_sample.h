@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Compact IMU sample.
+ *
+ * Plain-old-data IMU sample holding the fields of both GyroData and
+ * ImuPacket.  It is trivially copyable, two cache lines long and
+ * cache-line aligned, so it can be memcpy'd, placed in shared memory and
+ * stored in arrays and ring buffers without any per-sample allocation.
+ *
+ * Before C++17, operator new and std::allocator do not honour the 64-byte
+ * alignment, and the compiler may still assume it (e.g. AVX aligned
+ * moves of the vectors), so a misaligned sample can fault.  Heap arrays
+ * of samples must come from CacheLineAllocator, e.g. ImuSampleVector.
+ */
+
+
+#ifndef IMU_SAMPLE_H
+#define IMU_SAMPLE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <Eigen/Core>
+#include <helper_funcs/gyro_data.h>
+#include <helper_funcs/helper_funcs.h>
+
+/**
+ * @brief Number of status bits an ImuSample can hold.
+ */
+#define IMU_SAMPLE_MAX_STATUS 16
+
+
+/**
+ * @brief Compact IMU sample.
+ */
+struct alignas(64) ImuSample
+{
+
+  double ang[3]; /**< Angular velocity. */
+  double acc[3]; /**< Linear acceleration. */
+  double mag[3]; /**< Magnetometer. */
+
+  double timestamp; /**< Timestamp (GyroData::timestamp, ImuPacket::t). */
+  double comp_timestamp; /**< Computer timestamp. */
+  double diff; /**< Time difference between last two samples (GyroData::diff, ImuPacket::dt). */
+  double t_start; /**< Start time. */
+  double hz; /**< Sampling rate. */
+
+  float temp; /**< Sensor temperature. */
+  float fluid_pressure; /**< Fluid pressure. */
+
+  uint32_t seq_num; /**< Sequence number. */
+
+  uint16_t status; /**< Sensor status bits, bit i is GyroData::status[i]. */
+  uint8_t num_status; /**< Number of valid status bits. */
+  uint8_t reserved; /**< Padding, zero. */
+
+  Eigen::Map<Eigen::Vector3d> ang_vec(void) { return Eigen::Map<Eigen::Vector3d>(ang); }
+  Eigen::Map<const Eigen::Vector3d> ang_vec(void) const { return Eigen::Map<const Eigen::Vector3d>(ang); }
+  Eigen::Map<Eigen::Vector3d> acc_vec(void) { return Eigen::Map<Eigen::Vector3d>(acc); }
+  Eigen::Map<const Eigen::Vector3d> acc_vec(void) const { return Eigen::Map<const Eigen::Vector3d>(acc); }
+  Eigen::Map<Eigen::Vector3d> mag_vec(void) { return Eigen::Map<Eigen::Vector3d>(mag); }
+  Eigen::Map<const Eigen::Vector3d> mag_vec(void) const { return Eigen::Map<const Eigen::Vector3d>(mag); }
+
+  bool status_bit(int i) const { return (status >> i) & 1; }
+
+};
+
+static_assert(sizeof(ImuSample) == 128, "ImuSample must be two cache lines");
+static_assert(std::is_trivially_copyable<ImuSample>::value, "ImuSample must be trivially copyable");
+
+
+/**
+ * @brief Allocator of cache-line aligned storage, for containers of
+ *        over-aligned types such as ImuSample.
+ */
+template<typename T>
+struct CacheLineAllocator
+{
+
+  typedef T value_type;
+
+  CacheLineAllocator(void) {}
+  template<typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+  T* allocate(size_t n)
+  {
+    void* p = NULL;
+    if(posix_memalign(&p, 64, n*sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return (T*) p;
+  }
+
+  void deallocate(T* p, size_t) { free(p); }
+
+  template<typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+  template<typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+
+};
+
+/**
+ * @brief Vector of samples, each on its own pair of cache lines.
+ */
+typedef std::vector<ImuSample, CacheLineAllocator<ImuSample> > ImuSampleVector;
+
+
+/**
+ * @brief Sample with the defaults of the GyroData constructor.
+ *
+ * @param hz Sampling rate.
+ */
+extern ImuSample imu_sample_init(int hz);
+
+/**
+ * @brief Convert from GyroData.
+ *
+ * Lossless as long as status has at most IMU_SAMPLE_MAX_STATUS entries.
+ * @param g Gyro data.
+ */
+extern ImuSample imu_sample_from_gyro(const GyroData& g);
+
+/**
+ * @brief Convert to GyroData.
+ *
+ * @param s Sample.
+ * @param g Gyro data to fill in.
+ */
+extern void imu_sample_to_gyro(const ImuSample& s, GyroData& g);
+
+/**
+ * @brief Convert from ImuPacket.
+ *
+ * Fields that ImuPacket does not carry are zeroed.
+ * @param p IMU packet.
+ */
+extern ImuSample imu_sample_from_packet(const ImuPacket& p);
+
+/**
+ * @brief Convert to ImuPacket.
+ *
+ * @param s Sample.
+ */
+extern ImuPacket imu_sample_to_packet(const ImuSample& s);
+
+#endif
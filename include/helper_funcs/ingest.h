@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Parallel ingest of hourly IMU log files.
+ *
+ * Reads the files written by log_open_log_file() (YYYY_MM_DD_HH_MM.SUFFIX)
+ * back into one ImuBatch.  Each file is memory mapped and split into
+ * chunks at record boundaries: the next newline for text logs
+ * (imu_log.h), the next valid frame for binary logs (binlog.h).  The
+ * chunks are parsed on a WorkStealingPool and stitched back together in
+ * timestamp order.
+ *
+ * Text logs and the timed binary formats keep the time in each record;
+ * dt is recomputed from consecutive t after stitching, with dt = 0 for
+ * the first sample as in imu_log_load().  KVH frames carry no time, so
+ * KVH samples are numbered across the whole ingest at hz.  MIP frames
+ * carry no sequence number and may carry no GPS time: their samples are
+ * numbered across the whole ingest, and samples before a chunk's first
+ * GPS time follow on from the chunk before at its last dt, as if one
+ * BinlogParser had read the files back to back.
+ */
+
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <helper_funcs/imu_batch.h>
+
+/**
+ * @brief Default chunk size (units: bytes).
+ */
+#define INGEST_CHUNK_BYTES (8 << 20)
+
+
+/**
+ * @brief Ingest statistics.
+ */
+struct IngestStats
+{
+
+  int files; /**< Files read. */
+  int chunks; /**< Chunks parsed. */
+  uint64_t bytes; /**< Bytes read. */
+  uint64_t records; /**< Samples decoded. */
+  uint64_t bad_records; /**< Text lines that did not parse, or binary frames with a bad checksum. */
+  bool reordered; /**< True if stitching needed a full sort by t. */
+  double elapsed; /**< Wall time (units: seconds). */
+
+};
+
+
+/**
+ * @brief List the log files in a directory.
+ *
+ * @param dir Directory.
+ * @param suffix Log suffix without the dot (e.g. "KVH", "BKVH").
+ * @param files Output, full paths sorted by name, i.e. by opening time.
+ * @return Number of files, or -1 if the directory could not be read.
+ */
+extern int ingest_list_dir(const char* dir, const char* suffix, std::vector<std::string>& files);
+
+/**
+ * @brief Parse log files in parallel.
+ *
+ * All files must be of the same kind.  Binary logs are recognized by
+ * their suffix (binlog_format_from_filename()); anything else is read as
+ * a text IMU log.
+ *
+ * @param files Log files.
+ * @param out Decoded samples are appended here.
+ * @param stats Optional output statistics.
+ * @param hz Sampling rate for KVH binary logs.
+ * @param num_threads Number of worker threads, or 0 for one per core.
+ * @param chunk_bytes Nominal chunk size.
+ * @return Number of samples decoded, or -1 if a file could not be read.
+ */
+extern long ingest_files(const std::vector<std::string>& files, ImuBatch& out,
+			 IngestStats* stats = NULL, double hz = 0.0,
+			 int num_threads = 0, size_t chunk_bytes = INGEST_CHUNK_BYTES);
+
+/**
+ * @brief Parse all log files with one suffix in a directory.
+ *
+ * @see ingest_list_dir(), ingest_files().
+ */
+extern long ingest_dir(const char* dir, const char* suffix, ImuBatch& out,
+		       IngestStats* stats = NULL, double hz = 0.0,
+		       int num_threads = 0, size_t chunk_bytes = INGEST_CHUNK_BYTES);
+
+#endif
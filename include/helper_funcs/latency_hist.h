@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief HDR-style latency histogram, recorded lock-free.
+ *
+ * Values are nanoseconds in log-linear buckets, as in an HdrHistogram:
+ * below 2^LATENCY_HIST_SUB_BITS each value has its own bucket, and every
+ * power of two above that is split into 2^LATENCY_HIST_SUB_BITS equal
+ * buckets, so a bucket is never wider than 1/16 of its values and a
+ * percentile read from the buckets is within 6.25% of the true one.
+ * Values from 0 to about 68 s are kept apart; longer ones share the last
+ * bucket (the maximum is still exact).
+ *
+ * record() is a few instructions and a relaxed fetch_add, safe from any
+ * number of threads at once.  snapshot_and_reset() swaps every bucket
+ * to zero into a LatencySnapshot, so a value recorded during the swap
+ * lands in this snapshot or the next, never in neither.  Snapshots are
+ * plain data for percentiles and can be added up for longer windows.
+ *
+ * log.cpp keeps one per log channel for record writes, file rotation and
+ * queue wait, see log.h.
+ */
+
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Buckets per power of two are 2^LATENCY_HIST_SUB_BITS.
+ */
+#define LATENCY_HIST_SUB_BITS 4
+
+/**
+ * @brief Values with their highest set bit above this share the last bucket.
+ */
+#define LATENCY_HIST_MAX_BITS 36
+
+/**
+ * @brief Number of buckets.
+ */
+#define LATENCY_HIST_BUCKETS ((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS)
+
+
+/**
+ * @brief Bucket of a value (units: ns).  Negative values go in bucket 0.
+ */
+inline int latency_hist_bucket(long long ns)
+{
+  if(ns < (1LL << LATENCY_HIST_SUB_BITS))
+    return ns < 0 ? 0 : (int) ns;
+
+  const int msb = 63 - __builtin_clzll((unsigned long long) ns);
+  if(msb >= LATENCY_HIST_MAX_BITS)
+    return LATENCY_HIST_BUCKETS - 1;
+
+  const int shift = msb - LATENCY_HIST_SUB_BITS;
+  return ((shift + 1) << LATENCY_HIST_SUB_BITS) + (int) ((ns >> shift) & ((1 << LATENCY_HIST_SUB_BITS) - 1));
+}
+
+/**
+ * @brief Smallest value in a bucket (units: ns).
+ */
+extern long long latency_hist_bucket_low(int bucket);
+
+/**
+ * @brief Largest value in a bucket (units: ns).
+ */
+extern long long latency_hist_bucket_high(int bucket);
+
+
+/**
+ * @brief Counts of a LatencyHistogram over one interval.
+ */
+struct LatencySnapshot
+{
+
+  uint64_t counts[LATENCY_HIST_BUCKETS];
+  uint64_t count; /**< Values recorded. */
+  long long sum_ns; /**< Sum of the values. */
+  long long max_ns; /**< Largest value, or 0 if none. */
+
+  LatencySnapshot(void) { clear(); }
+
+  void clear(void);
+
+  /**
+   * @brief Add another interval's counts to this one.
+   */
+  void add(const LatencySnapshot& other);
+
+  /**
+   * @brief Value that p of the values are at or below (units: ns).
+   *
+   * The highest value of the bucket it falls in, but never above the
+   * maximum, so percentile(1.0) is the maximum.
+   * @param p Fraction, 0 to 1 (0.99 for p99).
+   * @return The value, or 0 if nothing was recorded.
+   */
+  long long percentile(double p) const;
+
+  /**
+   * @brief Mean value (units: ns), or 0 if nothing was recorded.
+   */
+  double mean(void) const { return count ? (double) sum_ns/count : 0.0; }
+
+};
+
+
+/**
+ * @brief Latency histogram for any number of recording threads.
+ */
+class LatencyHistogram
+{
+public:
+
+  LatencyHistogram(void);
+
+  /**
+   * @brief Record one value (units: ns).  Any thread, no lock.
+   */
+  void record(long long ns)
+  {
+    counts[latency_hist_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+
+    long long m = max.load(std::memory_order_relaxed);
+    while(ns > m && !max.compare_exchange_weak(m, ns, std::memory_order_relaxed))
+      ;
+  }
+
+  /**
+   * @brief Move the counts since the last call into snap and start over.
+   */
+  void snapshot_and_reset(LatencySnapshot& snap);
+
+private:
+
+  std::atomic<uint64_t> counts[LATENCY_HIST_BUCKETS];
+  std::atomic<long long> sum;
+  std::atomic<long long> max;
+
+  LatencyHistogram(const LatencyHistogram&);
+  LatencyHistogram& operator=(const LatencyHistogram&);
+
+};
+
+#endif
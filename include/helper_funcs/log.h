@@ -12,6 +12,10 @@
                          hourly file closing
 
    01-01-08     LLW      Added PUJA data log file
+   2026-10-19   AGT      Added optional sidecar time index per log file
+   2026-10-19   AGT      Added trace channel, see trace.h
+   2026-10-19   AGT      Added latency histograms and the latency channel
+   2026-10-19   AGT      Added the flight recorder, see flight_rec.h
 
 ---------------------------------------------------------------------- */
 #ifndef LOGGING_PROCESS_INC
@@ -35,7 +39,72 @@ extern int    log_get_log_status(int log_fid);
 extern int    log_bytes_per_sec(void);
 extern void   log_one_hertz_update(void);
 
-#define LOG_MAX_NUM_LOG_FILES        7
+#define LOG_MAX_NUM_LOG_FILES        9
+
+// ----------------------------------------------------------------------
+// 2026-10-19 sidecar time index
+//   When enabled with log_set_index_interval(), every log file opened
+//   gets a sidecar "<log file>.idx" holding a log_index_header_t and
+//   then one log_index_entry_t for the first dsl format record and for
+//   every every_records records or every_ms milliseconds thereafter.
+//   See log_index.h for the reader.
+// ----------------------------------------------------------------------
+#define LOG_INDEX_SUFFIX  "idx"
+#define LOG_INDEX_MAGIC   "LOGIDX01"
+#define LOG_INDEX_VERSION 1
+
+typedef struct {
+  char               magic[8];   /* LOG_INDEX_MAGIC, not NUL terminated */
+  unsigned int       version;
+  unsigned int       reserved;
+} log_index_header_t;
+
+typedef struct {
+  long long          time_ns;    /* dsl time of the record, ns since 1970 GMT */
+  unsigned long long offset;     /* byte offset of the record in the log file */
+} log_index_entry_t;
+
+extern void   log_set_index_interval(int log_fid, int every_records, int every_ms);
+extern void   log_set_log_dir(int log_fid, char * dir);
+
+// ----------------------------------------------------------------------
+// 2026-10-19 latency histograms
+//   Every channel has a LatencyHistogram (latency_hist.h) for each of
+//     LOG_LATENCY_WRITE   a log_this_now*() call, rotation included
+//     LOG_LATENCY_ROTATE  closing a file and opening the next
+//     LOG_LATENCY_QUEUE   time a record waited before it was written,
+//                         reported by the producer that queued it with
+//                         log_record_queue_wait()
+//   recorded lock-free from any thread.  log_one_hertz_update() moves
+//   them into the last second's snapshot, which the queries below read,
+//   and with log_set_latency_log(1) also writes one "LAT" record per
+//   channel that had any to LOG_FID_LATENCY_FORMAT.
+// ----------------------------------------------------------------------
+#define LOG_LATENCY_WRITE   0
+#define LOG_LATENCY_ROTATE  1
+#define LOG_LATENCY_QUEUE   2
+#define LOG_LATENCY_NUM     3
+
+struct LatencySnapshot;
+
+extern void      log_record_queue_wait(int log_fid, long long wait_ns);
+extern long long log_latency_percentile(int log_fid, int which, double p);
+extern long long log_latency_count(int log_fid, int which);
+extern int       log_latency_snapshot(int log_fid, int which, LatencySnapshot * snap);
+extern void      log_set_latency_log(int enable);
+
+// ----------------------------------------------------------------------
+// 2026-10-19 flight recorder
+//   log_set_flight_recorder() gives a channel a ring of the given size
+//   in /dev/shm (flight_rec.h) that gets every record the log file
+//   does, at the cost of a copy, and survives a crash that loses what
+//   is still in the log file's stdio buffer.  A normal exit removes it;
+//   the next start of the same program recovers the one a crash left
+//   to a _crash file in the channel's log dir.  While one run has it
+//   open, a second run of the program gets no flight recorder.
+// ----------------------------------------------------------------------
+extern int    log_set_flight_recorder(int log_fid, long long bytes, double recover_seconds);
+extern void   log_flight_name(int log_fid, char * name, int len);
 
 #define LOG_FID_KVH_FORMAT           0
 #define LOG_FID_MST_FORMAT           1
@@ -44,6 +113,8 @@ extern void   log_one_hertz_update(void);
 #define LOG_FID_KVH_BINARY_FORMAT    4
 #define LOG_FID_MST_FILT_FORMAT      5
 #define LOG_FID_PHINS_BINARY_FORMAT  6
+#define LOG_FID_TRACE_FORMAT         7  /* Chrome trace JSON, see trace.h */
+#define LOG_FID_LATENCY_FORMAT       8  /* latency snapshots, one per second */
 
 
 #define LOG_FID_KVH_SUFFIX          "KVH"
@@ -53,6 +124,8 @@ extern void   log_one_hertz_update(void);
 #define LOG_FID_PHINS_SUFFIX        "INS"
 #define LOG_FID_MST_FILT_SUFFIX     "MSF"
 #define LOG_FID_PHINS_BINARY_SUFFIX "BINS"
+#define LOG_FID_TRACE_SUFFIX        "TRACE"
+#define LOG_FID_LATENCY_SUFFIX      "LAT"
 
 //extra junk
 #define LOG_FID_RDI_BINARY_FORMAT    5
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Seeking inside DSL text log files with a sidecar time index.
+ *
+ * log_set_index_interval() makes the logger write, next to each log
+ * file it opens, "<log file>.idx": a log_index_header_t followed by
+ * log_index_entry_t (time, byte offset) pairs in file order (log.h).  An
+ * entry is written for the first record of the file and then every N
+ * records or N milliseconds.
+ *
+ * LogIndex maps a sidecar and binary-searches it, so finding a time in
+ * an hourly file costs O(log n) plus reading forward from the nearest
+ * indexed record to the first record at or after the time.  A trailing
+ * partial entry (e.g. after a crash) is ignored.  log_index_build()
+ * writes the same index for an existing log, and log_index_build_dir()
+ * backfills a whole directory in parallel.
+ *
+ * Times are DSL timestamps in nanoseconds since 1970, as returned by
+ * log_merge_parse_time().  The search assumes timestamps do not go
+ * backwards within a file.
+ */
+
+
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <helper_funcs/log.h>
+#include <helper_funcs/binlog.h>
+
+
+/**
+ * @brief Sidecar file name of a log file.
+ */
+extern std::string log_index_filename(const char* log_filename);
+
+
+/**
+ * @brief Read-only sidecar time index.
+ */
+class LogIndex
+{
+public:
+
+  LogIndex(void) : entries(NULL), num(0) {}
+
+  /**
+   * @brief Map the sidecar of a log file and check its header.
+   * @return 0 on success, -1 if there is no valid sidecar.
+   */
+  int open(const char* log_filename);
+
+  void close(void);
+
+  size_t size(void) const { return num; }
+  const log_index_entry_t& entry(size_t i) const { return entries[i]; }
+
+  /**
+   * @brief Byte offset of the last indexed record with time <= t_ns, or
+   *        0 if there is none.
+   */
+  uint64_t offset_before(int64_t t_ns) const;
+
+private:
+
+  MappedFile map;
+  const log_index_entry_t* entries;
+  size_t num;
+
+  LogIndex(const LogIndex&);
+  LogIndex& operator=(const LogIndex&);
+
+};
+
+
+/**
+ * @brief Find the first record at or after a time.
+ *
+ * Uses the sidecar if there is one, otherwise scans from the start of
+ * the file.
+ *
+ * @param log_filename Text log file.
+ * @param t_ns Time (units: nanoseconds since 1970).
+ * @return Byte offset of the first record with time >= t_ns, the file
+ *         size if there is none, or -1 if the log could not be read.
+ */
+extern long log_index_find(const char* log_filename, int64_t t_ns);
+
+/**
+ * @brief Open a log file positioned at the first record at or after a time.
+ * @return Open file, or NULL on failure.
+ */
+extern FILE* log_index_open_at(const char* log_filename, int64_t t_ns);
+
+/**
+ * @brief Write the sidecar of an existing log file.
+ *
+ * Produces the entries the logger would have written with the same
+ * intervals.  The sidecar is written to a temporary file and renamed.
+ *
+ * @return Number of entries, or -1 on failure.
+ */
+extern long log_index_build(const char* log_filename, int every_records, int every_ms);
+
+/**
+ * @brief Write the sidecars of all log files with one suffix in a directory.
+ *
+ * @param num_threads Number of worker threads, or 0 for one per core.
+ * @return Number of files indexed, or -1 if the directory could not be
+ *         read or a file failed.
+ */
+extern int log_index_build_dir(const char* dir, const char* suffix,
+			       int every_records, int every_ms, int num_threads = 0);
+
+#endif
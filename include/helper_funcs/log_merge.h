@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Time-ordered merge of DSL text log channels.
+ *
+ * Each channel (e.g. /log/kvh, /log/microstrain, /log/phins) is a set of
+ * hourly files of records
+ *
+ *   RECORD_NAME YYYY/MM/DD HH:MM:SS.fraction data
+ *
+ * as written by log_this_now_dsl_format().  LogMerge streams all
+ * channels as one sequence ordered by the DSL timestamp.  Only the
+ * timestamp prefix of each line is parsed; the line itself is handed
+ * out in place from the memory-mapped file.
+ *
+ * Files are opened lazily: a file joins the merge heap only once the
+ * merge reaches its first timestamp, and is unmapped when exhausted, so
+ * only files that overlap in time are open at once.  This also handles
+ * hourly files of one channel that overlap each other.  Each open file
+ * prefetches a window ahead of its read position.
+ *
+ * Records with equal timestamps come out in channel order, then file
+ * order.  Lines without a valid timestamp are skipped and counted.
+ */
+
+
+#ifndef LOG_MERGE_H
+#define LOG_MERGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Returned by log_merge_parse_time() for a malformed timestamp.
+ */
+#define LOG_MERGE_BAD_TIME INT64_MIN
+
+/**
+ * @brief Default read-ahead per open file (units: bytes).
+ */
+#define LOG_MERGE_PREFETCH (4 << 20)
+
+
+/**
+ * @brief Parse the DSL timestamp of a record line.
+ *
+ * @param line Record line, starting with the record name.
+ * @param end One past the end of the line.
+ * @return Time since 1970-01-01 00:00:00 (units: nanoseconds), or
+ *         LOG_MERGE_BAD_TIME.
+ */
+extern int64_t log_merge_parse_time(const char* line, const char* end);
+
+
+/**
+ * @brief One merged record.
+ */
+struct LogMergeRecord
+{
+
+  const char* line; /**< Start of the line, not NUL terminated. */
+  size_t len; /**< Length of the line without the newline. */
+  int64_t time_ns; /**< DSL timestamp (units: nanoseconds since 1970). */
+  int channel; /**< Channel the record came from. */
+
+};
+
+
+/**
+ * @brief Merge statistics.
+ */
+struct LogMergeStats
+{
+
+  uint64_t records; /**< Records emitted. */
+  uint64_t bad_lines; /**< Lines skipped for lack of a valid timestamp. */
+  int files_opened; /**< Files mapped so far. */
+  int max_open; /**< Most files open at once. */
+
+};
+
+
+struct LogMergeCursor;
+
+/**
+ * @brief Streaming k-way merge of log channels.
+ */
+class LogMerge
+{
+public:
+
+  /**
+   * @brief Constructor.
+   * @param prefetch_bytes Read-ahead per open file.
+   */
+  LogMerge(size_t prefetch_bytes = LOG_MERGE_PREFETCH);
+  ~LogMerge(void);
+
+  /**
+   * @brief Add a channel from a list of files.
+   * @return Channel number, or -1 if a file could not be read.
+   */
+  int add_channel(const std::vector<std::string>& files);
+
+  /**
+   * @brief Add a channel from all files with one suffix in a directory.
+   * @return Channel number, or -1 if the directory could not be read.
+   */
+  int add_channel(const char* dir, const char* suffix);
+
+  /**
+   * @brief Next record in time order.
+   *
+   * rec.line stays valid until the next call.
+   * @return false when all channels are exhausted.
+   */
+  bool next(LogMergeRecord& rec);
+
+  const LogMergeStats& stats(void) const { return st; }
+
+private:
+
+  void activate(void);
+  void heap_push(LogMergeCursor* c);
+  LogMergeCursor* heap_pop(void);
+
+  size_t prefetch;
+  int num_channels;
+  int file_seq;
+
+  std::vector<LogMergeCursor*> pending; // not yet opened, by first time
+  size_t next_pending;
+  std::vector<LogMergeCursor*> heap; // open, min-heap on current time
+  LogMergeCursor* current; // cursor of the last record handed out
+
+  LogMergeStats st;
+
+  LogMerge(const LogMerge&);
+  LogMerge& operator=(const LogMerge&);
+
+};
+
+
+/**
+ * @brief Write all remaining merged records to a file, one per line.
+ * @return Number of records written.
+ */
+extern long log_merge_write(LogMerge& merge, FILE* fp);
+
+#endif
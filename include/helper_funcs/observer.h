@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Attitude observer step kernel.
+ *
+ * A reusable, allocation-free update of the attitude and sensor-bias
+ * observer, driven by the gains in config_params.
+ */
+
+
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include <Eigen/Core>
+#include <helper_funcs/helper_funcs.h>
+
+
+/**
+ * @brief Observer gains.
+ *
+ * The k_* gains loaded by load_params() are diagonal (stringToDiag()), so
+ * only their diagonals are kept and every gain product is an elementwise
+ * product instead of a 3x3 matrix product.
+ */
+struct ObserverGains
+{
+
+  Eigen::Vector3d k_acc; /**< Diagonal of K_acc. */
+  Eigen::Vector3d k_mag; /**< Diagonal of K_mag. */
+  Eigen::Vector3d k_ang_bias; /**< Diagonal of K_ang_bias. */
+  Eigen::Vector3d k_acc_bias; /**< Diagonal of K_acc_bias. */
+  Eigen::Vector3d k_mag_bias; /**< Diagonal of K_mag_bias. */
+  Eigen::Vector3d k_E_n; /**< Diagonal of K_E_n. */
+  Eigen::Vector3d k_g; /**< Diagonal of K_g. */
+  Eigen::Vector3d k_north; /**< Diagonal of K_north. */
+
+  Eigen::Matrix3d R_align; /**< Instrument to vehicle alignment. */
+
+  double dt; /**< Default step, 1/hz, used when ImuPacket::dt is not set. */
+
+};
+
+
+/**
+ * @brief Observer state.
+ */
+struct ObserverState
+{
+
+  Eigen::Matrix3d R; /**< Instrument to NED rotation. */
+
+  Eigen::Vector3d acc_hat; /**< Estimated linear acceleration (instrument frame). */
+  Eigen::Vector3d mag_hat; /**< Estimated magnetic field (instrument frame). */
+
+  Eigen::Vector3d ang_bias; /**< Angular-rate bias. */
+  Eigen::Vector3d acc_bias; /**< Linear-acceleration bias. */
+  Eigen::Vector3d mag_bias; /**< Magnetometer bias. */
+
+  Eigen::Vector3d w_E_n; /**< Estimated Earth rate (NED frame). */
+
+  double t; /**< Time of the last update. */
+
+};
+
+
+/**
+ * @brief Extract observer gains from loaded parameters.
+ *
+ * @param params Parameter struct.
+ */
+extern ObserverGains observer_gains(const config_params& params);
+
+/**
+ * @brief Initialize the observer state from loaded parameters.
+ *
+ * R starts at R0 and the biases at their configured values.  acc_hat
+ * and w_E_n start at the optional acc_hat and w_E_north parameters, or at
+ * the first packet and the Earth rate at params.lat when those were not
+ * given.
+ *
+ * @param params Parameter struct.
+ * @param pkt First IMU packet.
+ * @param x State to initialize.
+ */
+extern void observer_init(const config_params& params, const ImuPacket& pkt, ObserverState& x);
+
+/**
+ * @brief One observer update.
+ *
+ * With w = ang - ang_bias, e_a = acc_hat - (acc - acc_bias) and
+ * e_m = mag_hat - (mag - mag_bias):
+ *
+ *   acc_hat'  = -w x acc_hat - k_acc e_a
+ *   mag_hat'  = -w x mag_hat - k_mag e_m
+ *   ang_bias' =  k_ang_bias (e_a x acc_hat)
+ *   acc_bias' = -k_acc_bias e_a
+ *   mag_bias' = -k_mag_bias e_m
+ *
+ * The attitude is corrected toward gravity (acc_hat against down) and
+ * toward north (the horizontal part of R*mag_hat against north):
+ *
+ *   w_c   = k_g (a x R'(-e_3)) + k_north R'(h x e_1)
+ *   R'    = R skew(w + w_c) - skew(w_E_n) R
+ *   w_E_n' = -k_E_n (R w_c)
+ *
+ * with a and h the unit acc_hat and horizontal field directions.  The
+ * step is explicit Euler on the vectors and the exact exponential on R.
+ * Nothing is allocated; x and x_next may alias.
+ *
+ * @param k Observer gains.
+ * @param pkt IMU packet.
+ * @param x Current state.
+ * @param x_next Next state.
+ */
+extern void observer_step(const ObserverGains& k, const ImuPacket& pkt, const ObserverState& x, ObserverState& x_next);
+
+/**
+ * @brief Run observer_step() over a batch of packets in place.
+ *
+ * @param k Observer gains.
+ * @param pkts IMU packets.
+ * @param n Number of packets.
+ * @param x State, updated in place.
+ */
+extern void observer_run(const ObserverGains& k, const ImuPacket* pkts, int n, ObserverState& x);
+
+/**
+ * @brief Vehicle to NED rotation of an observer state.
+ *
+ * @param k Observer gains.
+ * @param x Observer state.
+ */
+extern Eigen::Matrix3d observer_vehicle_attitude(const ObserverGains& k, const ObserverState& x);
+
+#endif
@@ -0,0 +1,274 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Quaternion attitude helpers.
+ *
+ * Quaternion counterparts of the rotation-matrix helpers: roll/pitch/yaw
+ * and rotation-matrix conversions, the exponential map for Earth-rate and
+ * gyro increments, normalized multiplication and batch SLERP.  All
+ * quaternions are unit quaternions in Eigen's (w,x,y,z) convention and
+ * follow the same Rz(yaw)*Ry(pitch)*Rx(roll) convention as rpy2rot().
+ *
+ * MatrixAttitude and QuaternionAttitude share one interface so that a
+ * propagation loop written as a template on the attitude type can switch
+ * between 3x3 and quaternion storage by changing one typedef.
+ */
+
+
+#ifndef QUAT_H
+#define QUAT_H
+
+#include <math.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <helper_funcs/so3.h>
+
+
+namespace so3
+{
+
+/**
+ * @brief Roll, pitch, yaw euler angles to quaternion.
+ * @param rpy Roll, pitch, yaw vector (units: radians).
+ */
+template<typename Derived>
+inline Eigen::Quaternion<typename Derived::Scalar> rpy2quat(const Eigen::MatrixBase<Derived>& rpy)
+{
+
+  EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived,3);
+
+  typedef typename Derived::Scalar Scalar;
+
+  const Scalar cr = cos(Scalar(0.5)*rpy(0));
+  const Scalar sr = sin(Scalar(0.5)*rpy(0));
+  const Scalar cp = cos(Scalar(0.5)*rpy(1));
+  const Scalar sp = sin(Scalar(0.5)*rpy(1));
+  const Scalar cy = cos(Scalar(0.5)*rpy(2));
+  const Scalar sy = sin(Scalar(0.5)*rpy(2));
+
+  return Eigen::Quaternion<Scalar>(cr*cp*cy + sr*sp*sy,
+				   sr*cp*cy - cr*sp*sy,
+				   cr*sp*cy + sr*cp*sy,
+				   cr*cp*sy - sr*sp*cy);
+
+}
+
+/**
+ * @brief Quaternion to roll, pitch, heading euler angles.
+ * @param q Input unit quaternion.
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,1> quat2rph(const Eigen::Quaternion<Scalar>& q)
+{
+
+  const Scalar w = q.w();
+  const Scalar x = q.x();
+  const Scalar y = q.y();
+  const Scalar z = q.z();
+
+  Scalar sp = Scalar(2)*(w*y - z*x);
+  if(sp > Scalar(1))
+    sp = Scalar(1);
+  if(sp < Scalar(-1))
+    sp = Scalar(-1);
+
+  return Eigen::Matrix<Scalar,3,1>(atan2(Scalar(2)*(w*x + y*z), Scalar(1) - Scalar(2)*(x*x + y*y)),
+				   asin(sp),
+				   atan2(Scalar(2)*(w*z + x*y), Scalar(1) - Scalar(2)*(y*y + z*z)));
+
+}
+
+/**
+ * @brief Quaternion to rotation.
+ * @param q Input unit quaternion.
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,3> quat2rot(const Eigen::Quaternion<Scalar>& q)
+{
+
+  return q.toRotationMatrix();
+
+}
+
+/**
+ * @brief Rotation to quaternion.
+ * @param R Input rotation.
+ */
+template<typename Derived>
+inline Eigen::Quaternion<typename Derived::Scalar> rot2quat(const Eigen::MatrixBase<Derived>& R)
+{
+
+  EIGEN_STATIC_ASSERT_MATRIX_SPECIFIC_SIZE(Derived,3,3);
+
+  Eigen::Quaternion<typename Derived::Scalar> q(R.eval());
+  q.normalize();
+
+  return q;
+
+}
+
+/**
+ * @brief Exponential map so(3) -> unit quaternions.
+ *
+ * Quaternion of the rotation by the rotation vector v, i.e. the
+ * quaternion counterpart of exp().  Use it for gyro increments
+ * (v = w*dt) and Earth-rate increments.
+ * @param v Rotation vector (units: radians).
+ */
+template<typename Derived>
+inline Eigen::Quaternion<typename Derived::Scalar> quat_exp(const Eigen::MatrixBase<Derived>& v)
+{
+
+  EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived,3);
+
+  typedef typename Derived::Scalar Scalar;
+
+  const Scalar theta2 = v.squaredNorm();
+  Scalar c, s;
+
+  if(theta2 < Scalar(1e-8))
+    {
+      // cos(x/2) and sin(x/2)/x to second order
+      c = Scalar(1) - theta2/Scalar(8);
+      s = Scalar(0.5) - theta2/Scalar(48);
+    }
+  else
+    {
+      const Scalar theta = sqrt(theta2);
+      c = cos(Scalar(0.5)*theta);
+      s = sin(Scalar(0.5)*theta)/theta;
+    }
+
+  return Eigen::Quaternion<Scalar>(c, s*v(0), s*v(1), s*v(2));
+
+}
+
+/**
+ * @brief Normalized quaternion product.
+ *
+ * Returns a*b renormalized, which is all the re-orthonormalization a
+ * quaternion attitude needs.
+ * @param a Left factor.
+ * @param b Right factor.
+ */
+template<typename Scalar>
+inline Eigen::Quaternion<Scalar> quat_mul(const Eigen::Quaternion<Scalar>& a, const Eigen::Quaternion<Scalar>& b)
+{
+
+  Eigen::Quaternion<Scalar> q = a*b;
+  q.normalize();
+
+  return q;
+
+}
+
+/**
+ * @brief Returns Star to Earth rotation as a quaternion.
+ *
+ * Quaternion counterpart of get_R_se().
+ * @param t Time (seconds)
+ */
+template<typename Scalar>
+inline Eigen::Quaternion<Scalar> get_q_se(Scalar t)
+{
+
+  const Scalar rate = Scalar(15.041*M_PI/180/3600);
+
+  return quat_exp(Eigen::Matrix<Scalar,3,1>(Scalar(0),Scalar(0),rate*t));
+
+}
+
+
+/**
+ * @brief Attitude stored as a 3x3 rotation matrix.
+ *
+ * Same interface as QuaternionAttitude.
+ */
+template<typename Scalar>
+struct MatrixAttitude
+{
+
+  typedef Eigen::Matrix<Scalar,3,1> Vector3;
+  typedef Eigen::Matrix<Scalar,3,3> Matrix3;
+
+  Matrix3 R; /**< Attitude. */
+
+  MatrixAttitude(void) : R(Matrix3::Identity()) {}
+  explicit MatrixAttitude(const Matrix3& R_) : R(R_) {}
+
+  /**
+   * @brief Right-multiply by the rotation of a body-frame increment.
+   * @param dtheta Rotation vector (units: radians).
+   */
+  void propagate(const Vector3& dtheta) { R = R*so3::exp(dtheta); }
+
+  /**
+   * @brief One step of iterative re-orthonormalization.
+   */
+  void normalize(void) { R = Scalar(0.5)*(Scalar(3)*Matrix3::Identity() - R*R.transpose())*R; }
+
+  Matrix3 rotation(void) const { return R; }
+  Eigen::Quaternion<Scalar> quaternion(void) const { return rot2quat(R); }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+};
+
+/**
+ * @brief Attitude stored as a unit quaternion.
+ *
+ * Same interface as MatrixAttitude.
+ */
+template<typename Scalar>
+struct QuaternionAttitude
+{
+
+  typedef Eigen::Matrix<Scalar,3,1> Vector3;
+  typedef Eigen::Matrix<Scalar,3,3> Matrix3;
+
+  Eigen::Quaternion<Scalar> q; /**< Attitude. */
+
+  QuaternionAttitude(void) : q(Eigen::Quaternion<Scalar>::Identity()) {}
+  explicit QuaternionAttitude(const Matrix3& R_) : q(rot2quat(R_)) {}
+
+  /**
+   * @brief Right-multiply by the rotation of a body-frame increment.
+   * @param dtheta Rotation vector (units: radians).
+   */
+  void propagate(const Vector3& dtheta) { q = q*quat_exp(dtheta); }
+
+  /**
+   * @brief Renormalize.
+   */
+  void normalize(void) { q.normalize(); }
+
+  Matrix3 rotation(void) const { return q.toRotationMatrix(); }
+  Eigen::Quaternion<Scalar> quaternion(void) const { return q; }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+};
+
+}
+
+
+/**
+ * @brief Batch SLERP resampling of an attitude sequence.
+ *
+ * Interpolates the samples (t_in[i], q_in[i]) onto the times t_out[].
+ * Both time arrays must be non-decreasing, so the whole batch is a
+ * single forward pass.  Output times outside [t_in[0], t_in[n_in-1]]
+ * are clamped to the end samples.
+ *
+ * @param t_in Input sample times.
+ * @param q_in Input unit quaternions.
+ * @param n_in Number of input samples.
+ * @param t_out Output sample times.
+ * @param q_out Output quaternions (n_out elements).
+ * @param n_out Number of output samples.
+ * @return Number of output samples written, or -1 on bad arguments.
+ */
+extern int slerp_batch(const double* t_in, const Eigen::Quaterniond* q_in, int n_in,
+		       const double* t_out, Eigen::Quaterniond* q_out, int n_out);
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Replay of recorded IMU logs as a live sample feed.
+ *
+ * LogReplay reads KVH/MST/PHINS logs, text or binary, and publishes the
+ * samples on an ImuSampleRing, the same hand-off a live serial reader
+ * uses, so a recorded dive runs through the live code path.
+ *
+ * Two threads do the work:
+ *
+ *   reader  maps the files in order, parses them (imu_log.h for text,
+ *           BinlogParser for binary) and fills a read-ahead ring.
+ *   pacer   takes samples from the read-ahead ring and publishes each
+ *           one when the wall clock reaches its scheduled time, the wall
+ *           time of the first sample plus (t - t_first)/speed.  With
+ *           speed REPLAY_UNTHROTTLED samples go out as fast as the
+ *           consumer takes them.
+ *
+ * Samples keep their logged t and seq_num; dt is the difference from the
+ * previous sample (0 for the first), as in ingest_files().  KVH binary
+ * frames carry no time and are numbered at hz from t = 0.
+ *
+ * If asked to, the pacer drives the RENAV clock: before publishing a
+ * burst it calls rov_time_set() with the logged time of its last sample,
+ * mapped to the DSL time of the first text record, or to the opening
+ * time in the name of the first binary file (YYYY_MM_DD_HH_MM.SUFFIX).
+ */
+
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <helper_funcs/spsc_ring.h>
+
+/**
+ * @brief Speed for publishing as fast as possible.
+ */
+#define REPLAY_UNTHROTTLED 0.0
+
+/**
+ * @brief Default read-ahead (units: samples).
+ */
+#define REPLAY_READ_AHEAD 65536
+
+
+/**
+ * @brief Replay statistics.
+ */
+struct ReplayStats
+{
+
+  int files; /**< Files read so far. */
+  uint64_t samples; /**< Samples published. */
+  uint64_t bad_records; /**< Text lines that did not parse, or binary frames with a bad checksum. */
+  uint64_t dropped; /**< Samples dropped because the output ring was full (lossy mode only). */
+  uint64_t starved; /**< Times the pacer found the read-ahead empty before the end of the logs. */
+  double max_lag; /**< Latest publication after a sample's scheduled time (units: seconds). */
+  double elapsed; /**< Wall time from start() to the last sample (units: seconds). */
+
+};
+
+
+/**
+ * @brief Replays log files into a sample ring.
+ */
+class LogReplay
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param out Output ring.  Only the pacer thread pushes to it.
+   * @param speed Playback speed, 1 for real time, or REPLAY_UNTHROTTLED.
+   * @param hz Sampling rate for KVH binary logs.
+   * @param read_ahead Read-ahead ring capacity (units: samples).
+   */
+  LogReplay(ImuSampleRing& out, double speed = 1.0, double hz = 0.0,
+	    size_t read_ahead = REPLAY_READ_AHEAD);
+
+  /**
+   * @brief Destructor.  Stops the threads.
+   */
+  ~LogReplay(void);
+
+  /**
+   * @brief Files to replay, in order.  All must be of the same kind.
+   * @return 0, or -1 if a file cannot be read.
+   */
+  int open(const std::vector<std::string>& files);
+
+  /**
+   * @brief All files with one suffix in a directory, by name.
+   * @return 0, or -1 if the directory or a file cannot be read.
+   */
+  int open(const char* dir, const char* suffix);
+
+  /**
+   * @brief Drive the RENAV clock with rov_time_set() (default off).
+   *
+   * start() then also switches the time mode to ROV_TIME_MODE_RENAV.
+   */
+  void set_drive_clock(bool on) { drive_clock = on; }
+
+  /**
+   * @brief Drop samples when the output ring is full, like a live reader
+   *        (default off: the pacer waits for room).
+   */
+  void set_lossy(bool on) { lossy = on; }
+
+  /**
+   * @brief Start the reader and pacer threads.
+   * @return 0, or -1 if already started or nothing is open.
+   */
+  int start(void);
+
+  /**
+   * @brief Stop both threads.  Samples already published stay in the ring.
+   */
+  void stop(void);
+
+  /**
+   * @brief Wait until every sample has been published.
+   */
+  void wait(void);
+
+  /**
+   * @brief True once every sample has been published.
+   */
+  bool done(void) const { return finished.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Statistics.  Consistent once done().
+   */
+  const ReplayStats& stats(void) const { return st; }
+
+private:
+
+  void reader(void);
+  void pacer(void);
+  bool put_ahead(const ImuSample* s, size_t n);
+
+  ImuSampleRing& out;
+  double speed;
+  double hz;
+  bool drive_clock;
+  bool lossy;
+
+  std::vector<std::string> files;
+  int format;
+  double clock_base; // RENAV time of the first sample
+
+  SpscRing<ImuSample> ahead;
+  std::thread read_thread;
+  std::thread pace_thread;
+  std::atomic<bool> stopping;
+  std::atomic<bool> read_done;
+  std::atomic<bool> finished;
+
+  ReplayStats st;
+  std::atomic<uint64_t> bad_records;
+  std::atomic<int> files_read;
+
+  LogReplay(const LogReplay&);
+  LogReplay& operator=(const LogReplay&);
+
+};
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Event-driven serial port acquisition.
+ *
+ * One SerialReader thread serves any number of IMU serial ports with a
+ * single epoll set.  Ports are opened raw (no echo, no line discipline,
+ * VMIN = VTIME = 0, non-blocking) at config_params::baud, and the
+ * driver's low-latency flag is requested where it exists.
+ *
+ * When epoll reports a port readable, the reader takes the host time
+ * (CLOCK_REALTIME, as rov_get_time() in normal mode) before reading,
+ * drains the port into a preallocated receive buffer, frames it with
+ * BinlogParser into a preallocated batch, and pushes the samples to the
+ * port's ImuSampleRing with comp_timestamp set to that time.  No memory
+ * is allocated once a port is added: the batch holds as many samples as
+ * a full receive buffer of the shortest frames.
+ *
+ * Bytes of a partial frame at the end of a read are kept for the next
+ * one.  Samples that do not fit in the ring are dropped and counted by
+ * the ring, as overruns.  A StreamMonitor attached to a port sees every
+ * sample framed, before the push.
+ */
+
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <helper_funcs/helper_funcs.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/spsc_ring.h>
+#include <helper_funcs/stream_monitor.h>
+
+/**
+ * @brief Receive buffer per port (units: bytes).
+ */
+#define SERIAL_RX_BYTES (64 << 10)
+
+/**
+ * @brief Most samples pushed to the ring at once; a read that frames
+ *        more is pushed in pieces of this size.
+ */
+#define SERIAL_MAX_BATCH 4096
+
+
+/**
+ * @brief Open a serial port raw and non-blocking.
+ *
+ * @param port Device, e.g. config_params::port.
+ * @param baud Baud rate, e.g. config_params::baud.
+ * @return File descriptor, or -1 on failure (unknown baud rate included).
+ */
+extern int serial_open(const char* port, int baud);
+
+/**
+ * @brief Put an open terminal in raw mode at a baud rate.
+ * @return 0, or -1 on failure.
+ */
+extern int serial_set_raw(int fd, int baud);
+
+
+/**
+ * @brief Per-port statistics.
+ */
+struct SerialPortStats
+{
+
+  uint64_t reads; /**< read() calls that returned data. */
+  uint64_t wakeups; /**< Times epoll reported the port readable. */
+  uint64_t bytes; /**< Bytes received. */
+  uint64_t samples; /**< Samples framed and pushed. */
+  uint64_t bad_checksum; /**< Frames rejected by their checksum. */
+  uint64_t resync_bytes; /**< Bytes skipped between frames. */
+  int errors; /**< read() errors other than EAGAIN, and hang-ups. */
+  size_t batch_capacity; /**< Samples the framing batch holds; fixed when the port is added. */
+
+};
+
+
+struct SerialPort;
+
+/**
+ * @brief Multi-port serial reader.
+ */
+class SerialReader
+{
+public:
+
+  SerialReader(void);
+
+  /**
+   * @brief Destructor.  Stops the thread and closes the ports.
+   */
+  ~SerialReader(void);
+
+  /**
+   * @brief Open and add a port.
+   *
+   * @param port Device.
+   * @param baud Baud rate.
+   * @param format BINLOG_FORMAT_KVH, _MST or _PHINS.
+   * @param out Ring the port's samples are pushed to.
+   * @param hz Sampling rate, for formats without time.
+   * @return Port number, or -1 on failure.
+   */
+  int add_port(const char* port, int baud, int format, ImuSampleRing& out, double hz = 0.0);
+
+  /**
+   * @brief Add the port named by config_params::port at config_params::baud.
+   */
+  int add_port(const config_params& params, int format, ImuSampleRing& out);
+
+  /**
+   * @brief Add an already open, non-blocking descriptor.  The reader
+   *        takes ownership and closes it.
+   * @return Port number, or -1 on failure.
+   */
+  int add_fd(int fd, int format, ImuSampleRing& out, double hz = 0.0);
+
+  /**
+   * @brief Pass every sample of a port to a monitor (NULL for none).
+   *        Set before start(); the monitor must outlive the reader.
+   */
+  void set_monitor(int port, StreamMonitor* monitor);
+
+  /**
+   * @brief Wait for and handle one round of events.
+   *
+   * For callers that run their own loop instead of start().
+   * @param timeout_ms Longest wait, or -1 to wait forever.
+   * @return Number of ports that were read, or -1 on error.
+   */
+  int poll_once(int timeout_ms);
+
+  /**
+   * @brief Run poll_once() on a thread until stop().  Ports must all be
+   *        added before.
+   * @return 0, or -1 if already running.
+   */
+  int start(void);
+
+  void stop(void);
+
+  int num_ports(void) const { return (int) ports.size(); }
+
+  /**
+   * @brief Statistics of a port.  Exact only when the thread is stopped.
+   */
+  const SerialPortStats& stats(int port) const;
+
+private:
+
+  void read_port(SerialPort* p, double t_host);
+
+  int epfd;
+  std::vector<SerialPort*> ports;
+  std::thread thread;
+  std::atomic<bool> stopping;
+  int wake_fd; // eventfd that interrupts epoll_wait on stop()
+
+  SerialReader(const SerialReader&);
+  SerialReader& operator=(const SerialReader&);
+
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Inline, fixed-size rotation helpers.
+ *
+ * Header-only versions of skew(), unskew(), Rx(), Ry(), Rz(), rpy2rot()
+ * and get_R_en().  They are templated on the scalar type (float or
+ * double) and take their arguments as Eigen expressions, so that when
+ * called from an estimator loop the compiler can inline them and fuse
+ * them with the surrounding Eigen code instead of making an opaque call
+ * and copying 3x3 matrices by value.
+ *
+ * The out-of-line versions declared in helper_funcs.h are kept for ABI
+ * compatibility and are implemented on top of these.
+ */
+
+
+#ifndef SO3_H
+#define SO3_H
+
+#include <math.h>
+#include <Eigen/Core>
+
+
+namespace so3
+{
+
+/**
+ * @brief Skew function.
+ *
+ * Skew operator on \f${\rm I\!R}^3\f$.
+ * @param w Input vector.
+ */
+template<typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar,3,3> skew(const Eigen::MatrixBase<Derived>& w)
+{
+
+  EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived,3);
+
+  typedef typename Derived::Scalar Scalar;
+
+  Eigen::Matrix<Scalar,3,3> w_hat;
+  w_hat << Scalar(0),-w(2),w(1),
+           w(2),Scalar(0),-w(0),
+           -w(1),w(0),Scalar(0);
+
+  return w_hat;
+
+}
+
+/**
+ * @brief Unskew function.
+ *
+ * @param w_hat Input so(3) matrix.
+ */
+template<typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar,3,1> unskew(const Eigen::MatrixBase<Derived>& w_hat)
+{
+
+  EIGEN_STATIC_ASSERT_MATRIX_SPECIFIC_SIZE(Derived,3,3);
+
+  return Eigen::Matrix<typename Derived::Scalar,3,1>(-w_hat(1,2),w_hat(0,2),-w_hat(0,1));
+
+}
+
+/**
+ * @brief Rotation around x-axis.
+ * @param x angle (units: radians).
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,3> Rx(Scalar x)
+{
+
+  const Scalar c = cos(x);
+  const Scalar s = sin(x);
+
+  Eigen::Matrix<Scalar,3,3> R;
+  R << Scalar(1),Scalar(0),Scalar(0),
+       Scalar(0),c,-s,
+       Scalar(0),s,c;
+
+  return R;
+
+}
+
+/**
+ * @brief Rotation around y-axis.
+ * @param y angle (units: radians).
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,3> Ry(Scalar y)
+{
+
+  const Scalar c = cos(y);
+  const Scalar s = sin(y);
+
+  Eigen::Matrix<Scalar,3,3> R;
+  R << c,Scalar(0),s,
+       Scalar(0),Scalar(1),Scalar(0),
+       -s,Scalar(0),c;
+
+  return R;
+
+}
+
+/**
+ * @brief Rotation around z-axis.
+ * @param z angle (units: radians).
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,3> Rz(Scalar z)
+{
+
+  const Scalar c = cos(z);
+  const Scalar s = sin(z);
+
+  Eigen::Matrix<Scalar,3,3> R;
+  R << c,-s,Scalar(0),
+       s,c,Scalar(0),
+       Scalar(0),Scalar(0),Scalar(1);
+
+  return R;
+
+}
+
+/**
+ * @brief Roll, pitch, yaw euler angles to rotation.
+ *
+ * Closed form of Rz(yaw)*Ry(pitch)*Rx(roll), six trig calls and no
+ * matrix products.
+ * @param rpy Roll, pitch, yaw vector (units: radians).
+ */
+template<typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar,3,3> rpy2rot(const Eigen::MatrixBase<Derived>& rpy)
+{
+
+  EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived,3);
+
+  typedef typename Derived::Scalar Scalar;
+
+  const Scalar cr = cos(rpy(0));
+  const Scalar sr = sin(rpy(0));
+  const Scalar cp = cos(rpy(1));
+  const Scalar sp = sin(rpy(1));
+  const Scalar cy = cos(rpy(2));
+  const Scalar sy = sin(rpy(2));
+
+  Eigen::Matrix<Scalar,3,3> R;
+  R << cy*cp, cy*sp*sr - sy*cr, cy*sp*cr + sy*sr,
+       sy*cp, sy*sp*sr + cy*cr, sy*sp*cr - cy*sr,
+       -sp,   cp*sr,            cp*cr;
+
+  return R;
+
+}
+
+/**
+ * @brief Returns Earth to NED rotation
+ * @param lat Latitude (radians)
+ */
+template<typename Scalar>
+inline Eigen::Matrix<Scalar,3,3> get_R_en(Scalar lat)
+{
+
+  const Scalar c = cos(lat);
+  const Scalar s = sin(lat);
+
+  Eigen::Matrix<Scalar,3,3> R_en;
+  R_en << -s,Scalar(0),-c,
+          Scalar(0),Scalar(1),Scalar(0),
+          c,Scalar(0),-s;
+
+  return R_en;
+
+}
+
+/**
+ * @brief Exponential map so(3) -> SO(3).
+ *
+ * Closed form (Rodrigues) equivalent of (skew(v)).exp(), with a series
+ * expansion of the coefficients for small angles.
+ * @param v Rotation vector (units: radians).
+ */
+template<typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar,3,3> exp(const Eigen::MatrixBase<Derived>& v)
+{
+
+  EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived,3);
+
+  typedef typename Derived::Scalar Scalar;
+
+  const Scalar theta2 = v.squaredNorm();
+  Scalar a, b;
+
+  if(theta2 < Scalar(1e-8))
+    {
+      // sin(x)/x and (1-cos(x))/x^2 to second order
+      a = Scalar(1) - theta2/Scalar(6);
+      b = Scalar(0.5) - theta2/Scalar(24);
+    }
+  else
+    {
+      const Scalar theta = sqrt(theta2);
+      a = sin(theta)/theta;
+      b = (Scalar(1) - cos(theta))/theta2;
+    }
+
+  const Eigen::Matrix<Scalar,3,3> v_hat = skew(v);
+
+  return Eigen::Matrix<Scalar,3,3>::Identity() + a*v_hat + b*(v_hat*v_hat);
+
+}
+
+}
+
+#endif
@@ -0,0 +1,312 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Single-producer/single-consumer sample ring.
+ *
+ * Bounded, wait-free ring buffer for handing IMU samples from a sensor
+ * reader thread to an estimator thread.  The producer and consumer
+ * indices live on separate cache lines and each side keeps a cached copy
+ * of the other's index, so a push or pop normally touches no shared
+ * cache line other than the slot itself.
+ *
+ * The consumer can either busy-poll or sleep on a futex until the
+ * producer publishes new samples (SPSC_WAKE_FUTEX).  Occupancy high-water
+ * mark and overruns (samples dropped because the ring was full) are
+ * counted.
+ */
+
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <new>
+#include <helper_funcs/imu_sample.h>
+
+/**
+ * @brief Consumer wakeup modes.
+ */
+#define SPSC_WAKE_POLL   0  /* consumer busy-polls */
+#define SPSC_WAKE_FUTEX  1  /* consumer sleeps on a futex */
+
+
+/**
+ * @brief Sleep until *word != val, a wakeup, or timeout.
+ *
+ * @param word Futex word.
+ * @param val Expected value.
+ * @param timeout Seconds, or negative to wait forever.
+ */
+extern void spsc_futex_wait(std::atomic<int>* word, int val, double timeout);
+
+/**
+ * @brief Wake one waiter on word.
+ */
+extern void spsc_futex_wake(std::atomic<int>* word);
+
+
+/**
+ * @brief Single-producer/single-consumer ring buffer.
+ *
+ * T must be trivially copyable.  push*() may only be called from one
+ * thread and pop*() / wait_pop() from one other thread.
+ */
+template<typename T>
+class SpscRing
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param capacity Minimum capacity, rounded up to a power of two.
+   * @param wake_mode SPSC_WAKE_POLL or SPSC_WAKE_FUTEX.
+   */
+  SpscRing(size_t capacity, int wake_mode = SPSC_WAKE_POLL)
+    : wake(wake_mode)
+  {
+    size_t cap = 1;
+    while(cap < capacity)
+      cap <<= 1;
+    mask = cap - 1;
+
+    void* p = NULL;
+    if(posix_memalign(&p, 64, cap*sizeof(T)) != 0)
+      throw std::bad_alloc();
+    slots = (T*) p;
+
+    head = 0;
+    tail = 0;
+    head_cached = 0;
+    tail_cached = 0;
+    high_water = 0;
+    overruns = 0;
+    waiting = 0;
+    wake_seq = 0;
+  }
+
+  ~SpscRing(void) { free(slots); }
+
+  // the indices are cache-line aligned, which plain new does not honour before C++17
+  static void* operator new(size_t size)
+  {
+    void* p = NULL;
+    if(posix_memalign(&p, 64, size) != 0)
+      throw std::bad_alloc();
+    return p;
+  }
+
+  static void operator delete(void* p) { free(p); }
+
+  size_t capacity(void) const { return mask + 1; }
+
+  /**
+   * @brief Number of samples in the ring.  Exact only from the producer or consumer thread.
+   */
+  size_t size(void) const { return (size_t) (head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)); }
+
+  bool empty(void) const { return size() == 0; }
+
+  /**
+   * @brief Producer: push one sample.
+   * @return false, and counts an overrun, if the ring is full.
+   */
+  bool push(const T& item) { return push(&item, 1) == 1; }
+
+  /**
+   * @brief Producer: push up to n samples.
+   * @return Number pushed.  The rest are counted as overruns.
+   */
+  size_t push(const T* items, size_t n)
+  {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+
+    size_t room = capacity() - (size_t) (h - tail_cached);
+    if(room < n)
+      {
+	tail_cached = tail.load(std::memory_order_acquire);
+	room = capacity() - (size_t) (h - tail_cached);
+      }
+
+    const size_t m = (n < room) ? n : room;
+    if(m < n)
+      overruns.store(overruns.load(std::memory_order_relaxed) + (n - m), std::memory_order_relaxed);
+    if(m == 0)
+      return 0;
+
+    copy_in(h, items, m);
+    head.store(h + m, std::memory_order_release);
+
+    const uint64_t used = h + m - tail_cached;
+    if(used > high_water.load(std::memory_order_relaxed))
+      high_water.store(used, std::memory_order_relaxed);
+
+    if(wake == SPSC_WAKE_FUTEX)
+      {
+	// pairs with the fence in wait_pop()
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(waiting.load(std::memory_order_relaxed))
+	  {
+	    wake_seq.fetch_add(1, std::memory_order_release);
+	    spsc_futex_wake(&wake_seq);
+	  }
+      }
+
+    return m;
+  }
+
+  /**
+   * @brief Consumer: pop one sample.
+   * @return false if the ring is empty.
+   */
+  bool pop(T& item) { return pop(&item, 1) == 1; }
+
+  /**
+   * @brief Consumer: pop up to max samples.
+   * @return Number popped.
+   */
+  size_t pop(T* out, size_t max)
+  {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+
+    size_t avail = (size_t) (head_cached - t);
+    if(avail < max)
+      {
+	head_cached = head.load(std::memory_order_acquire);
+	avail = (size_t) (head_cached - t);
+      }
+
+    const size_t m = (max < avail) ? max : avail;
+    if(m == 0)
+      return 0;
+
+    copy_out(t, out, m);
+    tail.store(t + m, std::memory_order_release);
+
+    return m;
+  }
+
+  /**
+   * @brief Consumer: pop up to max samples, waiting for at least one.
+   *
+   * Busy-polls or sleeps on the futex according to the wake mode.
+   * @param out Output samples.
+   * @param max Capacity of out.
+   * @param timeout Seconds, or negative to wait forever.
+   * @return Number popped, 0 on timeout.
+   */
+  size_t wait_pop(T* out, size_t max, double timeout = -1.0)
+  {
+    timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for(;;)
+      {
+	size_t m = pop(out, max);
+	if(m > 0)
+	  return m;
+
+	double remaining = -1.0;
+	if(timeout >= 0.0)
+	  {
+	    timespec t1;
+	    clock_gettime(CLOCK_MONOTONIC, &t1);
+	    remaining = timeout - ((t1.tv_sec - t0.tv_sec) + 1e-9*(t1.tv_nsec - t0.tv_nsec));
+	    if(remaining <= 0.0)
+	      return 0;
+	  }
+
+	if(wake == SPSC_WAKE_POLL)
+	  {
+#if defined(__x86_64__) || defined(__i386__)
+	    __builtin_ia32_pause();
+#endif
+	    continue;
+	  }
+
+	const int seq = wake_seq.load(std::memory_order_acquire);
+	waiting.store(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed))
+	  spsc_futex_wait(&wake_seq, seq, remaining);
+	waiting.store(0, std::memory_order_relaxed);
+      }
+  }
+
+  /**
+   * @brief Highest occupancy seen by the producer.
+   *
+   * Measured against the producer's cached copy of the consumer index,
+   * so it errs on the high side.
+   */
+  size_t high_water_mark(void) const { return (size_t) high_water.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Number of samples dropped because the ring was full.
+   */
+  uint64_t overrun_count(void) const { return overruns.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Producer: reset the high-water mark and overrun count.
+   */
+  void reset_stats(void)
+  {
+    high_water.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+  }
+
+private:
+
+  void copy_in(uint64_t h, const T* items, size_t m)
+  {
+    const size_t i = (size_t) (h & mask);
+    const size_t first = (m < capacity() - i) ? m : capacity() - i;
+    memcpy(&slots[i], items, first*sizeof(T));
+    memcpy(&slots[0], items + first, (m - first)*sizeof(T));
+  }
+
+  void copy_out(uint64_t t, T* out, size_t m)
+  {
+    const size_t i = (size_t) (t & mask);
+    const size_t first = (m < capacity() - i) ? m : capacity() - i;
+    memcpy(out, &slots[i], first*sizeof(T));
+    memcpy(out + first, &slots[0], (m - first)*sizeof(T));
+  }
+
+  // read-mostly
+  T* slots;
+  size_t mask;
+  int wake;
+
+  // producer side
+  alignas(64) std::atomic<uint64_t> head;
+  uint64_t tail_cached;
+  std::atomic<uint64_t> high_water;
+  std::atomic<uint64_t> overruns;
+
+  // consumer side
+  alignas(64) std::atomic<uint64_t> tail;
+  uint64_t head_cached;
+  std::atomic<int> waiting;
+
+  // futex word
+  alignas(64) std::atomic<int> wake_seq;
+
+  char pad[64 - sizeof(std::atomic<int>)];
+
+  SpscRing(const SpscRing&);
+  SpscRing& operator=(const SpscRing&);
+
+};
+
+
+/**
+ * @brief Ring of compact IMU samples.
+ */
+typedef SpscRing<ImuSample> ImuSampleRing;
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Strapdown attitude integrator.
+ *
+ * Integrates angular-rate samples at the sensor rate (config_params::hz)
+ * into attitude increments at the estimator rate (config_params::rate),
+ * using the closed-form exponential and a multi-sample coning correction.
+ */
+
+
+#ifndef STRAPDOWN_H
+#define STRAPDOWN_H
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <helper_funcs/helper_funcs.h>
+
+
+/**
+ * @brief Attitude increment over one estimator update interval.
+ */
+struct AttitudeIncrement
+{
+
+  Eigen::Vector3d phi; /**< Rotation vector of the increment, coning corrected (units: radians). */
+  Eigen::Quaterniond dq; /**< The same increment as a unit quaternion. */
+  double t; /**< Timestamp of the last sample in the interval. */
+  double dt; /**< Length of the interval (units: seconds). */
+  int num_samples; /**< Number of samples integrated. */
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+};
+
+
+/**
+ * @brief Strapdown attitude integrator.
+ *
+ * Each ImuPacket::ang is taken as the mean angular rate over the packet's
+ * dt, so the angle increment of one sample is ang*dt.  Over an update
+ * interval the increments are summed (alpha) and the coning term
+ *
+ * \f$\beta_k = \beta_{k-1} + \frac{1}{2}(\alpha_{k-1} + \frac{1}{6}\Delta\theta_{k-1}) \times \Delta\theta_k\f$
+ *
+ * is accumulated, giving the rotation vector \f$\phi = \alpha + \beta\f$
+ * of the whole interval.  Apply it with R = R*so3::exp(phi), q = q*dq or
+ * the propagate() method of the attitude types in quat.h.
+ *
+ * No memory is allocated after construction.
+ */
+class StrapdownIntegrator
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param hz Sensor sampling rate.
+   * @param rate Output (estimator) rate.
+   * @param coning Apply the coning correction.
+   */
+  StrapdownIntegrator(int hz, int rate, bool coning = true);
+
+  /**
+   * @brief Constructor.
+   *
+   * Takes hz and rate from the loaded parameters.
+   * @param params Parameter struct.
+   */
+  StrapdownIntegrator(const config_params& params);
+
+  /**
+   * @brief Discard any partially integrated interval.
+   */
+  void reset(void);
+
+  /**
+   * @brief Integrate one sample.
+   *
+   * @param pkt IMU packet.
+   * @param out Filled in when an interval completes.
+   * @return true if out was filled in.
+   */
+  bool push(const ImuPacket& pkt, AttitudeIncrement& out);
+
+  /**
+   * @brief Integrate a batch of samples.
+   *
+   * @param pkts IMU packets.
+   * @param n Number of packets.
+   * @param out Output increments.
+   * @param max_out Capacity of out, at least n/samples_per_update()+1 for
+   *        the whole batch to be consumed.  Integration stops once it is full.
+   * @return Number of increments written to out.
+   */
+  int integrate(const ImuPacket* pkts, int n, AttitudeIncrement* out, int max_out);
+
+  /**
+   * @brief Number of samples per output increment.
+   */
+  int samples_per_update(void) const { return decimation; }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+
+  int decimation;
+  bool coning;
+  double dt_nominal;
+
+  Eigen::Vector3d alpha;
+  Eigen::Vector3d beta;
+  Eigen::Vector3d dtheta_last;
+  double dt_sum;
+  int count;
+
+};
+
+#endif
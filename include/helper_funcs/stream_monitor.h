@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Sequence-gap and timing-jitter monitor for IMU sample streams.
+ *
+ * The acquisition thread passes every sample to StreamMonitor::observe(),
+ * which costs O(1) and takes no lock: the monitor's counters are owned by
+ * that thread and published with relaxed atomic stores, no
+ * read-modify-write, so any other thread can read them at any time with
+ * snapshot().  Counters only grow; a summary over an interval is the
+ * difference of two snapshots.
+ *
+ * Per sample it tracks, from seq_num (modulo the sensor's counter range):
+ *
+ *   gaps          jumps forward by more than one, and the samples lost
+ *   duplicates    the same seq_num twice in a row
+ *   out of order  seq_num behind the previous one
+ *
+ * and from timestamp (sensor clock) and comp_timestamp (host clock):
+ *
+ *   sensor jitter     timestamp step minus the step expected from seq_num
+ *                     at hz (RMS and max)
+ *   host arrival      histogram of comp_timestamp steps
+ *   arrival jitter    histogram of |comp_timestamp step - timestamp step|,
+ *                     the burstiness the acquisition path adds
+ *   clock skew        least-squares slope of comp_timestamp - timestamp
+ *                     against timestamp (units: ppm), and that offset now
+ *
+ * Histograms have log2 bins in microseconds.  The first sample after
+ * construction or reset() only sets the baseline, so the placeholder
+ * seq_num of 500 a GyroData starts with is never counted as a gap.
+ *
+ * log_summary() writes one DSL record with the interval's numbers through
+ * log_this_now_dsl_format(); call it from the thread that runs
+ * log_one_hertz_update().  A maximum cannot be differenced, so the
+ * sensor jitter maximum in it is over all time (jitter_max_all_us); the
+ * histogram maxima are the interval's, to their bin's upper edge.
+ */
+
+
+#ifndef STREAM_MONITOR_H
+#define STREAM_MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <helper_funcs/gyro_data.h>
+#include <helper_funcs/imu_sample.h>
+
+/**
+ * @brief Histogram bins.  Bin 0 is below 1 us, bin i is [2^(i-1), 2^i) us,
+ *        the last also holds everything longer.
+ */
+#define STREAM_MONITOR_BINS 24
+
+/**
+ * @brief Samples between updates of the clock skew estimate.
+ */
+#define STREAM_MONITOR_SKEW_EVERY 64
+
+
+/**
+ * @brief Counters of a StreamMonitor at one instant.
+ */
+struct StreamStats
+{
+
+  uint64_t samples; /**< Samples observed. */
+  uint64_t gaps; /**< Forward jumps of seq_num by more than one. */
+  uint64_t lost; /**< Samples missing in those jumps. */
+  uint64_t duplicates; /**< Repeated seq_num. */
+  uint64_t out_of_order; /**< seq_num behind the previous one. */
+  double jitter_sum2; /**< Sum of squared sensor jitter (units: s^2). */
+  double jitter_max; /**< Largest sensor jitter since construction or reset() (units: seconds). */
+  double skew_ppm; /**< Host clock rate minus sensor clock rate (units: ppm). */
+  double offset; /**< Latest comp_timestamp - timestamp (units: seconds). */
+  uint64_t arrival[STREAM_MONITOR_BINS]; /**< Host inter-arrival histogram. */
+  uint64_t arrival_jitter[STREAM_MONITOR_BINS]; /**< Arrival jitter histogram. */
+
+};
+
+
+/**
+ * @brief Bin of an interval in a StreamStats histogram.
+ */
+extern int stream_monitor_bin(double seconds);
+
+/**
+ * @brief Upper edge of a histogram bin (units: seconds).
+ */
+extern double stream_monitor_bin_edge(int bin);
+
+/**
+ * @brief Write the difference of two snapshots as text.
+ *
+ * jitter_max_all_us is now.jitter_max, the maximum over all time.
+ *
+ * @param now Later snapshot.
+ * @param prev Earlier snapshot (all zero for everything so far).
+ * @param buf Output buffer.
+ * @param len Size of buf.
+ * @return Length written, as snprintf().
+ */
+extern int stream_monitor_format(const StreamStats& now, const StreamStats& prev, char* buf, size_t len);
+
+
+/**
+ * @brief Gap and jitter monitor of one sample stream.
+ */
+class StreamMonitor
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param hz Nominal sampling rate (units: Hz).
+   * @param seq_modulus Range of the sensor's sequence counter, e.g. 128
+   *        for KVH binary frames, or 0 for the full 32 bits.
+   */
+  StreamMonitor(double hz, uint64_t seq_modulus = 0);
+
+  /**
+   * @brief Account for one sample.  Call from one thread only.
+   */
+  void observe(uint32_t seq_num, double timestamp, double comp_timestamp);
+
+  void observe(const ImuSample& s) { observe(s.seq_num, s.timestamp, s.comp_timestamp); }
+  void observe(const GyroData& g) { observe(g.seq_num, g.timestamp, g.comp_timestamp); }
+
+  /**
+   * @brief Read the counters.  Any thread.
+   */
+  void snapshot(StreamStats& st) const;
+
+  /**
+   * @brief Log what happened since the previous call as a DSL record.
+   *
+   * Not reentrant: call from one thread.
+   * @param log_fid Log file.
+   * @param record_name DSL record name, e.g. "MON".
+   * @return As log_this_now_dsl_format().
+   */
+  int log_summary(int log_fid, const char* record_name);
+
+  /**
+   * @brief Start over.  Only while no thread is in observe().
+   */
+  void reset(void);
+
+private:
+
+  double period;
+  uint64_t modulus;
+
+  // acquisition thread only
+  bool started;
+  uint32_t last_seq;
+  double last_t;
+  double last_comp;
+  double t0, offset0;
+  double sx, sy, sxx, sxy;
+  StreamStats local;
+
+  // published copies of local
+  std::atomic<uint64_t> pub_samples;
+  std::atomic<uint64_t> pub_gaps;
+  std::atomic<uint64_t> pub_lost;
+  std::atomic<uint64_t> pub_duplicates;
+  std::atomic<uint64_t> pub_out_of_order;
+  std::atomic<double> pub_jitter_sum2;
+  std::atomic<double> pub_jitter_max;
+  std::atomic<double> pub_skew_ppm;
+  std::atomic<double> pub_offset;
+  std::atomic<uint64_t> pub_arrival[STREAM_MONITOR_BINS];
+  std::atomic<uint64_t> pub_arrival_jitter[STREAM_MONITOR_BINS];
+
+  // log_summary() thread only
+  StreamStats last_logged;
+
+  StreamMonitor(const StreamMonitor&);
+  StreamMonitor& operator=(const StreamMonitor&);
+
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Parallel parameter sweep over one IMU log.
+ *
+ * Loads the input log once and runs the attitude observer (observer.h)
+ * for many config_params variants in parallel, sharing the read-only
+ * samples across the worker threads.  A config that failed to load or
+ * that config_params_check() rejects is not run; its result is marked.
+ */
+
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdio.h>
+#include <vector>
+#include <Eigen/Core>
+#include <helper_funcs/helper_funcs.h>
+
+
+/**
+ * @brief Summary of one observer run.
+ */
+struct SweepResult
+{
+
+  int ok; /**< 1 if the run was made, 0 if the config was rejected and skipped. */
+  int num_updates; /**< Number of observer updates. */
+  double elapsed; /**< Wall time of the run (units: seconds). */
+
+  double acc_rms; /**< RMS acceleration residual, acc_hat - (acc - acc_bias). */
+  double mag_rms; /**< RMS magnetometer residual, mag_hat - (mag - mag_bias). */
+
+  Eigen::Vector3d rph; /**< Final vehicle roll, pitch, heading (units: radians). */
+  Eigen::Vector3d ang_bias; /**< Final angular-rate bias. */
+  Eigen::Vector3d acc_bias; /**< Final linear-acceleration bias. */
+  Eigen::Vector3d mag_bias; /**< Final magnetometer bias. */
+
+};
+
+
+/**
+ * @brief Run the observer over pkts once for each configuration.
+ *
+ * Configurations that fail config_params_check() are skipped: their
+ * result has ok 0 and everything else zero.
+ *
+ * @param pkts IMU packets, shared read-only by all runs.
+ * @param configs Parameter sets.
+ * @param results Output, one per configuration.
+ * @param num_threads Number of worker threads, or 0 for one per core.
+ */
+extern void sweep_run(const std::vector<ImuPacket>& pkts,
+		      const std::vector<config_params>& configs,
+		      std::vector<SweepResult>& results,
+		      int num_threads = 0);
+
+/**
+ * @brief Load a log and a set of config files and sweep them.
+ *
+ * @param log_file IMU text log (imu_log.h).
+ * @param config_files Config files, loaded in parallel by config_load_many().
+ * @param configs Output, the loaded parameter sets.
+ * @param results Output, one per config file; a file that failed to
+ *        load or to check is reported and has ok 0.
+ * @param num_threads Number of worker threads, or 0 for one per core.
+ * @return Number of packets loaded, or -1 if the log could not be read.
+ */
+extern int sweep_files(const char* log_file,
+		       const std::vector<std::string>& config_files,
+		       std::vector<config_params>& configs,
+		       std::vector<SweepResult>& results,
+		       int num_threads = 0);
+
+/**
+ * @brief Print a summary table, one row per configuration.
+ *
+ * @param fp Output stream.
+ * @param configs Parameter sets.
+ * @param results Results of sweep_run().
+ */
+extern void sweep_print_table(FILE* fp, const std::vector<config_params>& configs, const std::vector<SweepResult>& results);
+
+#endif
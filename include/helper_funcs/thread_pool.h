@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Work-stealing thread pool.
+ *
+ * A fixed set of worker threads, each with its own queue of task
+ * indices.  A worker pops from the back of its own queue and, when that
+ * is empty, steals from the front of the others, so uneven tasks (e.g.
+ * configurations that take longer to evaluate) still balance.
+ */
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Work-stealing thread pool.
+ */
+class WorkStealingPool
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param num_threads Number of worker threads, or 0 for one per core.
+   */
+  WorkStealingPool(int num_threads = 0);
+
+  /**
+   * @brief Destructor.  Joins the workers.
+   */
+  ~WorkStealingPool(void);
+
+  /**
+   * @brief Number of worker threads.
+   */
+  int size(void) const { return (int) threads.size(); }
+
+  /**
+   * @brief Run task(i) for i in [0,n) on the workers and wait for all of them.
+   *
+   * Not reentrant: call from one thread at a time, and not from inside a task.
+   *
+   * @param n Number of tasks.
+   * @param task Task body.
+   */
+  void parallel_for(int n, const std::function<void(int)>& task);
+
+private:
+
+  struct Queue
+  {
+    std::mutex lock;
+    std::deque<int> items;
+  };
+
+  void worker(int id);
+  bool pop_or_steal(int id, int& item);
+
+  std::vector<std::thread> threads;
+  std::vector<Queue*> queues;
+
+  std::mutex mtx;
+  std::condition_variable cv_start;
+  std::condition_variable cv_done;
+
+  const std::function<void(int)>* task;
+  unsigned generation;
+  int active;
+  int joined; // workers that have taken the current generation
+  bool stop;
+
+  std::atomic<int> remaining;
+
+  WorkStealingPool(const WorkStealingPool&);
+  WorkStealingPool& operator=(const WorkStealingPool&);
+
+};
+
+#endif
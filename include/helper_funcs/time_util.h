@@ -68,6 +68,13 @@ extern int  rov_time_set( char * string);
 extern rov_time_t rov_time_compute( int year, int month, int day, int hour, int min, double sec );
 extern int rov_convert_dsl_time_string(double total_secs, char *str);
 
+// 2026-10-19 integer ns dsl time parser, used to seek in log files
+#define ROV_TIME_NS_INVALID (-9223372036854775807LL - 1)
+extern long long rov_parse_dsl_time_string_ns(const char * str, const char * end, const char ** after);
+
+// 2026-10-19 monotonic ns clock for timing intervals, e.g. trace spans
+extern long long rov_get_clock_ns(void);
+
 /* variables used for controlling time */
 #define ROV_TIME_MODE_NORMAL 0  /* Normal time, use O/S time */
 #define ROV_TIME_MODE_RENAV  1  /* fake time, use atrificial time */
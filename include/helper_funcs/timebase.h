@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Sensor-to-host clock alignment and resampling onto a common time grid.
+ *
+ * ClockAligner fits host = host_0 + a + b (sensor - sensor_0) online from
+ * the (timestamp, comp_timestamp) pairs of a sensor's samples: recursive
+ * least squares with exponential forgetting, each pair weighted by Huber's
+ * function of its residual over a running scale estimate, so the late
+ * arrivals of a loaded acquisition path pull the line much less than a
+ * plain fit would.  Each update is O(1).  Offset is a, drift is b - 1.
+ * Host delays are never negative, so the fitted line runs a little above
+ * the true clock mapping; the bias is the typical delay, which is the
+ * same for every sensor read the same way.
+ *
+ * ImuResampler and AttitudeResampler interpolate samples onto the grid
+ * of multiples of 1/rate (absolute, so streams resampled at one rate
+ * share their grid times): linear or cubic (Catmull-Rom) for the ang,
+ * acc and mag axes of an ImuBatch, SLERP for attitudes.  Both stream: a
+ * grid time is written once the samples around it have arrived, and the
+ * last few samples are kept for the next block.  The interpolation
+ * indices and weights of a block are worked out once and then applied to
+ * all nine axes in simple loops.
+ *
+ * Map the sample times to the host clock with ClockAligner::to_host()
+ * first to put several sensors on one time base.
+ */
+
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <Eigen/Geometry>
+#include <helper_funcs/imu_batch.h>
+
+/**
+ * @brief Default memory of the clock fit (units: samples).
+ */
+#define CLOCK_ALIGN_MEMORY 100000
+
+/**
+ * @brief Default Huber threshold (units: residual scales).
+ */
+#define CLOCK_ALIGN_HUBER 2.0
+
+/**
+ * @brief Linear interpolation.
+ */
+#define RESAMPLE_LINEAR 1
+
+/**
+ * @brief Cubic (Catmull-Rom) interpolation.
+ */
+#define RESAMPLE_CUBIC 3
+
+
+/**
+ * @brief Online robust fit of host time against sensor time.
+ */
+class ClockAligner
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param memory Effective number of recent pairs the fit follows.
+   * @param huber Residuals beyond this many scales are down-weighted.
+   */
+  ClockAligner(double memory = CLOCK_ALIGN_MEMORY, double huber = CLOCK_ALIGN_HUBER);
+
+  /**
+   * @brief Add one (sensor, host) time pair, e.g. (timestamp, comp_timestamp).
+   */
+  void update(double sensor_t, double host_t);
+
+  /**
+   * @brief Add the pairs of a batch: t against the host times given.
+   */
+  void update(const double* sensor_t, const double* host_t, size_t n);
+
+  /**
+   * @brief Host time of a sensor time.
+   */
+  double to_host(double sensor_t) const { return host_0 + a + b*(sensor_t - sensor_0); }
+
+  /**
+   * @brief Host times of n sensor times (may be in place).
+   */
+  void to_host(const double* sensor_t, double* host_t, size_t n) const;
+
+  /**
+   * @brief Sensor time of a host time.
+   */
+  double to_sensor(double host_t) const { return sensor_0 + (host_t - host_0 - a)/b; }
+
+  /**
+   * @brief Host minus sensor time at a sensor time (units: seconds).
+   */
+  double offset(double sensor_t) const { return to_host(sensor_t) - sensor_t; }
+
+  /**
+   * @brief Host clock rate over sensor clock rate, minus one (units: ppm).
+   */
+  double drift_ppm(void) const { return 1e6*(b - 1.0); }
+
+  /**
+   * @brief Robust scale of the residuals (units: seconds).
+   */
+  double residual_scale(void) const { return scale; }
+
+  /**
+   * @brief Pairs added, and pairs that were down-weighted.
+   */
+  uint64_t size(void) const { return num; }
+  uint64_t outliers(void) const { return num_outliers; }
+
+  void reset(void);
+
+private:
+
+  double lambda;
+  double inv_lambda;
+  double huber;
+
+  double sensor_0, host_0; // origin of the fit, moved forward now and then
+  double a, b; // host - host_0 = a + b (sensor - sensor_0)
+  double P[3]; // covariance: P00, P01, P11
+  double scale;
+  uint64_t num;
+  uint64_t num_outliers;
+
+};
+
+
+/**
+ * @brief Streaming resampler of ImuBatch samples onto a time grid.
+ */
+class ImuResampler
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param rate Output rate (units: Hz).  Grid times are k/rate.
+   * @param method RESAMPLE_LINEAR or RESAMPLE_CUBIC.
+   * @param max_gap No output between samples further apart than this
+   *        (units: seconds), or 0 to interpolate across any gap.
+   */
+  ImuResampler(double rate, int method = RESAMPLE_CUBIC, double max_gap = 0.0);
+
+  /**
+   * @brief Resample a block and append the grid samples it completes.
+   *
+   * t, the nine axes, seq_num (of the sample before) and fluid_pressure
+   * (linear) are written; dt is 1/rate.
+   * @param in Samples, t increasing, continuing the previous block.
+   * @param out Batch the grid samples are appended to.
+   * @return Number of samples appended.
+   */
+  size_t process(const ImuBatchView& in, ImuBatch& out);
+
+  /**
+   * @brief Append the grid samples up to the last input, cubic ones with
+   *        the missing neighbour repeated, and start over.
+   */
+  size_t flush(ImuBatch& out);
+
+  void reset(void);
+
+private:
+
+  size_t run(ImuBatch& out, bool final);
+  void keep(size_t from);
+
+  double step;
+  int method;
+  double max_gap;
+  bool started;
+  int64_t k_next; // next grid index
+
+  ImuBatch work; // kept samples followed by the block
+  std::vector<double> grid; // grid time of each output, grown only
+  std::vector<int> nb; // four neighbours per output, cubic
+  std::vector<double> w; // their weights, or the fraction u when linear
+
+};
+
+
+/**
+ * @brief Quaternions in a std::vector.
+ */
+typedef std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond> > QuaternionVector;
+
+
+/**
+ * @brief Streaming SLERP resampler of attitudes onto a time grid.
+ */
+class AttitudeResampler
+{
+public:
+
+  /**
+   * @brief Constructor.
+   *
+   * @param rate Output rate (units: Hz).  Grid times are k/rate.
+   * @param max_gap No output between samples further apart than this
+   *        (units: seconds), or 0 for none.
+   */
+  AttitudeResampler(double rate, double max_gap = 0.0);
+
+  /**
+   * @brief Resample a block and append the grid samples it completes.
+   * @return Number of samples appended.
+   */
+  size_t process(const double* t, const Eigen::Quaterniond* q, size_t n,
+		 std::vector<double>& t_out, QuaternionVector& q_out);
+
+  void reset(void);
+
+private:
+
+  double step;
+  double max_gap;
+  bool started;
+  int64_t k_next;
+
+  double t_last; // last sample of the previous block
+  Eigen::Quaterniond q_last;
+
+public:
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+};
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Scoped trace spans and counters, exported as Chrome trace JSON.
+ *
+ * TRACE_SPAN(cat, name) at the top of a block records one complete event
+ * ("X") covering the block, timed with rov_get_clock_ns(); TRACE_COUNTER()
+ * records a counter value ("C").  Names and categories must be string
+ * literals: only the pointers are stored.
+ *
+ * Each thread records into its own fixed-size ring, registered on the
+ * thread's first event and reused by a later thread once it has ended
+ * and been drained.  Recording is a few stores and one release store of
+ * the ring's head, no lock; a full ring drops the event and counts it.
+ * While tracing is off (the default) a span is one relaxed load and a
+ * branch, and building with -DTRACE_DISABLE removes the macros entirely.
+ *
+ * The exporter drains the rings to Chrome's JSON array format, one event
+ * per line, which chrome://tracing and ui.perfetto.dev both load; the
+ * closing ] is optional in that format, so a file can be cut off at any
+ * line.  trace_start_exporter() runs it on a thread through the log
+ * channel LOG_FID_TRACE_FORMAT, which opens each hourly file with the [.
+ *
+ * log.cpp (records, rotation), time_util.cpp (time structs, dsl time
+ * strings), helper_funcs.cpp (get_R_se(), get_R_sn()), the config parser
+ * and the binary log parser are instrumented.
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <atomic>
+#include <helper_funcs/time_util.h>
+
+/**
+ * @brief Events each thread's ring holds (power of two).
+ */
+#define TRACE_BUFFER_EVENTS 8192
+
+
+/**
+ * @brief Tracing on or off.  Use trace_enable().
+ */
+extern std::atomic<bool> trace_on;
+
+/**
+ * @brief Turn recording on or off.  Events already recorded stay.
+ */
+extern void trace_enable(bool on);
+
+inline bool trace_enabled(void) { return trace_on.load(std::memory_order_relaxed); }
+
+/**
+ * @brief Record an event in the calling thread's ring.
+ *
+ * @param phase 'X' (complete, arg is the duration in ns), 'i' (instant)
+ *        or 'C' (counter, see trace_counter()).
+ * @param cat Category (string literal).
+ * @param name Name (string literal).
+ * @param ts_ns Start, from rov_get_clock_ns().
+ * @param arg Duration (units: ns).
+ */
+extern void trace_event(char phase, const char* cat, const char* name, long long ts_ns, long long arg);
+
+/**
+ * @brief Record a counter value now.
+ */
+extern void trace_counter(const char* cat, const char* name, double value);
+
+/**
+ * @brief Name the calling thread in the trace (copied, up to 31 chars).
+ */
+extern void trace_thread_name(const char* name);
+
+/**
+ * @brief Drain every ring to fp as JSON event lines, thread names first.
+ *        Write "[\n" at the top of the file first.
+ * @return Number of events written.
+ */
+extern int trace_export(FILE* fp);
+
+/**
+ * @brief Drain every ring to a log channel, with thread names at the top
+ *        of each new file.  The oldest event's time in its ring goes to
+ *        the channel's queue wait histogram (log.h).
+ * @return Number of events written.
+ */
+extern int trace_export_log(int log_fid);
+
+/**
+ * @brief Turn tracing on and drain to a log channel every period on a
+ *        background thread.
+ *
+ * @param log_fid Log channel, normally LOG_FID_TRACE_FORMAT.
+ * @param period Seconds between drains.
+ * @return 0, or -1 if already running.
+ */
+extern int trace_start_exporter(int log_fid, double period);
+
+/**
+ * @brief Stop the exporter thread after a last drain.  Tracing stays on.
+ */
+extern void trace_stop_exporter(void);
+
+/**
+ * @brief Events dropped because a ring was full.
+ */
+extern unsigned long long trace_dropped(void);
+
+
+/**
+ * @brief Records a complete event from construction to destruction.
+ */
+class TraceSpan
+{
+public:
+
+  TraceSpan(const char* cat_, const char* name_)
+    : cat(cat_), name(trace_enabled() ? name_ : NULL), t0(name ? rov_get_clock_ns() : 0) {}
+
+  ~TraceSpan(void)
+  {
+    if(name)
+      trace_event('X', cat, name, t0, rov_get_clock_ns() - t0);
+  }
+
+private:
+
+  const char* cat;
+  const char* name;
+  long long t0;
+
+  TraceSpan(const TraceSpan&);
+  TraceSpan& operator=(const TraceSpan&);
+
+};
+
+
+#define TRACE_CONCAT2(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+
+#ifndef TRACE_DISABLE
+
+/**
+ * @brief Trace the rest of the enclosing block.
+ */
+#define TRACE_SPAN(cat, name) TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(cat, name)
+
+/**
+ * @brief Record a counter value.
+ */
+#define TRACE_COUNTER(cat, name, value) do { if(trace_enabled()) trace_counter(cat, name, value); } while(0)
+
+#else
+
+#define TRACE_SPAN(cat, name) do {} while(0)
+#define TRACE_COUNTER(cat, name, value) do {} while(0)
+
+#endif
+
+#endif
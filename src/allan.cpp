@@ -0,0 +1,315 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of allan.h.
+ *
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <helper_funcs/allan.h>
+#include <helper_funcs/thread_pool.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define ALLAN_BLOCK 8192        // k per cache block (units: samples)
+#define ALLAN_RANGES_PER_THREAD 4
+
+void allan_tau_m(size_t n, std::vector<uint64_t>& m, double per_decade)
+{
+
+  m.clear();
+
+  if(per_decade <= 0.0)
+    per_decade = ALLAN_PER_DECADE;
+
+  const uint64_t m_max = n/3;
+
+  for(int i=0; ; i++)
+    {
+      const uint64_t k = (uint64_t) llround(pow(10.0, i/per_decade));
+      if(k > m_max)
+	break;
+      if(m.empty() || k > m.back())
+	m.push_back(k);
+    }
+
+}
+
+// partial sums of one task: every tau over k in [k0, k1)
+static void allan_range(const double* theta, size_t P, const std::vector<uint64_t>& m,
+			size_t k0, size_t k1, int flags, double* sum_adev, double* sum_mdev)
+{
+
+  const size_t num_m = m.size();
+  std::vector<double> S(num_m, 0.0);
+
+  // S before k0 is the sum of d_i for i in [k0-m, k0), summed directly
+  if(flags & ALLAN_MDEV)
+    for(size_t t=0; t<num_m; t++)
+      {
+	const size_t mt = m[t];
+	const size_t end = std::min(k0, P - 2*mt);
+	double s = 0.0;
+	for(size_t i=(k0 > mt) ? k0 - mt : 0; i<end; i++)
+	  s += theta[i + 2*mt] - 2.0*theta[i + mt] + theta[i];
+	S[t] = s;
+      }
+
+  for(size_t b0=k0; b0<k1; b0+=ALLAN_BLOCK)
+    {
+      const size_t b1 = std::min(b0 + ALLAN_BLOCK, k1);
+
+      for(size_t t=0; t<num_m; t++)
+	{
+	  const size_t mt = m[t];
+	  const size_t end = std::min(b1, P - 2*mt);
+	  const double* x0 = theta;
+	  const double* x1 = theta + mt;
+	  const double* x2 = theta + 2*mt;
+	  double a = 0.0;
+
+	  if(!(flags & ALLAN_MDEV))
+	    {
+	      for(size_t k=b0; k<end; k++)
+		{
+		  const double d = x2[k] - 2.0*x1[k] + x0[k];
+		  a += d*d;
+		}
+	      sum_adev[t] += a;
+	      continue;
+	    }
+
+	  double s = S[t];
+	  double b = 0.0;
+	  size_t k = b0;
+
+	  // the first m terms: the window is still filling
+	  for(; k<end && k<mt; k++)
+	    {
+	      const double d = x2[k] - 2.0*x1[k] + x0[k];
+	      a += d*d;
+	      s += d;
+	      if(k + 1 == mt)
+		b += s*s;
+	    }
+
+	  // slide: add d_k, drop d_{k-m}
+	  for(; k<end; k++)
+	    {
+	      const double d = x2[k] - 2.0*x1[k] + x0[k];
+	      const double d_old = x1[k] - 2.0*x0[k] + x0[k - mt];
+	      a += d*d;
+	      s += d - d_old;
+	      b += s*s;
+	    }
+
+	  S[t] = s;
+	  sum_adev[t] += a;
+	  sum_mdev[t] += b;
+	}
+    }
+
+}
+
+static int allan_run(const double* const* x, int num_axes, size_t n, double hz,
+		     const std::vector<uint64_t>& m_in, std::vector<AllanPoint>* out,
+		     int flags, int num_threads)
+{
+
+  if(n < 3 || hz <= 0.0 || !(flags & (ALLAN_ADEV | ALLAN_MDEV)))
+    return -1;
+
+  std::vector<uint64_t> m;
+  for(size_t t=0; t<m_in.size(); t++)
+    if(m_in[t] >= 1 && m_in[t] <= n/3)
+      m.push_back(m_in[t]);
+  std::sort(m.begin(), m.end());
+  m.erase(std::unique(m.begin(), m.end()), m.end());
+
+  const size_t P = n + 1;
+  const size_t num_m = m.size();
+
+  WorkStealingPool pool(num_threads);
+  const int ranges = (pool.size() > 1) ? std::max(1, ALLAN_RANGES_PER_THREAD*pool.size()/num_axes) : 1;
+
+  // theta of each axis, mean removed
+  std::vector<std::vector<double> > theta(num_axes);
+  pool.parallel_for(num_axes, [&](int a) {
+      const double* xa = x[a];
+      double mean = 0.0;
+      for(size_t i=0; i<n; i++)
+	mean += xa[i];
+      mean /= n;
+
+      std::vector<double>& th = theta[a];
+      th.resize(P);
+      th[0] = 0.0;
+      double acc = 0.0;
+      for(size_t i=0; i<n; i++)
+	{
+	  acc += (xa[i] - mean)/hz;
+	  th[i + 1] = acc;
+	}
+    });
+
+  // one task per axis and range of k
+  std::vector<double> partial_adev(num_axes*ranges*num_m, 0.0);
+  std::vector<double> partial_mdev(num_axes*ranges*num_m, 0.0);
+  const size_t k_max = (num_m > 0) ? P - 2*m[0] : 0;
+
+  if(num_m > 0)
+    pool.parallel_for(num_axes*ranges, [&](int task) {
+	const int a = task/ranges;
+	const int r = task%ranges;
+	const size_t k0 = k_max*r/ranges;
+	const size_t k1 = k_max*(r + 1)/ranges;
+	allan_range(&theta[a][0], P, m, k0, k1, flags,
+		    &partial_adev[task*num_m], &partial_mdev[task*num_m]);
+      });
+
+  for(int a=0; a<num_axes; a++)
+    {
+      out[a].resize(num_m);
+      for(size_t t=0; t<num_m; t++)
+	{
+	  double sa = 0.0, sm = 0.0;
+	  for(int r=0; r<ranges; r++)
+	    {
+	      sa += partial_adev[(a*ranges + r)*num_m + t];
+	      sm += partial_mdev[(a*ranges + r)*num_m + t];
+	    }
+
+	  AllanPoint& p = out[a][t];
+	  p.m = m[t];
+	  p.tau = m[t]/hz;
+	  p.num = P - 2*m[t];
+	  p.adev = (flags & ALLAN_ADEV) ? sqrt(sa/(2.0*p.tau*p.tau*(P - 2*m[t]))) : 0.0;
+	  p.mdev = (flags & ALLAN_MDEV) ? sqrt(sm/(2.0*(double) m[t]*m[t]*p.tau*p.tau*(P - 3*m[t] + 1))) : 0.0;
+	}
+    }
+
+  return (int) num_m;
+
+}
+
+int allan_deviation(const double* x, size_t n, double hz, const std::vector<uint64_t>& m,
+		    std::vector<AllanPoint>& out, int flags, int num_threads)
+{
+
+  return allan_run(&x, 1, n, hz, m, &out, flags, num_threads);
+
+}
+
+int allan_deviation(const ImuBatchView& w, ImuVec v, double hz, const std::vector<uint64_t>& m,
+		    std::vector<AllanPoint> out[3], int flags, int num_threads)
+{
+
+  const double* x[3] = {w.axis[3*v], w.axis[3*v + 1], w.axis[3*v + 2]};
+
+  return allan_run(x, 3, w.size, hz, m, out, flags, num_threads);
+
+}
+
+AllanStream::AllanStream(double hz_, const std::vector<uint64_t>& m_, int flags_)
+  : hz(hz_), flags(flags_)
+{
+
+  for(size_t t=0; t<m_.size(); t++)
+    if(m_[t] >= 1)
+      m.push_back(m_[t]);
+  std::sort(m.begin(), m.end());
+  m.erase(std::unique(m.begin(), m.end()), m.end());
+
+  const uint64_t need = 3*(m.empty() ? 1 : m.back()) + 1;
+  uint64_t cap = 1;
+  while(cap < need)
+    cap <<= 1;
+
+  theta.resize(cap);
+  mask = cap - 1;
+  sum_adev.resize(m.size());
+  sum_mdev.resize(m.size());
+  window.resize(m.size());
+
+  reset();
+
+}
+
+void AllanStream::reset(void)
+{
+
+  num = 0;
+  offset = 0.0;
+  theta_last = 0.0;
+  theta[0] = 0.0;
+  std::fill(sum_adev.begin(), sum_adev.end(), 0.0);
+  std::fill(sum_mdev.begin(), sum_mdev.end(), 0.0);
+  std::fill(window.begin(), window.end(), 0.0);
+
+}
+
+void AllanStream::add(const double* x, size_t n)
+{
+
+  const double* th = &theta[0];
+
+  for(size_t i=0; i<n; i++)
+    {
+      if(num == 0)
+	offset = x[i];
+
+      theta_last += (x[i] - offset)/hz;
+      num++;
+      theta[num & mask] = theta_last;
+
+      // newest point p = num: d_k with k = p - 2m, and d_{k-m} to drop
+      const uint64_t p = num;
+      for(size_t t=0; t<m.size(); t++)
+	{
+	  const uint64_t mt = m[t];
+	  if(p < 2*mt)
+	    break;
+
+	  const uint64_t k = p - 2*mt;
+	  const double d = th[p & mask] - 2.0*th[(p - mt) & mask] + th[k & mask];
+	  sum_adev[t] += d*d;
+
+	  if(flags & ALLAN_MDEV)
+	    {
+	      double s = window[t] + d;
+	      if(k >= mt)
+		s -= th[(p - mt) & mask] - 2.0*th[k & mask] + th[(k - mt) & mask];
+	      if(k + 1 >= mt)
+		sum_mdev[t] += s*s;
+	      window[t] = s;
+	    }
+	}
+    }
+
+}
+
+void AllanStream::result(std::vector<AllanPoint>& out) const
+{
+
+  const uint64_t P = num + 1;
+
+  out.clear();
+
+  for(size_t t=0; t<m.size() && 3*m[t]<=num; t++)
+    {
+      AllanPoint p;
+      p.m = m[t];
+      p.tau = m[t]/hz;
+      p.num = P - 2*m[t];
+      p.adev = (flags & ALLAN_ADEV) ? sqrt(sum_adev[t]/(2.0*p.tau*p.tau*(P - 2*m[t]))) : 0.0;
+      p.mdev = (flags & ALLAN_MDEV) ? sqrt(sum_mdev[t]/(2.0*(double) m[t]*m[t]*p.tau*p.tau*(P - 3*m[t] + 1))) : 0.0;
+      out.push_back(p);
+    }
+
+}
@@ -0,0 +1,729 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of binlog.h.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/log.h>
+#include <helper_funcs/trace.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define KVH_SYNC0        0xFE
+#define KVH_SYNC1        0x81
+#define KVH_SYNC2        0xFF
+#define KVH_SYNC3_NORMAL 0x55
+#define KVH_SYNC3_MAG    0x56
+#define KVH_LEN_NORMAL   36
+#define KVH_LEN_MAG      48
+
+#define MIP_SYNC0        0x75
+#define MIP_SYNC1        0x65
+#define MIP_DESC_IMU     0x80
+#define MIP_FIELD_ACC    0x04
+#define MIP_FIELD_GYRO   0x05
+#define MIP_FIELD_MAG    0x06
+#define MIP_FIELD_GPS    0x12
+#define MIP_FIELD_PRESS  0x17
+
+#define PHINS_SYNC0      'I'
+#define PHINS_SYNC1      'X'
+#define PHINS_NAV_RATE_BIT  5     /* rotation rate, vessel frame */
+#define PHINS_NAV_ACC_BIT   6     /* acceleration, vessel frame */
+#define PHINS_NAV_RATE   (1u << PHINS_NAV_RATE_BIT)
+#define PHINS_NAV_ACC    (1u << PHINS_NAV_ACC_BIT)
+
+// STDBIN navigation block sizes for bits 0-6: attitude, attitude std dev,
+// real-time heave/surge/sway, smart heave, heading/roll/pitch rate,
+// rotation rate (vessel frame), acceleration (vessel frame)
+static const size_t phins_nav_bytes[PHINS_NAV_ACC_BIT + 1] = {12, 12, 16, 8, 12, 12, 12};
+
+
+static inline uint16_t get_be16(const uint8_t* p)
+{
+  return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t get_be32(const uint8_t* p)
+{
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return __builtin_bswap32(v);
+}
+
+static inline float get_be_float(const uint8_t* p)
+{
+  uint32_t u = get_be32(p);
+  float f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+static inline double get_be_double(const uint8_t* p)
+{
+  uint64_t u;
+  memcpy(&u, p, 8);
+  u = __builtin_bswap64(u);
+  double d;
+  memcpy(&d, &u, 8);
+  return d;
+}
+
+static inline void put_be16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t) (v >> 8);
+  p[1] = (uint8_t) v;
+}
+
+static inline void put_be32(uint8_t* p, uint32_t v)
+{
+  v = __builtin_bswap32(v);
+  memcpy(p, &v, 4);
+}
+
+static inline void put_be_float(uint8_t* p, double x)
+{
+  float f = (float) x;
+  uint32_t u;
+  memcpy(&u, &f, 4);
+  put_be32(p, u);
+}
+
+static inline void put_be_double(uint8_t* p, double x)
+{
+  uint64_t u;
+  memcpy(&u, &x, 8);
+  u = __builtin_bswap64(u);
+  memcpy(p, &u, 8);
+}
+
+
+// slicing-by-4 tables for the MSB-first CRC-32 (poly 0x04C11DB7)
+struct Crc32Tables
+{
+  uint32_t t[4][256];
+
+  Crc32Tables(void)
+  {
+    for(uint32_t i=0; i<256; i++)
+      {
+	uint32_t c = i << 24;
+	for(int k=0; k<8; k++)
+	  c = (c & 0x80000000u) ? (c << 1) ^ 0x04C11DB7u : (c << 1);
+	t[0][i] = c;
+      }
+    for(int j=1; j<4; j++)
+      for(int i=0; i<256; i++)
+	t[j][i] = (t[j-1][i] << 8) ^ t[0][t[j-1][i] >> 24];
+  }
+};
+
+static const Crc32Tables crc32_tables;
+
+
+uint32_t binlog_crc32_kvh(const uint8_t* data, size_t len)
+{
+
+  const uint32_t (*t)[256] = crc32_tables.t;
+  uint32_t crc = 0xFFFFFFFFu;
+
+  while(len >= 4)
+    {
+      crc ^= get_be32(data);
+      crc = t[3][crc >> 24] ^ t[2][(crc >> 16) & 0xFF] ^ t[1][(crc >> 8) & 0xFF] ^ t[0][crc & 0xFF];
+      data += 4;
+      len  -= 4;
+    }
+
+  while(len-- > 0)
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data++];
+
+  return crc;
+
+}
+
+// Microstrain checksum: two running 8-bit sums
+static uint16_t mip_checksum(const uint8_t* p, size_t len)
+{
+
+  uint8_t ck1 = 0;
+  uint8_t ck2 = 0;
+
+  for(size_t i=0; i<len; i++)
+    {
+      ck1 += p[i];
+      ck2 += ck1;
+    }
+
+  return (uint16_t) ((ck1 << 8) | ck2);
+
+}
+
+// PHINS checksum: 32-bit sum of all bytes
+static uint32_t phins_checksum(const uint8_t* p, size_t len)
+{
+
+  uint32_t sum = 0;
+
+  for(size_t i=0; i<len; i++)
+    sum += p[i];
+
+  return sum;
+
+}
+
+
+int MappedFile::open(const char* filename)
+{
+
+  close();
+
+  fd = ::open(filename, O_RDONLY);
+  if(fd < 0)
+    return -1;
+
+  struct stat sb;
+  if(fstat(fd, &sb) != 0)
+    {
+      close();
+      return -1;
+    }
+
+  len = (size_t) sb.st_size;
+  if(len == 0)
+    return 0;
+
+  void* p = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(p == MAP_FAILED)
+    {
+      len = 0;
+      close();
+      return -1;
+    }
+
+  madvise(p, len, MADV_SEQUENTIAL);
+  ptr = (const uint8_t*) p;
+
+  return 0;
+
+}
+
+void MappedFile::close(void)
+{
+
+  if(ptr != NULL)
+    munmap((void*) ptr, len);
+  if(fd >= 0)
+    ::close(fd);
+
+  ptr = NULL;
+  len = 0;
+  fd  = -1;
+
+}
+
+
+BinlogParser::BinlogParser(int format, double hz)
+  : fmt(format), dt(hz > 0.0 ? 1.0/hz : 0.0), t_next(0.0)
+{
+
+  memset(&st, 0, sizeof(st));
+
+}
+
+// append one zeroed sample and return its index
+size_t BinlogParser::emit(ImuBatch& out)
+{
+
+  const size_t j = out.size();
+
+  out.resize(j + 1);
+
+  for(int v=0; v<3; v++)
+    for(int k=0; k<3; k++)
+      out.axis((ImuVec) v, k)[j] = 0.0;
+  out.t()[j]  = t_next;
+  out.dt()[j] = dt;
+  out.seq_num()[j] = 0;
+  out.fluid_pressure()[j] = 0.0f;
+
+  st.samples++;
+
+  return j;
+
+}
+
+long BinlogParser::frame_kvh(const uint8_t* p, size_t avail, ImuBatch* out_ptr)
+{
+
+  if(avail < 4)
+    return 0;
+
+  if(p[1] != KVH_SYNC1 || p[2] != KVH_SYNC2)
+    return -1;
+
+  bool with_mag;
+  if(p[3] == KVH_SYNC3_NORMAL)
+    with_mag = false;
+  else if(p[3] == KVH_SYNC3_MAG)
+    with_mag = true;
+  else
+    return -1;
+
+  const size_t len = with_mag ? KVH_LEN_MAG : KVH_LEN_NORMAL;
+  if(avail < len)
+    return 0;
+
+  if(binlog_crc32_kvh(p, len - 4) != get_be32(p + len - 4))
+    {
+      if(out_ptr != NULL)
+	st.bad_checksum++;
+      return -1;
+    }
+
+  if(out_ptr == NULL)
+    return (long) len;
+  ImuBatch& out = *out_ptr;
+
+  st.untimed_leading++;
+  const size_t j = emit(out);
+
+  for(int k=0; k<3; k++)
+    {
+      out.axis(IMU_ANG, k)[j] = get_be_float(p + 4 + 4*k);
+      out.axis(IMU_ACC, k)[j] = get_be_float(p + 16 + 4*k);
+      if(with_mag)
+	out.axis(IMU_MAG, k)[j] = get_be_float(p + 28 + 4*k);
+    }
+
+  // status byte precedes the sequence number
+  out.seq_num()[j] = p[len - 7];
+
+  t_next += dt;
+
+  return (long) len;
+
+}
+
+long BinlogParser::frame_mst(const uint8_t* p, size_t avail, ImuBatch* out_ptr)
+{
+
+  if(avail < 4)
+    return 0;
+
+  if(p[1] != MIP_SYNC1)
+    return -1;
+
+  const size_t payload = p[3];
+  const size_t len = 4 + payload + 2;
+  if(avail < len)
+    return 0;
+
+  if(mip_checksum(p, 4 + payload) != get_be16(p + 4 + payload))
+    {
+      if(out_ptr != NULL)
+	st.bad_checksum++;
+      return -1;
+    }
+
+  // other descriptor sets (e.g. filter data) are framed but not decoded
+  if(out_ptr == NULL || p[2] != MIP_DESC_IMU)
+    return (long) len;
+  ImuBatch& out = *out_ptr;
+
+  const uint8_t* f   = p + 4;
+  const uint8_t* end = f + payload;
+  const uint8_t* acc  = NULL;
+  const uint8_t* gyro = NULL;
+  const uint8_t* mag  = NULL;
+  const uint8_t* press = NULL;
+  const uint8_t* gps  = NULL;
+
+  while(f + 2 <= end)
+    {
+      const size_t flen = f[0];
+      if(flen < 2 || f + flen > end)
+	return -1;
+
+      switch(f[1])
+	{
+	case MIP_FIELD_ACC:   if(flen >= 14) acc   = f + 2; break;
+	case MIP_FIELD_GYRO:  if(flen >= 14) gyro  = f + 2; break;
+	case MIP_FIELD_MAG:   if(flen >= 14) mag   = f + 2; break;
+	case MIP_FIELD_PRESS: if(flen >= 6)  press = f + 2; break;
+	case MIP_FIELD_GPS:   if(flen >= 14) gps   = f + 2; break;
+	default: break;
+	}
+
+      f += flen;
+    }
+
+  if(acc == NULL && gyro == NULL)
+    return (long) len;
+
+  // MIP has no sequence number; number the samples as decoded
+  const int32_t seq = (int32_t) (st.samples & 0x7FFFFFFF);
+
+  if(gps != NULL)
+    {
+      const double t = get_be_double(gps);
+      if(st.samples > 0)
+	dt = t - (t_next - dt);  // t_next - dt is the previous sample time
+      t_next = t;
+    }
+  else if(st.untimed_leading == st.samples)
+    st.untimed_leading++;
+
+  const size_t j = emit(out);
+
+  for(int k=0; k<3; k++)
+    {
+      if(gyro != NULL) out.axis(IMU_ANG, k)[j] = get_be_float(gyro + 4*k);
+      if(acc  != NULL) out.axis(IMU_ACC, k)[j] = get_be_float(acc + 4*k);
+      if(mag  != NULL) out.axis(IMU_MAG, k)[j] = get_be_float(mag + 4*k);
+    }
+  if(press != NULL)
+    out.fluid_pressure()[j] = get_be_float(press);
+  out.seq_num()[j] = seq;
+
+  t_next += dt;
+
+  return (long) len;
+
+}
+
+long BinlogParser::frame_phins(const uint8_t* p, size_t avail, ImuBatch* out_ptr)
+{
+
+  if(avail < 3)
+    return 0;
+
+  if(p[1] != PHINS_SYNC1)
+    return -1;
+
+  // v3 adds an extended navigation bitmask after the navigation bitmask
+  size_t hdr;
+  if(p[2] == 2)
+    hdr = 21;
+  else if(p[2] == 3)
+    hdr = 25;
+  else
+    return -1;
+
+  if(avail < hdr)
+    return 0;
+
+  const size_t len = get_be16(p + hdr - 10);
+  if(len < hdr + 4)
+    return -1;
+  if(avail < len)
+    return 0;
+
+  if(phins_checksum(p, len - 4) != get_be32(p + len - 4))
+    {
+      if(out_ptr != NULL)
+	st.bad_checksum++;
+      return -1;
+    }
+
+  if(out_ptr == NULL)
+    return (long) len;
+  ImuBatch& out = *out_ptr;
+
+  const uint32_t nav = get_be32(p + 3);
+  if((nav & (PHINS_NAV_RATE | PHINS_NAV_ACC)) == 0)
+    return (long) len;
+
+  // blocks follow in bit order, so skip every block present below the
+  // rotation rate one
+  size_t off = hdr;
+  for(int b=0; b<PHINS_NAV_RATE_BIT; b++)
+    if(nav & (1u << b))
+      off += phins_nav_bytes[b];
+  size_t need = off;
+  if(nav & PHINS_NAV_RATE)
+    need += phins_nav_bytes[PHINS_NAV_RATE_BIT];
+  if(nav & PHINS_NAV_ACC)
+    need += phins_nav_bytes[PHINS_NAV_ACC_BIT];
+  if(need > len - 4)
+    return -1;
+
+  // validity time in 100 us steps
+  const double t = 1e-4*get_be32(p + hdr - 8);
+  if(st.samples > 0)
+    dt = t - (t_next - dt);
+  t_next = t;
+
+  const size_t j = emit(out);
+
+  if(nav & PHINS_NAV_RATE)
+    {
+      for(int k=0; k<3; k++)
+	out.axis(IMU_ANG, k)[j] = get_be_float(p + off + 4*k)*(M_PI/180.0);
+      off += phins_nav_bytes[PHINS_NAV_RATE_BIT];
+    }
+  if(nav & PHINS_NAV_ACC)
+    for(int k=0; k<3; k++)
+      out.axis(IMU_ACC, k)[j] = get_be_float(p + off + 4*k);
+
+  out.seq_num()[j] = (int32_t) get_be32(p + hdr - 4);
+
+  t_next += dt;
+
+  return (long) len;
+
+}
+
+const uint8_t* BinlogParser::find_sync(const uint8_t* p, const uint8_t* end) const
+{
+
+  uint8_t sync0;
+  uint8_t sync1;
+
+  switch(fmt)
+    {
+    case BINLOG_FORMAT_KVH:   sync0 = KVH_SYNC0;   sync1 = KVH_SYNC1;   break;
+    case BINLOG_FORMAT_MST:   sync0 = MIP_SYNC0;   sync1 = MIP_SYNC1;   break;
+    case BINLOG_FORMAT_PHINS: sync0 = PHINS_SYNC0; sync1 = PHINS_SYNC1; break;
+    default: return NULL;
+    }
+
+  for(;;)
+    {
+      p = (const uint8_t*) memchr(p, sync0, end - p);
+      if(p == NULL || p + 1 >= end || p[1] == sync1)
+	return p;
+      p++;
+    }
+
+}
+
+long BinlogParser::frame(const uint8_t* p, size_t avail, ImuBatch* out)
+{
+
+  switch(fmt)
+    {
+    case BINLOG_FORMAT_KVH: return frame_kvh(p, avail, out);
+    case BINLOG_FORMAT_MST: return frame_mst(p, avail, out);
+    default:                return frame_phins(p, avail, out);
+    }
+
+}
+
+size_t BinlogParser::next_frame(const uint8_t* data, size_t size)
+{
+
+  const uint8_t* end = data + size;
+  const uint8_t* p = data;
+
+  while((p = find_sync(p, end)) != NULL)
+    {
+      if(frame(p, end - p, NULL) > 0)
+	return p - data;
+      p++;
+    }
+
+  return size;
+
+}
+
+size_t BinlogParser::parse(const uint8_t* data, size_t size, ImuBatch& out, bool final)
+{
+
+  TRACE_SPAN("binlog", "BinlogParser::parse");
+  const uint8_t* end = data + size;
+  size_t pos = 0;
+
+  while(pos < size)
+    {
+      const uint8_t* p = find_sync(data + pos, end);
+
+      if(p == NULL)
+	{
+	  st.resync_bytes += size - pos;
+	  return size;
+	}
+
+      st.resync_bytes += (p - data) - pos;
+      pos = p - data;
+
+      const long n = frame(p, size - pos, &out);
+
+      if(n > 0)
+	{
+	  st.frames++;
+	  pos += n;
+	}
+      else if(n == 0 && !final)
+	{
+	  // incomplete frame; leave it for the next call
+	  return pos;
+	}
+      else
+	{
+	  // bad or truncated frame: resync one byte on
+	  st.resync_bytes++;
+	  pos++;
+	}
+    }
+
+  return pos;
+
+}
+
+
+int binlog_format_from_filename(const char* filename)
+{
+
+  const char* dot = strrchr(filename, '.');
+  if(dot == NULL)
+    return BINLOG_FORMAT_UNKNOWN;
+
+  if(strcmp(dot + 1, LOG_FID_KVH_BINARY_SUFFIX) == 0)
+    return BINLOG_FORMAT_KVH;
+  if(strcmp(dot + 1, LOG_FID_MST_BINARY_SUFFIX) == 0)
+    return BINLOG_FORMAT_MST;
+  if(strcmp(dot + 1, LOG_FID_PHINS_BINARY_SUFFIX) == 0)
+    return BINLOG_FORMAT_PHINS;
+
+  return BINLOG_FORMAT_UNKNOWN;
+
+}
+
+long binlog_parse_file(const char* filename, ImuBatch& out, BinlogStats* stats, double hz, int format)
+{
+
+  if(format == BINLOG_FORMAT_UNKNOWN)
+    format = binlog_format_from_filename(filename);
+  if(format == BINLOG_FORMAT_UNKNOWN)
+    return -1;
+
+  MappedFile f;
+  if(f.open(filename) != 0)
+    return -1;
+
+  BinlogParser parser(format, hz);
+  const size_t before = out.size();
+
+  parser.parse(f.data(), f.size(), out, true);
+
+  if(stats != NULL)
+    *stats = parser.stats();
+
+  return (long) (out.size() - before);
+
+}
+
+
+int binlog_encode_kvh(const ImuPacket& pkt, bool with_mag, uint8_t* buf)
+{
+
+  const int len = with_mag ? KVH_LEN_MAG : KVH_LEN_NORMAL;
+
+  buf[0] = KVH_SYNC0;
+  buf[1] = KVH_SYNC1;
+  buf[2] = KVH_SYNC2;
+  buf[3] = with_mag ? KVH_SYNC3_MAG : KVH_SYNC3_NORMAL;
+
+  uint8_t* p = buf + 4;
+  for(int k=0; k<3; k++, p+=4)
+    put_be_float(p, pkt.ang(k));
+  for(int k=0; k<3; k++, p+=4)
+    put_be_float(p, pkt.acc(k));
+  if(with_mag)
+    for(int k=0; k<3; k++, p+=4)
+      put_be_float(p, pkt.mag(k));
+
+  *p++ = 0x77;                          // all sensors valid
+  *p++ = (uint8_t) (pkt.seq_num & 0x7F);
+  put_be16(p, 25);                      // temperature, deg C
+  p += 2;
+
+  put_be32(p, binlog_crc32_kvh(buf, len - 4));
+
+  return len;
+
+}
+
+int binlog_encode_mst(const ImuPacket& pkt, uint8_t* buf, bool with_gps)
+{
+
+  uint8_t* p = buf + 4;
+
+  const uint8_t vec_fields[3] = {MIP_FIELD_ACC, MIP_FIELD_GYRO, MIP_FIELD_MAG};
+  const Eigen::Vector3d* vecs[3] = {&pkt.acc, &pkt.ang, &pkt.mag};
+
+  for(int v=0; v<3; v++)
+    {
+      *p++ = 14;
+      *p++ = vec_fields[v];
+      for(int k=0; k<3; k++, p+=4)
+	put_be_float(p, (*vecs[v])(k));
+    }
+
+  *p++ = 6;
+  *p++ = MIP_FIELD_PRESS;
+  put_be_float(p, pkt.fluid_pressure);
+  p += 4;
+
+  if(with_gps)
+    {
+      *p++ = 14;
+      *p++ = MIP_FIELD_GPS;
+      put_be_double(p, pkt.t);
+      put_be16(p + 8, 0);               // week
+      put_be16(p + 10, 0);              // flags
+      p += 12;
+    }
+
+  const int payload = (int) (p - buf) - 4;
+
+  buf[0] = MIP_SYNC0;
+  buf[1] = MIP_SYNC1;
+  buf[2] = MIP_DESC_IMU;
+  buf[3] = (uint8_t) payload;
+
+  put_be16(p, mip_checksum(buf, 4 + payload));
+
+  return 4 + payload + 2;
+
+}
+
+int binlog_encode_phins(const ImuPacket& pkt, uint8_t* buf)
+{
+
+  const int hdr = 21;
+  const int len = hdr + 24 + 4;
+
+  buf[0] = PHINS_SYNC0;
+  buf[1] = PHINS_SYNC1;
+  buf[2] = 2;
+  put_be32(buf + 3, PHINS_NAV_RATE | PHINS_NAV_ACC);
+  put_be32(buf + 7, 0);
+  put_be16(buf + 11, len);
+  put_be32(buf + 13, (uint32_t) llround(pkt.t*1e4));
+  put_be32(buf + 17, (uint32_t) pkt.seq_num);
+
+  for(int k=0; k<3; k++)
+    put_be_float(buf + hdr + 4*k, pkt.ang(k)*(180.0/M_PI));
+  for(int k=0; k<3; k++)
+    put_be_float(buf + hdr + 12 + 4*k, pkt.acc(k));
+
+  put_be32(buf + len - 4, phins_checksum(buf, len - 4));
+
+  return len;
+
+}
@@ -0,0 +1,565 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of config_parse.h, and of load_params().
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <helper_funcs/config_parse.h>
+#include <helper_funcs/thread_pool.h>
+#include <helper_funcs/trace.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define CONFIG_HASH_SLOTS 64    // power of two, at least the number of fields
+#define CONFIG_HASH_SEED  351u  // picked so the schema's names do not collide
+#define CONFIG_HASH_BASIS (2166136261u ^ CONFIG_HASH_SEED)
+#define CONFIG_MAX_VALUE  1024  // longest value (units: bytes)
+
+// typed handlers: parse a NUL-terminated value into one member, which
+// is left as it was if the value does not parse
+
+// nothing but spaces after a number
+static bool config_blank(const char* s)
+{
+
+  while(*s == ' ' || *s == '\t')
+    s++;
+
+  return *s == '\0';
+
+}
+
+template<int config_params::*M>
+static bool config_set_int(config_params& params, const char* val)
+{
+
+  char* end;
+  errno = 0;
+  const long x = strtol(val, &end, 10);
+  if(end == val || !config_blank(end) || errno == ERANGE || x < INT_MIN || x > INT_MAX)
+    return false;
+  params.*M = (int) x;
+
+  return true;
+
+}
+
+template<float config_params::*M>
+static bool config_set_degrees(config_params& params, const char* val)
+{
+
+  char* end;
+  const float x = strtof(val, &end);
+  if(end == val || !config_blank(end))
+    return false;
+  params.*M = x*M_PI/180.0;
+
+  return true;
+
+}
+
+template<std::string config_params::*M>
+static bool config_set_string(config_params& params, const char* val)
+{
+
+  std::string& str = params.*M;
+  str.assign(val);
+  str.erase(std::remove(str.begin(), str.end(), '\"'), str.end());
+
+  return true;
+
+}
+
+// "[a,b,c]", spaces allowed
+static bool config_vec3(const char* val, Eigen::Vector3d& v)
+{
+
+  const char* s = val;
+  while(*s == ' ' || *s == '\t')
+    s++;
+  if(*s++ != '[')
+    return false;
+
+  for(int i=0; i<3; i++)
+    {
+      char* end;
+      v(i) = strtod(s, &end);
+      if(end == s)
+	return false;
+      s = end;
+      while(*s == ' ' || *s == '\t')
+	s++;
+      if(*s++ != ((i < 2) ? ',' : ']'))
+	return false;
+    }
+
+  return config_blank(s);
+
+}
+
+template<Eigen::Vector3d config_params::*M>
+static bool config_set_vec3(config_params& params, const char* val)
+{
+
+  Eigen::Vector3d v;
+  if(!config_vec3(val, v))
+    return false;
+  params.*M = v;
+
+  return true;
+
+}
+
+template<Eigen::Matrix3d config_params::*M>
+static bool config_set_diag3(config_params& params, const char* val)
+{
+
+  Eigen::Vector3d v;
+  if(!config_vec3(val, v))
+    return false;
+  params.*M = v.asDiagonal();
+
+  return true;
+
+}
+
+template<Eigen::Matrix3d config_params::*M>
+static bool config_set_rpy(config_params& params, const char* val)
+{
+
+  Eigen::Vector3d v;
+  if(!config_vec3(val, v))
+    return false;
+  params.*M = rpy2rot(v);
+
+  return true;
+
+}
+
+// the schema
+
+typedef bool (*ConfigHandler)(config_params& params, const char* val);
+
+struct ConfigField
+{
+
+  const char* name;
+  bool required;
+  ConfigHandler set;
+
+};
+
+static constexpr ConfigField config_fields[] =
+  {
+    {"hz",           true,  &config_set_int<&config_params::hz>},
+    {"rate",         false, &config_set_int<&config_params::rate>},
+    {"baud",         false, &config_set_int<&config_params::baud>},
+    {"lat",          true,  &config_set_degrees<&config_params::lat>},
+    {"o_file",       false, &config_set_string<&config_params::o_file>},
+    {"i_file",       false, &config_set_string<&config_params::i_file>},
+    {"last_mod",     false, &config_set_string<&config_params::last_mod>},
+    {"port",         false, &config_set_string<&config_params::port>},
+    {"log_location", false, &config_set_string<&config_params::log_location>},
+    {"frameId",      false, &config_set_string<&config_params::frameId>},
+    {"k_acc",        true,  &config_set_diag3<&config_params::K_acc>},
+    {"k_mag",        true,  &config_set_diag3<&config_params::K_mag>},
+    {"k_ang_bias",   true,  &config_set_diag3<&config_params::K_ang_bias>},
+    {"k_acc_bias",   true,  &config_set_diag3<&config_params::K_acc_bias>},
+    {"k_mag_bias",   true,  &config_set_diag3<&config_params::K_mag_bias>},
+    {"k_E_n",        true,  &config_set_diag3<&config_params::K_E_n>},
+    {"k_g",          true,  &config_set_diag3<&config_params::K_g>},
+    {"k_north",      true,  &config_set_diag3<&config_params::K_north>},
+    {"rpy_align",    true,  &config_set_rpy<&config_params::R_align>},
+    {"rpy_ro",       true,  &config_set_rpy<&config_params::R0>},
+    {"ang_bias",     true,  &config_set_vec3<&config_params::ang_bias>},
+    {"acc_bias",     true,  &config_set_vec3<&config_params::acc_bias>},
+    {"mag_bias",     true,  &config_set_vec3<&config_params::mag_bias>},
+    {"acc_hat",      false, &config_set_vec3<&config_params::acc_hat>},
+    {"w_E_north",    false, &config_set_vec3<&config_params::w_E_north>},
+  };
+
+static constexpr size_t CONFIG_NUM_FIELDS = sizeof(config_fields)/sizeof(config_fields[0]);
+
+// FNV-1a, at compile time over a NUL-terminated name
+static constexpr uint32_t config_hash_c(const char* s, uint32_t h)
+{
+
+  return *s ? config_hash_c(s + 1, (h ^ (uint8_t) *s)*16777619u) : h;
+
+}
+
+static constexpr int config_slot_c(const char* s)
+{
+
+  return (int) ((config_hash_c(s, CONFIG_HASH_BASIS) >> 8) & (CONFIG_HASH_SLOTS - 1));
+
+}
+
+static constexpr bool config_distinct(size_t i, size_t j)
+{
+
+  return j >= CONFIG_NUM_FIELDS ||
+    (config_slot_c(config_fields[i].name) != config_slot_c(config_fields[j].name) && config_distinct(i, j + 1));
+
+}
+
+static constexpr bool config_perfect(size_t i)
+{
+
+  return i >= CONFIG_NUM_FIELDS || (config_distinct(i, i + 1) && config_perfect(i + 1));
+
+}
+
+static_assert(CONFIG_NUM_FIELDS <= 64, "the seen mask in config_parse() holds 64 fields");
+static_assert(config_perfect(0), "config field names collide in the hash table: change CONFIG_HASH_SEED");
+
+// the same hash at run time, over a key that is not NUL-terminated
+static inline int config_slot(const char* s, size_t n)
+{
+
+  uint32_t h = CONFIG_HASH_BASIS;
+  for(size_t i=0; i<n; i++)
+    h = (h ^ (uint8_t) s[i])*16777619u;
+
+  return (int) ((h >> 8) & (CONFIG_HASH_SLOTS - 1));
+
+}
+
+struct ConfigSlots
+{
+
+  int8_t field[CONFIG_HASH_SLOTS];
+  uint8_t len[CONFIG_HASH_SLOTS];
+
+  ConfigSlots(void)
+  {
+    memset(field, -1, sizeof(field));
+    for(size_t i=0; i<CONFIG_NUM_FIELDS; i++)
+      {
+	const int slot = config_slot_c(config_fields[i].name);
+	field[slot] = (int8_t) i;
+	len[slot] = (uint8_t) strlen(config_fields[i].name);
+      }
+  }
+
+};
+
+static int config_find(const char* key, size_t n)
+{
+
+  static const ConfigSlots slots;
+  const int slot = config_slot(key, n);
+  const int f = slots.field[slot];
+
+  if(f < 0 || slots.len[slot] != n || memcmp(config_fields[f].name, key, n) != 0)
+    return -1;
+
+  return f;
+
+}
+
+// known key within two edits of an unknown one, or NULL
+static const char* config_nearest(const char* key, size_t n)
+{
+
+  const char* best = NULL;
+  int best_d = 3;
+
+  if(n > 32)
+    return NULL;
+
+  for(size_t f=0; f<CONFIG_NUM_FIELDS; f++)
+    {
+      const char* name = config_fields[f].name;
+      const size_t m = strlen(name);
+      int d[33][33];
+
+      for(size_t i=0; i<=n; i++)
+	d[i][0] = (int) i;
+      for(size_t j=0; j<=m; j++)
+	d[0][j] = (int) j;
+      for(size_t i=1; i<=n; i++)
+	for(size_t j=1; j<=m; j++)
+	  d[i][j] = std::min(std::min(d[i-1][j] + 1, d[i][j-1] + 1), d[i-1][j-1] + (key[i-1] != name[j-1]));
+
+      if(d[n][m] < best_d)
+	{
+	  best_d = d[n][m];
+	  best = name;
+	}
+    }
+
+  return best;
+
+}
+
+static void config_note(ConfigReport* report, int line, const char* fmt, ...)
+{
+
+  char buf[256];
+  int len = 0;
+  va_list ap;
+
+  if(!report)
+    return;
+
+  if(line > 0)
+    len = snprintf(buf, sizeof(buf), "line %d: ", line);
+  va_start(ap, fmt);
+  vsnprintf(buf + len, sizeof(buf) - len, fmt, ap);
+  va_end(ap);
+
+  report->text += buf;
+  report->text += '\n';
+
+}
+
+void config_params_defaults(config_params& params)
+{
+
+  // 2018-10-04 LLW added optional parameters to set ICs for acc_hat and w_E_north
+  // set these to sentinel values in case the user does not provide these parameters
+  // on the command line
+  Eigen::Vector3d sentinel(-100.0,-100.0,-100.0);
+  params.w_E_north = sentinel;
+  params.acc_hat   = sentinel;
+
+  // everything else starts out missing, so config_params_check() can tell
+  params.hz = 0;
+  params.rate = 0;
+  params.baud = 0;
+  params.lat = NAN;
+  params.o_file.clear();
+  params.i_file.clear();
+  params.last_mod.clear();
+  params.port.clear();
+  params.log_location.clear();
+  params.frameId.clear();
+  params.K_acc = params.K_mag = params.K_ang_bias = params.K_acc_bias = params.K_mag_bias =
+    params.K_E_n = params.K_g = params.K_north = params.R0 = params.R_align =
+    Eigen::Matrix3d::Constant(NAN);
+  params.ang_bias = params.acc_bias = params.mag_bias = Eigen::Vector3d::Constant(NAN);
+
+}
+
+int config_parse(const char* text, size_t len, config_params& params, ConfigReport* report)
+{
+
+  const char* p = text;
+  const char* const end = text + len;
+  uint64_t seen = 0;
+  int line = 0;
+  int bad = 0;
+  char val[CONFIG_MAX_VALUE];
+
+  config_params_defaults(params);
+
+  while(p < end)
+    {
+      const char* eol = (const char*) memchr(p, '\n', end - p);
+      if(!eol)
+	eol = end;
+      const char* s = p;
+      const char* e = eol;
+      p = (eol < end) ? eol + 1 : end;
+      line++;
+
+      // trim, skip blank lines and comments
+      while(s < e && (*s == ' ' || *s == '\t'))
+	s++;
+      while(e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r'))
+	e--;
+      if(s == e || *s == '#')
+	continue;
+
+      // key = value
+      const char* key = s;
+      while(s < e && *s != '=' && *s != ' ' && *s != '\t')
+	s++;
+      const size_t key_len = s - key;
+      while(s < e && (*s == ' ' || *s == '\t'))
+	s++;
+      if(s == e || *s != '=')
+	{
+	  bad++;
+	  if(report)
+	    report->malformed++;
+	  config_note(report, line, "no = after %.*s", (int) key_len, key);
+	  continue;
+	}
+      s++;
+      while(s < e && (*s == ' ' || *s == '\t'))
+	s++;
+
+      // a # after a space starts a comment ("hz = 100  # rate")
+      for(const char* c=s; c<e; c++)
+	if(*c == '#' && (c == s || c[-1] == ' ' || c[-1] == '\t'))
+	  {
+	    e = c;
+	    break;
+	  }
+      while(e > s && (e[-1] == ' ' || e[-1] == '\t'))
+	e--;
+
+      const int f = config_find(key, key_len);
+      if(f < 0)
+	{
+	  const char* near = config_nearest(key, key_len);
+	  if(report)
+	    report->unknown++;
+	  config_note(report, line, "unknown key %.*s%s%s%s", (int) key_len, key,
+		      near ? " (" : "", near ? near : "", near ? "?)" : "");
+	  continue;
+	}
+
+      if(seen & (1ULL << f))
+	{
+	  if(report)
+	    report->duplicate++;
+	  config_note(report, line, "%s given again, this one is used", config_fields[f].name);
+	}
+      seen |= 1ULL << f;
+
+      const size_t val_len = e - s;
+      bool ok = (val_len < sizeof(val));
+      if(ok)
+	{
+	  memcpy(val, s, val_len);
+	  val[val_len] = '\0';
+	  ok = config_fields[f].set(params, val);
+	}
+      if(!ok)
+	{
+	  bad++;
+	  if(report)
+	    report->malformed++;
+	  config_note(report, line, "bad value for %s: %.*s", config_fields[f].name, (int) std::min(val_len, (size_t) 64), s);
+	}
+    }
+
+  for(size_t f=0; f<CONFIG_NUM_FIELDS; f++)
+    if(config_fields[f].required && !(seen & (1ULL << f)))
+      {
+	bad++;
+	if(report)
+	  report->missing++;
+	config_note(report, 0, "missing %s", config_fields[f].name);
+      }
+
+  return bad ? -1 : 0;
+
+}
+
+int config_load(const char* config_file, config_params& params, ConfigReport* report)
+{
+
+  TRACE_SPAN("config", "config_load");
+  const int fd = open(config_file, O_RDONLY);
+  struct stat st;
+  std::vector<char> buf;
+  size_t len = 0;
+
+  if(fd >= 0 && fstat(fd, &st) == 0)
+    {
+      buf.resize(st.st_size + 1);
+      for(;;)
+	{
+	  const ssize_t n = read(fd, &buf[len], buf.size() - len);
+	  if(n <= 0)
+	    break;
+	  len += n;
+	  if(len == buf.size())
+	    buf.resize(2*buf.size());
+	}
+    }
+  if(fd >= 0)
+    close(fd);
+
+  if(fd < 0 || buf.empty())
+    {
+      config_params_defaults(params);
+      if(report)
+	report->malformed++;
+      config_note(report, 0, "cannot read %s", config_file);
+      return -1;
+    }
+
+  return config_parse(&buf[0], len, params, report);
+
+}
+
+int config_load_many(const std::vector<std::string>& config_files,
+		     std::vector<config_params>& params,
+		     std::vector<ConfigReport>* reports,
+		     int num_threads)
+{
+
+  const int n = (int) config_files.size();
+  std::vector<int> failed(n, 0);
+
+  params.resize(n);
+  if(reports)
+    reports->assign(n, ConfigReport());
+
+  WorkStealingPool pool(num_threads);
+  pool.parallel_for(n, [&](int i) {
+      failed[i] = (config_load(config_files[i].c_str(), params[i], reports ? &(*reports)[i] : NULL) < 0);
+    });
+
+  return (int) std::count(failed.begin(), failed.end(), 1);
+
+}
+
+void config_report_print(FILE* fp, const char* config_file, const ConfigReport& report)
+{
+
+  if(report.text.empty())
+    return;
+
+  fprintf(fp, "CONFIG FILE %s: %d unknown, %d missing, %d malformed, %d duplicate\n%s",
+	  config_file, report.unknown, report.missing, report.malformed, report.duplicate,
+	  report.text.c_str());
+
+}
+
+/**
+ *
+ * @brief Function for loading parameters from config_file.
+ *
+ * @param Config file to parse.
+ *
+ */
+config_params load_params(const char* config_file)
+{
+
+  printf("LOADING CONFIG FILE: %s\n",config_file);
+
+  config_params params;
+  ConfigReport report;
+
+  const int r = config_load(config_file, params, &report);
+  config_report_print(stdout, config_file, report);
+  if(r < 0)
+    printf("ERROR: CONFIG FILE %s: %d missing and %d malformed values are left unset\n",
+	   config_file, report.missing, report.malformed);
+
+  return params;
+
+}
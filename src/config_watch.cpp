@@ -0,0 +1,234 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of config_watch.h.
+ *
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <helper_funcs/config_watch.h>
+#include <helper_funcs/config_parse.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+// a rotation to within rounding of the printed angles
+static bool config_is_rotation(const Eigen::Matrix3d& R)
+{
+
+  return R.allFinite() &&
+    (R.transpose()*R - Eigen::Matrix3d::Identity()).norm() < 1e-6 && R.determinant() > 0.0;
+
+}
+
+int config_params_check(const config_params& params, char* why, size_t len)
+{
+
+  const char* problem = NULL;
+
+  if(params.hz <= 0)
+    problem = "hz missing or not positive";
+  else if(params.rate < 0 || params.rate > params.hz)
+    problem = "rate not in [0, hz]";
+  else if(params.baud < 0)
+    problem = "baud negative";
+  else if(!(fabs(params.lat) <= M_PI/2.0))
+    problem = "lat missing or not a latitude";
+  else if(!params.K_acc.allFinite())
+    problem = "k_acc missing or not finite";
+  else if(!params.K_mag.allFinite())
+    problem = "k_mag missing or not finite";
+  else if(!params.K_ang_bias.allFinite())
+    problem = "k_ang_bias missing or not finite";
+  else if(!params.K_acc_bias.allFinite())
+    problem = "k_acc_bias missing or not finite";
+  else if(!params.K_mag_bias.allFinite())
+    problem = "k_mag_bias missing or not finite";
+  else if(!params.K_E_n.allFinite())
+    problem = "k_E_n missing or not finite";
+  else if(!params.K_g.allFinite())
+    problem = "k_g missing or not finite";
+  else if(!params.K_north.allFinite())
+    problem = "k_north missing or not finite";
+  else if(!params.ang_bias.allFinite())
+    problem = "ang_bias missing or not finite";
+  else if(!params.acc_bias.allFinite())
+    problem = "acc_bias missing or not finite";
+  else if(!params.mag_bias.allFinite())
+    problem = "mag_bias missing or not finite";
+  else if(!config_is_rotation(params.R0))
+    problem = "rpy_ro missing or not a rotation";
+  else if(!config_is_rotation(params.R_align))
+    problem = "rpy_align missing or not a rotation";
+
+  if(problem && why && len > 0)
+    snprintf(why, len, "%s", problem);
+
+  return problem ? -1 : 0;
+
+}
+
+ConfigWatcher::ConfigWatcher(const char* config_file)
+  : path(config_file), cur(NULL), num_loads(0), num_rejected(0), stopping(false)
+{
+
+  // watch the directory: editors often replace the file by a rename
+  const size_t slash = path.rfind('/');
+  const std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+  name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+  inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if(inotify_fd >= 0 && inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+      close(inotify_fd);
+      inotify_fd = -1;
+    }
+
+  wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+}
+
+ConfigWatcher::~ConfigWatcher(void)
+{
+
+  stop();
+
+  for(size_t i=0; i<snapshots.size(); i++)
+    delete snapshots[i];
+
+  if(inotify_fd >= 0)
+    close(inotify_fd);
+  if(wake_fd >= 0)
+    close(wake_fd);
+
+}
+
+int ConfigWatcher::reload(void)
+{
+
+  std::lock_guard<std::mutex> lock(load_mutex);
+  char why[128];
+  ConfigReport report;
+
+  config_params* params = new config_params;
+
+  if(config_load(path.c_str(), *params, &report) < 0)
+    {
+      // the first problem with the file
+      const std::string first = report.text.substr(0, report.text.find('\n'));
+      snprintf(why, sizeof(why), "%s", first.c_str());
+    }
+  else if(config_params_check(*params, why, sizeof(why)) == 0)
+    why[0] = '\0';
+
+  if(why[0] != '\0')
+    {
+      printf("CONFIG FILE %s REJECTED: %s, keeping version %llu\n",
+	     path.c_str(), why, (unsigned long long) num_loads.load());
+      delete params;
+      num_rejected.fetch_add(1, std::memory_order_relaxed);
+      return -1;
+    }
+
+  // publish, then count, so a reader that sees the new version sees the params
+  snapshots.push_back(params);
+  cur.store(params, std::memory_order_release);
+  num_loads.fetch_add(1, std::memory_order_release);
+
+  return 0;
+
+}
+
+int ConfigWatcher::poll_once(int timeout_ms)
+{
+
+  if(inotify_fd < 0)
+    return -1;
+
+  pollfd fds[2];
+  fds[0].fd = inotify_fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = wake_fd;
+  fds[1].events = POLLIN;
+
+  const int n = poll(fds, 2, timeout_ms);
+  if(n <= 0)
+    return (n < 0 && errno != EINTR) ? -1 : 0;
+
+  if(fds[1].revents & POLLIN)
+    {
+      uint64_t count;
+      const ssize_t r = read(wake_fd, &count, sizeof(count));
+      (void) r;
+    }
+
+  // one reload however many events name the file
+  bool changed = false;
+  char buf[4096] __attribute__ ((aligned(__alignof__(inotify_event))));
+  for(;;)
+    {
+      const ssize_t len = read(inotify_fd, buf, sizeof(buf));
+      if(len <= 0)
+	break;
+
+      for(ssize_t off=0; off<len; )
+	{
+	  const inotify_event* ev = (const inotify_event*) (buf + off);
+	  if(ev->len > 0 && name == ev->name)
+	    changed = true;
+	  off += sizeof(inotify_event) + ev->len;
+	}
+    }
+
+  if(!changed)
+    return 0;
+
+  reload();
+
+  return 1;
+
+}
+
+int ConfigWatcher::start(void)
+{
+
+  if(thread.joinable() || inotify_fd < 0 || wake_fd < 0)
+    return -1;
+
+  stopping = false;
+  thread = std::thread([this]() {
+      while(!stopping.load(std::memory_order_relaxed))
+	if(poll_once(-1) < 0)
+	  break;
+    });
+
+  return 0;
+
+}
+
+void ConfigWatcher::stop(void)
+{
+
+  if(!thread.joinable())
+    return;
+
+  stopping = true;
+
+  const uint64_t one = 1;
+  const ssize_t r = write(wake_fd, &one, sizeof(one));
+  (void) r;
+
+  thread.join();
+
+}
@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of decimate.h.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <helper_funcs/decimate.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+// zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double decimate_bessel_i0(double x)
+{
+
+  double sum = 1.0;
+  double term = 1.0;
+
+  for(int k=1; k<50; k++)
+    {
+      term *= (0.5*x/k)*(0.5*x/k);
+      sum += term;
+      if(term < 1e-17*sum)
+	break;
+    }
+
+  return sum;
+
+}
+
+Decimator::Decimator(double hz_, double rate, int taps_per_phase, double atten_db)
+  : hz(hz_)
+{
+
+  M = (rate > 0.0) ? std::max(1, (int) lround(hz/rate)) : 1;
+  design(taps_per_phase, atten_db);
+  reset();
+
+}
+
+Decimator::Decimator(const config_params& params, int taps_per_phase, double atten_db)
+  : hz(params.hz)
+{
+
+  M = (params.rate > 0) ? std::max(1, (int) lround((double) params.hz/params.rate)) : 1;
+  design(taps_per_phase, atten_db);
+  reset();
+
+}
+
+void Decimator::design(int taps_per_phase, double atten_db)
+{
+
+  if(M == 1)
+    {
+      Q = 1;
+      h.assign(1, 1.0);
+      return;
+    }
+
+  Q = std::max(2, taps_per_phase);
+  const int N = Q*M;
+
+  // Kaiser: transition width for this length and attenuation, with the
+  // stopband starting at the output Nyquist frequency (units: cycles/sample)
+  const double A = std::max(atten_db, 21.0);
+  const double transition = (A - 7.95)/(14.36*(N - 1));
+  const double stop = 0.5/M;
+  const double fc = std::max(stop - 0.5*transition, 0.5*stop);
+  const double beta = (A > 50.0) ? 0.1102*(A - 8.7) : 0.5842*pow(A - 21.0, 0.4) + 0.07886*(A - 21.0);
+
+  const double center = 0.5*(N - 1);
+  const double i0_beta = decimate_bessel_i0(beta);
+  double sum = 0.0;
+
+  h.resize(N);
+  for(int k=0; k<N; k++)
+    {
+      const double x = k - center;
+      const double r = x/center;
+      const double sinc = (x == 0.0) ? 2.0*fc : sin(2.0*M_PI*fc*x)/(M_PI*x);
+      h[k] = sinc*decimate_bessel_i0(beta*sqrt(std::max(0.0, 1.0 - r*r)))/i0_beta;
+      sum += h[k];
+    }
+
+  for(int k=0; k<N; k++)
+    h[k] /= sum;
+
+  work.reserve(N + M + DECIMATE_BLOCK*M);
+  phase.reserve(M*(DECIMATE_BLOCK + Q));
+  for(int a=0; a<9; a++)
+    hist[a].reserve(N + M);
+
+}
+
+void Decimator::reset(void)
+{
+
+  primed = false;
+  pending = 0;
+  t_prev = NAN;
+
+}
+
+size_t Decimator::process(const ImuBatchView& in, ImuBatch& out)
+{
+
+  const size_t block = (size_t) DECIMATE_BLOCK*M;
+  size_t num = 0;
+
+  for(size_t off=0; off<in.size; off+=block)
+    num += process_block(in.sub(off, std::min(block, in.size - off)), out);
+
+  return num;
+
+}
+
+size_t Decimator::process_block(const ImuBatchView& in, ImuBatch& out)
+{
+
+  const size_t n = in.size;
+  const size_t old = out.size();
+
+  if(n == 0)
+    return 0;
+
+  if(M == 1)
+    {
+      out.resize(old + n);
+      for(int a=0; a<9; a++)
+	memcpy(out.axis((ImuVec) (a/3), a%3) + old, in.axis[a], n*sizeof(double));
+      memcpy(out.t() + old, in.t, n*sizeof(double));
+      memcpy(out.dt() + old, in.dt, n*sizeof(double));
+      memcpy(out.seq_num() + old, in.seq_num, n*sizeof(int32_t));
+      memcpy(out.fluid_pressure() + old, in.fluid_pressure, n*sizeof(float));
+      return n;
+    }
+
+  const size_t N = h.size();
+
+  if(!primed)
+    {
+      for(int a=0; a<9; a++)
+	hist[a].assign(N - 1, in.axis[a][0]);
+      pending = 0;
+      primed = true;
+    }
+
+  // outputs end each group of M: at work index w0 + j*M
+  const size_t h_len = N - 1 + pending;
+  const size_t total = pending + n;
+  const size_t n_out = total/M;
+  const size_t keep = N - 1 + total%M;
+  const size_t w0 = N + M - 2;
+  const size_t S = n_out + Q - 1;
+
+  out.resize(old + n_out);
+  work.resize(h_len + n);
+  phase.resize(M*S);
+
+  for(int a=0; a<9; a++)
+    {
+      double* w = &work[0];
+      memcpy(w, &hist[a][0], h_len*sizeof(double));
+      memcpy(w + h_len, in.axis[a], n*sizeof(double));
+
+      // phase r holds x[w0 + j*M - r] for j = -(Q-1) .. n_out-1
+      double* ph = &phase[0];
+      for(int r=0; r<M; r++)
+	{
+	  const double* src = w + w0 - (Q - 1)*M - r;
+	  double* dst = ph + r*S;
+	  for(size_t i=0; i<S; i++)
+	    dst[i] = src[i*M];
+	}
+
+      // y[j] = sum over r, q of h[q*M + r] x[w0 + j*M - q*M - r]
+      double* __restrict y = out.axis((ImuVec) (a/3), a%3) + old;
+      for(size_t j=0; j<n_out; j++)
+	y[j] = 0.0;
+
+      // four taps per pass over y, so y is loaded and stored a quarter as often
+      for(int r=0; r<M; r++)
+	{
+	  const double* __restrict x = ph + r*S + (Q - 1);
+	  int q = 0;
+	  for(; q+4<=Q; q+=4)
+	    {
+	      const double c0 = h[q*M + r], c1 = h[(q+1)*M + r];
+	      const double c2 = h[(q+2)*M + r], c3 = h[(q+3)*M + r];
+	      const double* __restrict x0 = x - q;
+	      const double* __restrict x1 = x0 - 1;
+	      const double* __restrict x2 = x0 - 2;
+	      const double* __restrict x3 = x0 - 3;
+	      for(size_t j=0; j<n_out; j++)
+		y[j] += c0*x0[j] + c1*x1[j] + c2*x2[j] + c3*x3[j];
+	    }
+	  for(; q<Q; q++)
+	    {
+	      const double c = h[q*M + r];
+	      const double* __restrict x0 = x - q;
+	      for(size_t j=0; j<n_out; j++)
+		y[j] += c*x0[j];
+	    }
+	}
+
+      hist[a].assign(w + h_len + n - keep, w + h_len + n);
+    }
+
+  // the rest of each output comes from the last input of its group
+  const double delay = group_delay();
+  for(size_t j=0; j<n_out; j++)
+    {
+      const size_t src = w0 + j*M - h_len;
+      const double t = in.t[src] - delay;
+      out.t()[old + j] = t;
+      out.dt()[old + j] = isnan(t_prev) ? M/hz : t - t_prev;
+      out.seq_num()[old + j] = in.seq_num[src];
+      out.fluid_pressure()[old + j] = in.fluid_pressure[src];
+      t_prev = t;
+    }
+
+  pending = (int) (total%M);
+
+  return n_out;
+
+}
@@ -0,0 +1,292 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of flight_rec.h.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <helper_funcs/flight_rec.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+// copy into and out of the ring across its end
+static void ring_put(uint8_t* ring, uint64_t mask, uint64_t pos, const void* src, size_t len)
+{
+
+  const size_t at = pos & mask;
+  const size_t first = std::min(len, (size_t) (mask + 1 - at));
+
+  memcpy(ring + at, src, first);
+  memcpy(ring, (const uint8_t*) src + first, len - first);
+
+}
+
+static void ring_get(const uint8_t* ring, uint64_t mask, uint64_t pos, void* dst, size_t len)
+{
+
+  const size_t at = pos & mask;
+  const size_t first = std::min(len, (size_t) (mask + 1 - at));
+
+  memcpy(dst, ring + at, first);
+  memcpy((uint8_t*) dst + first, ring, len - first);
+
+}
+
+static size_t frame_size(size_t len)
+{
+
+  return (sizeof(FlightRecFrame) + len + 7) & ~(size_t) 7;
+
+}
+
+// a mapped segment, read only
+struct FlightRecSegment
+{
+
+  void* p;
+  size_t size;
+  const FlightRecHeader* hdr;
+  const uint8_t* ring;
+  uint64_t mask;
+
+  FlightRecSegment(void) : p(MAP_FAILED), size(0), hdr(NULL), ring(NULL), mask(0) {}
+  ~FlightRecSegment(void) { if(p != MAP_FAILED) munmap(p, size); }
+
+  int open(const char* name)
+  {
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0)
+      return -1;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > FLIGHT_REC_HEADER_SIZE)
+      {
+	size = st.st_size;
+	p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+      }
+    ::close(fd);
+    if(p == MAP_FAILED)
+      return -1;
+
+    hdr = (const FlightRecHeader*) p;
+    const uint64_t cap = hdr->capacity;
+    if(memcmp(hdr->magic, FLIGHT_REC_MAGIC, sizeof(hdr->magic)) != 0 || hdr->header_size != FLIGHT_REC_HEADER_SIZE ||
+       cap < 4096 || (cap & (cap - 1)) != 0 || FLIGHT_REC_HEADER_SIZE + cap > size)
+      return -1;
+
+    ring = (const uint8_t*) p + FLIGHT_REC_HEADER_SIZE;
+    mask = cap - 1;
+    return 0;
+  }
+
+};
+
+// true if a process other than this one has the segment open
+static bool other_writer_running(const FlightRecHeader* hdr)
+{
+
+  if(hdr->state != FLIGHT_REC_OPEN || hdr->pid == (int32_t) getpid())
+    return false;
+
+  return kill(hdr->pid, 0) == 0 || errno == EPERM;
+
+}
+
+FlightRecorder::~FlightRecorder(void)
+{
+
+  close();
+
+}
+
+int FlightRecorder::open(const char* name, size_t capacity)
+{
+
+  close();
+
+  size_t cap = 4096;
+  while(cap < capacity)
+    cap <<= 1;
+
+  // another run of the same program keeps its segment
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+  if(fd < 0 && errno == EEXIST)
+    {
+      {
+	FlightRecSegment seg;
+	if(seg.open(name) == 0 && other_writer_running(seg.hdr))
+	  {
+	    errno = EBUSY;
+	    return -1;
+	  }
+      }
+      shm_unlink(name);
+      fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+  if(fd < 0)
+    return -1;
+
+  const size_t size = FLIGHT_REC_HEADER_SIZE + cap;
+  void* p = MAP_FAILED;
+  if(ftruncate(fd, size) == 0)
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(p == MAP_FAILED)
+    {
+      shm_unlink(name);
+      return -1;
+    }
+
+  hdr = new (p) FlightRecHeader;
+  memcpy(hdr->magic, FLIGHT_REC_MAGIC, sizeof(hdr->magic));
+  hdr->header_size = FLIGHT_REC_HEADER_SIZE;
+  hdr->capacity = cap;
+  hdr->pid = (int32_t) getpid();
+  hdr->reserved = 0;
+  hdr->head.store(0, std::memory_order_relaxed);
+  hdr->state = FLIGHT_REC_OPEN;
+
+  ring = (uint8_t*) p + FLIGHT_REC_HEADER_SIZE;
+  mask = cap - 1;
+  max_len = cap/4;
+  seg_name = name;
+
+  return 0;
+
+}
+
+void FlightRecorder::close(void)
+{
+
+  if(!hdr)
+    return;
+
+  hdr->state = FLIGHT_REC_CLOSED;
+  munmap(hdr, FLIGHT_REC_HEADER_SIZE + mask + 1);
+  shm_unlink(seg_name.c_str());
+  hdr = NULL;
+  ring = NULL;
+
+}
+
+void FlightRecorder::write(const struct iovec* iov, int iovcnt)
+{
+
+  size_t len = 0;
+  for(int i=0; i<iovcnt; i++)
+    len += iov[i].iov_len;
+  len = std::min(len, max_len);
+
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME_COARSE, &ts); // a tick is plenty for the last N seconds
+
+  const uint64_t pos = hdr->head.fetch_add(frame_size(len), std::memory_order_relaxed);
+  uint32_t* magic = (uint32_t*) (ring + (pos & mask));
+  __atomic_store_n(magic, 0u, __ATOMIC_RELAXED);
+
+  // the bytes, then the rest of the frame, then its magic
+  uint64_t at = pos + sizeof(FlightRecFrame);
+  size_t left = len;
+  for(int i=0; i<iovcnt && left; i++)
+    {
+      const size_t n = std::min(left, iov[i].iov_len);
+      ring_put(ring, mask, at, iov[i].iov_base, n);
+      at += n;
+      left -= n;
+    }
+
+  FlightRecFrame f;
+  f.len = (uint32_t) len;
+  f.pos = pos;
+  f.time_ns = (int64_t) ts.tv_sec*1000000000 + ts.tv_nsec;
+  ring_put(ring, mask, pos + sizeof(f.magic), (const uint8_t*) &f + sizeof(f.magic), sizeof(f) - sizeof(f.magic));
+  __atomic_store_n(magic, FLIGHT_REC_FRAME_MAGIC, __ATOMIC_RELEASE);
+
+}
+
+
+int flight_rec_dump(const char* name, FILE* fp, double seconds)
+{
+
+  FlightRecSegment seg;
+  if(seg.open(name) != 0)
+    return -1;
+
+  const uint64_t cap = seg.mask + 1;
+  const uint64_t head = seg.hdr->head.load(std::memory_order_acquire);
+  uint64_t pos = head > cap ? head - cap : 0;
+
+  // the frames still whole, oldest first
+  std::vector<FlightRecFrame> frames;
+  while(pos + sizeof(FlightRecFrame) <= head)
+    {
+      FlightRecFrame f;
+      ring_get(seg.ring, seg.mask, pos, &f, sizeof(f));
+      if(f.magic == FLIGHT_REC_FRAME_MAGIC && f.pos == pos && f.len <= cap/4 && pos + frame_size(f.len) <= head)
+	{
+	  frames.push_back(f);
+	  pos += frame_size(f.len);
+	}
+      else
+	pos += 8;
+    }
+
+  int64_t t_min = INT64_MIN;
+  if(seconds > 0.0 && !frames.empty())
+    {
+      int64_t newest = INT64_MIN;
+      for(size_t i=0; i<frames.size(); i++)
+	newest = std::max(newest, frames[i].time_ns);
+      t_min = newest - (int64_t) (seconds*1e9);
+    }
+
+  std::vector<uint8_t> buf;
+  int n = 0;
+  for(size_t i=0; i<frames.size(); i++)
+    if(frames[i].time_ns >= t_min)
+      {
+	buf.resize(frames[i].len);
+	ring_get(seg.ring, seg.mask, frames[i].pos + sizeof(FlightRecFrame), buf.data(), frames[i].len);
+	fwrite(buf.data(), 1, buf.size(), fp);
+	n++;
+      }
+
+  return n;
+
+}
+
+int flight_rec_recover(const char* name, const char* out_file, double seconds)
+{
+
+  {
+    FlightRecSegment seg;
+    if(seg.open(name) != 0 || seg.hdr->state != FLIGHT_REC_OPEN)
+      return 0;
+    if(seg.hdr->pid == (int32_t) getpid() || other_writer_running(seg.hdr))
+      return 0;
+  }
+
+  FILE* fp = fopen(out_file, "w");
+  if(!fp)
+    return -1;
+  const int n = flight_rec_dump(name, fp, seconds);
+  fclose(fp);
+
+  return n;
+
+}
@@ -11,6 +11,8 @@
 #include <stdio.h>
 #include <Eigen/Core>
 #include <helper_funcs/helper_funcs.h>
+#include <helper_funcs/so3.h>
+#include <helper_funcs/trace.h>
 #include <unsupported/Eigen/MatrixFunctions>
 #include <iostream>
 
@@ -25,10 +27,7 @@
 Eigen::Matrix3d skew(Eigen::Vector3d w)
 {
 
-  Eigen::Matrix3d w_hat;
-  w_hat << 0.0,-w(2),w(1),w(2),0.0,-w(0),-w(1),w(0),0.0;
-  
-  return w_hat;
+  return so3::skew(w);
 
 }
 
@@ -40,9 +39,7 @@ Eigen::Matrix3d skew(Eigen::Vector3d w)
 Eigen::Vector3d unskew(Eigen::Matrix3d w_hat)
 {
 
-  Eigen::Vector3d w(-w_hat(1,2),w_hat(0,2),-w_hat(0,1));
-
-  return w;
+  return so3::unskew(w_hat);
 
 }
 
@@ -53,10 +50,7 @@ Eigen::Vector3d unskew(Eigen::Matrix3d w_hat)
 Eigen::Matrix3d Rx(double x)
 {
 
-  Eigen::Matrix3d Rx;
-  Rx << 1,0,0,0,cos(x),-sin(x),0,sin(x),cos(x);
-
-  return Rx;
+  return so3::Rx(x);
 
 }
 
@@ -67,10 +61,7 @@ Eigen::Matrix3d Rx(double x)
 Eigen::Matrix3d Ry(double y)
 {
 
-  Eigen::Matrix3d Ry;
-  Ry << cos(y),0,sin(y),0,1,0,-sin(y),0,cos(y);
-
-  return Ry;
+  return so3::Ry(y);
 
 }
 
@@ -81,10 +72,7 @@ Eigen::Matrix3d Ry(double y)
 Eigen::Matrix3d Rz(double z)
 {
 
-  Eigen::Matrix3d Rz;
-  Rz << cos(z),-sin(z),0,sin(z),cos(z),0,0,0,1;
-
-  return Rz;
+  return so3::Rz(z);
 
 }
 
@@ -116,7 +104,7 @@ Eigen::Vector3d rot2rph(Eigen::Matrix3d R)
 Eigen::Matrix3d rpy2rot(Eigen::Vector3d rpy)
 {
 
-  return Rz(rpy(2))*Ry(rpy(1))*Rx(rpy(0));
+  return so3::rpy2rot(rpy);
   
 }
 
@@ -141,6 +129,8 @@ Eigen::Matrix3d rot_earth2ned(float lat)
 Eigen::Matrix3d get_R_se(float t)
 {
 
+  TRACE_SPAN("geo", "get_R_se");
+
   float rate = 15.041*M_PI/180/3600;
 
   Eigen::Vector3d w(0,0,1.0);
@@ -159,11 +149,8 @@ Eigen::Matrix3d get_R_se(float t)
 Eigen::Matrix3d get_R_en(float lat)
 {
 
-  Eigen::Matrix3d R_en;
-
-  R_en << -sin(lat),0,-cos(lat),0,1,0,cos(lat),0,-sin(lat);
-
-  return R_en;
+  // evaluated in single precision, as before, then widened
+  return so3::get_R_en(lat).cast<double>();
 
 }
 
@@ -175,6 +162,8 @@ Eigen::Matrix3d get_R_en(float lat)
 Eigen::Matrix3d get_R_sn(float lat, float t)
 {
 
+  TRACE_SPAN("geo", "get_R_sn");
+
   Eigen::Matrix3d R_en = get_R_en(lat);
   
   Eigen::Matrix3d R_se = get_R_se(t);
@@ -197,7 +186,7 @@ Eigen::Matrix3d get_R_sn(float lat, float t)
 Eigen::Matrix3d stringToDiag(std::string str)
 {
   Eigen::Matrix3d diag;
-  Eigen::Vector3d vec;
+  Eigen::Vector3d vec = Eigen::Vector3d::Constant(NAN);
   sscanf(str.c_str(),"%*[[]%lf,%lf,%lf%*[]]",&vec(0),&vec(1),&vec(2));
 
   diag << vec(0),0,0,0,vec(1),0,0,0,vec(2);
@@ -207,180 +196,6 @@ Eigen::Matrix3d stringToDiag(std::string str)
 }
 
 
-/**
- *
- * @brief Function for loading parameters from config_file.
- *
- * @param Config file to parse.
- *
- */
-config_params load_params(char* config_file)
-{
-
-  printf("LOADING CONFIG FILE: %s\n",config_file);
-  
-  config_params params;
-  std::ifstream infile(config_file);
-  std::string line;
-
-  // 2018-10-04 LLW added optional parameters to set ICs for acc_hat and w_E_north
-  // set these to sentinel values in case the user does not provide these parameters
-  // on the command line
-  Eigen::Vector3d sentinel(-100.0,-100.0,-100.0);
-  params.w_E_north = sentinel;
-  params.acc_hat   = sentinel;
-  
-  /**********************************
-   *  LOAD IN LINE FROM CONFIG FILE
-   **********************************/
-  while (std::getline(infile, line))
-  {
-
-    char field[128] = "";
-    char data[128]  = "";
-
-    /*********************************
-     *          PARSE LINE
-     *********************************/
-    sscanf(line.c_str(),"%s = %s",field,data);
-    
-    if((std::string(field))=="hz")
-    {
-
-      sscanf(data,"%d",&params.hz);
-
-    }
-    else if((std::string(field))=="lat")
-    {
-
-      sscanf(data,"%f",&params.lat);
-      params.lat = params.lat*M_PI/180.0;
-
-    }
-    else if((std::string(field))=="o_file")
-    {
-
-      char str[128];
-      sscanf(data,"%s",str);
-      params.o_file = std::string(str);
-      params.o_file.erase(remove(params.o_file.begin(),params.o_file.end(), '\"' ),params.o_file.end());
-
-    }
-    else if((std::string(field))=="i_file")
-    {
-	
-      char str[128];
-      sscanf(data,"%s",str);
-      params.i_file = std::string(str);
-      params.i_file.erase(remove(params.i_file.begin(),params.i_file.end(), '\"' ),params.i_file.end());
-      
-    }
-    else if((std::string(field))=="k_acc")
-    {
-
-      params.K_acc = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="k_mag")
-    {
-
-      params.K_mag = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="k_ang_bias")
-    {
-
-      params.K_ang_bias = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="k_acc_bias")
-    {
-
-      params.K_acc_bias = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="k_mag_bias")
-    {
-
-      params.K_mag_bias = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="k_E_n")
-    {
-
-      params.K_E_n = stringToDiag(data);
-
-    }
-    else if((std::string(field))=="rpy_align")
-    {
-      Eigen::Vector3d rpy_align;
-      sscanf(data,"[%lf,%lf,%lf]",&rpy_align(0),&rpy_align(1),&rpy_align(2));
-      params.R_align = rpy2rot(rpy_align);
-    }
-    else if((std::string(field))=="rpy_ro")
-    {
-      Eigen::Vector3d rpy_r0;
-      sscanf(data,"[%lf,%lf,%lf]",&rpy_r0(0),&rpy_r0(1),&rpy_r0(2));
-      params.R0 = rpy2rot(rpy_r0);
-    }
-    else if((std::string(field))=="k_north")
-    {
-      params.K_north = stringToDiag(data);
-    }
-    else if((std::string(field))=="k_g")
-    {
-      params.K_g = stringToDiag(data);
-    }
-    else if ((std::string(field))=="last_mod")
-    {
-
-      char str[128];
-      sscanf(data,"%s",str);
-      params.last_mod = std::string(str);
-      params.last_mod.erase(remove(params.last_mod.begin(),params.last_mod.end(), '\"' ),params.last_mod.end());
-	
-    }
-    else if((std::string(field))=="acc_bias")
-    {
-      Eigen::Vector3d vec;
-      sscanf(data,"[%lf,%lf,%lf]",&vec(0),&vec(1),&vec(2));
-      params.acc_bias = vec;
-    }
-    else if((std::string(field))=="ang_bias")
-    {
-      Eigen::Vector3d vec;
-      sscanf(data,"[%lf,%lf,%lf]",&vec(0),&vec(1),&vec(2));
-      params.ang_bias = vec;
-    }
-    else if((std::string(field))=="mag_bias")
-    {
-      Eigen::Vector3d vec;
-      sscanf(data,"[%lf,%lf,%lf]",&vec(0),&vec(1),&vec(2));
-      params.mag_bias = vec;
-    }
-
-    // 2018-10-04 LLW added optional parameters to set ICs for acc_hat and w_E_north
-    else if((std::string(field))=="acc_hat")
-    {
-      Eigen::Vector3d vec;
-      sscanf(data,"[%lf,%lf,%lf]",&vec(0),&vec(1),&vec(2));
-      params.acc_hat = vec;
-    }    
-    // 2018-10-04 LLW added optional parameters to set ICs for acc_hat and w_E_north    
-    else if((std::string(field))=="w_E_north")
-    {
-      Eigen::Vector3d vec;
-      sscanf(data,"[%lf,%lf,%lf]",&vec(0),&vec(1),&vec(2));
-      params.w_E_north = vec;
-    }    
-  }
-
-
-  return params;
-
-}
-
-
 /**
  *
  * @brief Function to print loaded parameters.
@@ -388,7 +203,7 @@ config_params load_params(char* config_file)
  * @param Parameter struct.
  *
  */
-void print_loaded_params(config_params params)
+void print_loaded_params(const config_params& params)
 {
 
   printf("***********************************\n");
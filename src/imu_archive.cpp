@@ -0,0 +1,696 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of imu_archive.h.
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <helper_funcs/imu_archive.h>
+#include <helper_funcs/ingest.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define IMU_ARCHIVE_MAGIC   "IMUARCH1"
+#define IMU_ARCHIVE_VERSION 1
+#define IMU_ARCHIVE_ALIGN   64
+
+static_assert(sizeof(ImuArchiveHeader) == 64, "ImuArchiveHeader layout");
+static_assert(sizeof(ImuArchiveBlock) == 160, "ImuArchiveBlock layout");
+
+
+// bit stream, least significant bit first
+class ArchiveBitWriter
+{
+public:
+
+  ArchiveBitWriter(void) : nbits(0) {}
+
+  void put(uint64_t v, int n)
+  {
+    if(n == 0)
+      return;
+    if(n < 64)
+      v &= (1ULL << n) - 1;
+
+    const int shift = (int) (nbits & 63);
+    if(shift == 0)
+      words.push_back(0);
+    words.back() |= v << shift;
+    if(shift + n > 64)
+      words.push_back(v >> (64 - shift));
+
+    nbits += n;
+  }
+
+  size_t bytes(void) const { return words.size()*sizeof(uint64_t); }
+  const uint64_t* data(void) const { return words.empty() ? NULL : &words[0]; }
+
+private:
+
+  std::vector<uint64_t> words;
+  uint64_t nbits;
+
+};
+
+class ArchiveBitReader
+{
+public:
+
+  // reads past bytes (a corrupt column) give zero bits
+  ArchiveBitReader(const uint8_t* p, size_t bytes) : words(p), num_words(bytes/8), nbits(0) {}
+
+  uint64_t get(int n)
+  {
+    if(n == 0)
+      return 0;
+
+    const size_t w = (size_t) (nbits >> 6);
+    const int shift = (int) (nbits & 63);
+
+    uint64_t v = word(w) >> shift;
+    if(shift + n > 64)
+      v |= word(w + 1) << (64 - shift);
+    if(n < 64)
+      v &= (1ULL << n) - 1;
+
+    nbits += n;
+    return v;
+  }
+
+private:
+
+  uint64_t word(size_t i) const
+  {
+    if(i >= num_words)
+      return 0;
+    uint64_t v;
+    memcpy(&v, words + 8*i, 8);
+    return v;
+  }
+
+  const uint8_t* words;
+  size_t num_words;
+  uint64_t nbits;
+
+};
+
+
+// width in bits of v
+static inline int archive_width(uint64_t v)
+{
+  return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+// first value, minimum delta and bit width, then packed deltas
+static void archive_encode_delta(const uint64_t* v, size_t n, ArchiveBitWriter& w)
+{
+
+  uint64_t min_delta = 0;
+  uint64_t range = 0;
+
+  if(n > 1)
+    {
+      int64_t lo = (int64_t) (v[1] - v[0]);
+      int64_t hi = lo;
+      for(size_t i=2; i<n; i++)
+	{
+	  const int64_t d = (int64_t) (v[i] - v[i-1]);
+	  lo = std::min(lo, d);
+	  hi = std::max(hi, d);
+	}
+      min_delta = (uint64_t) lo;
+      range = (uint64_t) hi - (uint64_t) lo;
+    }
+
+  const int width = archive_width(range);
+
+  w.put(v[0], 64);
+  w.put(min_delta, 64);
+  w.put(width, 7);
+  for(size_t i=1; i<n; i++)
+    w.put(v[i] - v[i-1] - min_delta, width);
+
+}
+
+static void archive_decode_delta(const uint8_t* p, size_t bytes, size_t n, uint64_t* v)
+{
+
+  ArchiveBitReader r(p, bytes);
+
+  v[0] = r.get(64);
+  const uint64_t min_delta = r.get(64);
+  const int width = (int) r.get(7);
+  for(size_t i=1; i<n; i++)
+    v[i] = v[i-1] + min_delta + r.get(width);
+
+}
+
+// XOR with the previous value; reuse the previous leading/trailing
+// zero window when the new bits fit in it
+static void archive_encode_xor(const uint64_t* v, size_t n, ArchiveBitWriter& w)
+{
+
+  int lead = -1;
+  int trail = 0;
+
+  w.put(v[0], 64);
+
+  for(size_t i=1; i<n; i++)
+    {
+      const uint64_t x = v[i] ^ v[i-1];
+
+      if(x == 0)
+	{
+	  w.put(0, 1);
+	  continue;
+	}
+
+      w.put(1, 1);
+
+      const int l = std::min(__builtin_clzll(x), 31);
+      const int t = __builtin_ctzll(x);
+
+      if(lead >= 0 && l >= lead && t >= trail)
+	{
+	  w.put(0, 1);
+	  w.put(x >> trail, 64 - lead - trail);
+	}
+      else
+	{
+	  const int sig = 64 - l - t;
+	  w.put(1, 1);
+	  w.put(l, 5);
+	  w.put(sig - 1, 6);
+	  w.put(x >> t, sig);
+	  lead = l;
+	  trail = t;
+	}
+    }
+
+}
+
+static void archive_decode_xor(const uint8_t* p, size_t bytes, size_t n, uint64_t* v)
+{
+
+  ArchiveBitReader r(p, bytes);
+  int lead = 0;
+  int trail = 0;
+
+  v[0] = r.get(64);
+
+  for(size_t i=1; i<n; i++)
+    {
+      if(r.get(1) == 0)
+	{
+	  v[i] = v[i-1];
+	  continue;
+	}
+
+      if(r.get(1) == 1)
+	{
+	  lead  = (int) r.get(5);
+	  const int sig = (int) r.get(6) + 1;
+	  trail = 64 - lead - sig;
+	}
+
+      v[i] = v[i-1] ^ (r.get(64 - lead - trail) << trail);
+    }
+
+}
+
+// column k of a batch as 64-bit patterns
+static void archive_column_bits(const ImuBatch& b, int k, size_t n, uint64_t* v)
+{
+
+  if(k < 9)
+    memcpy(v, b.axis((ImuVec) (k/3), k%3), n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_T)
+    memcpy(v, b.t(), n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_DT)
+    memcpy(v, b.dt(), n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_SEQ)
+    for(size_t i=0; i<n; i++)
+      v[i] = (uint64_t) (int64_t) b.seq_num()[i];
+  else
+    for(size_t i=0; i<n; i++)
+      {
+	// widening float to double is exact
+	const double d = b.fluid_pressure()[i];
+	memcpy(&v[i], &d, sizeof(double));
+      }
+
+}
+
+static void archive_set_column_bits(ImuBatch& b, int k, size_t j, size_t n, const uint64_t* v)
+{
+
+  if(k < 9)
+    memcpy(b.axis((ImuVec) (k/3), k%3) + j, v, n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_T)
+    memcpy(b.t() + j, v, n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_DT)
+    memcpy(b.dt() + j, v, n*sizeof(double));
+  else if(k == IMU_ARCHIVE_COL_SEQ)
+    for(size_t i=0; i<n; i++)
+      b.seq_num()[j + i] = (int32_t) (int64_t) v[i];
+  else
+    for(size_t i=0; i<n; i++)
+      {
+	double d;
+	memcpy(&d, &v[i], sizeof(double));
+	b.fluid_pressure()[j + i] = (float) d;
+      }
+
+}
+
+static const void* archive_column_ptr(const ImuBatch& b, int k)
+{
+
+  if(k < 9)
+    return b.axis((ImuVec) (k/3), k%3);
+  if(k == IMU_ARCHIVE_COL_T)
+    return b.t();
+  if(k == IMU_ARCHIVE_COL_DT)
+    return b.dt();
+  if(k == IMU_ARCHIVE_COL_SEQ)
+    return b.seq_num();
+  return b.fluid_pressure();
+
+}
+
+static size_t archive_elem_size(int k)
+{
+
+  if(k == IMU_ARCHIVE_COL_SEQ)
+    return sizeof(int32_t);
+  if(k == IMU_ARCHIVE_COL_PRESS)
+    return sizeof(float);
+  return sizeof(double);
+
+}
+
+// append samples [i, i+n) of src to dst
+static void archive_append(ImuBatch& dst, const ImuBatch& src, size_t i, size_t n)
+{
+
+  const size_t j = dst.size();
+
+  dst.resize(j + n);
+  for(int k=0; k<IMU_ARCHIVE_NUM_COLUMNS; k++)
+    {
+      const size_t e = archive_elem_size(k);
+      memcpy((uint8_t*) archive_column_ptr(dst, k) + e*j,
+	     (const uint8_t*) archive_column_ptr(src, k) + e*i, e*n);
+    }
+
+}
+
+
+ImuArchiveWriter::ImuArchiveWriter(void)
+  : fp(NULL), compress(false), write_error(false)
+{
+
+  memset(&header, 0, sizeof(header));
+
+}
+
+ImuArchiveWriter::~ImuArchiveWriter(void)
+{
+
+  close();
+
+}
+
+int ImuArchiveWriter::open(const char* filename, bool compress_columns, int block_size)
+{
+
+  close();
+
+  fp = fopen(filename, "wb");
+  if(fp == NULL)
+    return -1;
+
+  compress = compress_columns;
+  write_error = false;
+  index.clear();
+  block.clear();
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, IMU_ARCHIVE_MAGIC, 8);
+  header.version = IMU_ARCHIVE_VERSION;
+  header.flags = IMU_ARCHIVE_SORTED | (compress ? IMU_ARCHIVE_COMPRESSED : 0);
+  header.block_size = (block_size > 0) ? block_size : IMU_ARCHIVE_BLOCK;
+
+  // placeholder, rewritten by close()
+  if(fwrite(&header, sizeof(header), 1, fp) != 1)
+    write_error = true;
+
+  return 0;
+
+}
+
+void ImuArchiveWriter::append(const ImuPacket& pkt)
+{
+
+  block.push_back(pkt);
+
+  if(block.size() >= header.block_size)
+    flush_block();
+
+}
+
+void ImuArchiveWriter::append(const ImuBatch& batch)
+{
+
+  for(size_t i=0; i<batch.size(); )
+    {
+      const size_t n = std::min(batch.size() - i, (size_t) header.block_size - block.size());
+      archive_append(block, batch, i, n);
+      i += n;
+
+      if(block.size() >= header.block_size)
+	flush_block();
+    }
+
+}
+
+void ImuArchiveWriter::flush_block(void)
+{
+
+  const size_t n = block.size();
+  if(fp == NULL || n == 0)
+    return;
+
+  ImuArchiveBlock b;
+  memset(&b, 0, sizeof(b));
+  b.offset = (uint64_t) ftell(fp);
+  b.first = header.num_samples;
+  b.num = (uint32_t) n;
+
+  const double* t = block.t();
+  b.t_min = *std::min_element(t, t + n);
+  b.t_max = *std::max_element(t, t + n);
+
+  if(!index.empty() && (b.t_min < index.back().t_max || t[0] != b.t_min))
+    header.flags &= ~IMU_ARCHIVE_SORTED;
+  for(size_t i=1; i<n && (header.flags & IMU_ARCHIVE_SORTED); i++)
+    if(t[i] < t[i-1])
+      header.flags &= ~IMU_ARCHIVE_SORTED;
+
+  if(header.num_samples == 0)
+    {
+      header.t_begin = b.t_min;
+      header.t_end = b.t_max;
+    }
+  header.t_begin = std::min(header.t_begin, b.t_min);
+  header.t_end = std::max(header.t_end, b.t_max);
+
+  std::vector<uint64_t> bits(n);
+  uint32_t pos = 0;
+  static const uint8_t zeros[IMU_ARCHIVE_ALIGN] = {0};
+
+  for(int k=0; k<IMU_ARCHIVE_NUM_COLUMNS; k++)
+    {
+      const size_t raw_bytes = n*archive_elem_size(k);
+      const void* src = archive_column_ptr(block, k);
+      size_t bytes = raw_bytes;
+      int enc = IMU_ARCHIVE_RAW;
+
+      ArchiveBitWriter w;
+      if(compress)
+	{
+	  archive_column_bits(block, k, n, &bits[0]);
+	  if(k == IMU_ARCHIVE_COL_T || k == IMU_ARCHIVE_COL_SEQ)
+	    archive_encode_delta(&bits[0], n, w);
+	  else
+	    archive_encode_xor(&bits[0], n, w);
+
+	  if(w.bytes() < raw_bytes)
+	    {
+	      enc = (k == IMU_ARCHIVE_COL_T || k == IMU_ARCHIVE_COL_SEQ) ? IMU_ARCHIVE_DELTA : IMU_ARCHIVE_XOR;
+	      src = w.data();
+	      bytes = w.bytes();
+	    }
+	}
+
+      // align every column so raw ones can be used in place
+      const uint32_t pad = (uint32_t) ((IMU_ARCHIVE_ALIGN - (b.offset + pos) % IMU_ARCHIVE_ALIGN) % IMU_ARCHIVE_ALIGN);
+      if(pad > 0 && fwrite(zeros, 1, pad, fp) != pad)
+	write_error = true;
+      pos += pad;
+
+      b.col_offset[k] = pos;
+      b.col_bytes[k] = (uint32_t) bytes;
+      b.col_encoding[k] = (uint8_t) enc;
+
+      if(fwrite(src, 1, bytes, fp) != bytes)
+	write_error = true;
+      pos += (uint32_t) bytes;
+    }
+
+  index.push_back(b);
+  header.num_samples += n;
+  header.num_blocks++;
+  block.clear();
+
+}
+
+int ImuArchiveWriter::close(void)
+{
+
+  if(fp == NULL)
+    return 0;
+
+  flush_block();
+
+  header.index_offset = (uint64_t) ftell(fp);
+  if(!index.empty() && fwrite(&index[0], sizeof(ImuArchiveBlock), index.size(), fp) != index.size())
+    write_error = true;
+
+  rewind(fp);
+  if(fwrite(&header, sizeof(header), 1, fp) != 1)
+    write_error = true;
+
+  if(fclose(fp) != 0)
+    write_error = true;
+  fp = NULL;
+
+  return write_error ? -1 : 0;
+
+}
+
+
+// every column inside the file, raw ones exactly num values, and num
+// within the block size, so read_block() and raw_column() can trust it
+static bool archive_block_ok(const ImuArchiveBlock& b, uint32_t block_size, uint64_t file_size)
+{
+
+  if(b.num == 0 || b.num > block_size || b.offset > file_size)
+    return false;
+
+  for(int k=0; k<IMU_ARCHIVE_NUM_COLUMNS; k++)
+    {
+      if((uint64_t) b.col_offset[k] + b.col_bytes[k] > file_size - b.offset)
+	return false;
+
+      switch(b.col_encoding[k])
+	{
+	case IMU_ARCHIVE_RAW:
+	  if(b.col_bytes[k] != b.num*archive_elem_size(k))
+	    return false;
+	  break;
+	case IMU_ARCHIVE_DELTA:
+	case IMU_ARCHIVE_XOR:
+	  break;
+	default:
+	  return false;
+	}
+    }
+
+  return true;
+
+}
+
+int ImuArchive::open(const char* filename)
+{
+
+  close();
+
+  if(map.open(filename) != 0)
+    return -1;
+
+  const ImuArchiveHeader* h = (const ImuArchiveHeader*) map.data();
+
+  if(map.size() < sizeof(ImuArchiveHeader) || memcmp(h->magic, IMU_ARCHIVE_MAGIC, 8) != 0 ||
+     h->version != IMU_ARCHIVE_VERSION ||
+     h->index_offset + (uint64_t) h->num_blocks*sizeof(ImuArchiveBlock) > map.size())
+    {
+      close();
+      return -1;
+    }
+
+  const ImuArchiveBlock* index = (const ImuArchiveBlock*) (map.data() + h->index_offset);
+  for(uint32_t b=0; b<h->num_blocks; b++)
+    if(!archive_block_ok(index[b], h->block_size, map.size()))
+      {
+	close();
+	return -1;
+      }
+
+  header = h;
+  blocks = index;
+
+  return 0;
+
+}
+
+void ImuArchive::close(void)
+{
+
+  map.close();
+  header = NULL;
+  blocks = NULL;
+
+}
+
+const void* ImuArchive::raw_column(int b, int col) const
+{
+
+  const ImuArchiveBlock& blk = blocks[b];
+
+  if(blk.col_encoding[col] != IMU_ARCHIVE_RAW)
+    return NULL;
+
+  return map.data() + blk.offset + blk.col_offset[col];
+
+}
+
+void ImuArchive::read_block(int b, ImuBatch& out) const
+{
+
+  const ImuArchiveBlock& blk = blocks[b];
+  const size_t n = blk.num;
+  const size_t j = out.size();
+  std::vector<uint64_t> bits;
+
+  out.resize(j + n);
+
+  for(int k=0; k<IMU_ARCHIVE_NUM_COLUMNS; k++)
+    {
+      const uint8_t* p = map.data() + blk.offset + blk.col_offset[k];
+      const size_t e = archive_elem_size(k);
+
+      if(blk.col_encoding[k] == IMU_ARCHIVE_RAW)
+	{
+	  memcpy((uint8_t*) archive_column_ptr(out, k) + e*j, p, e*n);
+	  continue;
+	}
+
+      bits.resize(n);
+      if(blk.col_encoding[k] == IMU_ARCHIVE_DELTA)
+	archive_decode_delta(p, blk.col_bytes[k], n, &bits[0]);
+      else
+	archive_decode_xor(p, blk.col_bytes[k], n, &bits[0]);
+      archive_set_column_bits(out, k, j, n, &bits[0]);
+    }
+
+}
+
+long ImuArchive::read(double t0, double t1, ImuBatch& out) const
+{
+
+  const int nb = num_blocks();
+  int b = 0;
+
+  // first block that can hold t0
+  if(header != NULL && (header->flags & IMU_ARCHIVE_SORTED))
+    {
+      int lo = 0, hi = nb;
+      while(lo < hi)
+	{
+	  const int mid = (lo + hi)/2;
+	  if(blocks[mid].t_max < t0)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      b = lo;
+    }
+
+  const size_t before = out.size();
+  ImuBatch tmp;
+
+  for(; b<nb; b++)
+    {
+      const ImuArchiveBlock& blk = blocks[b];
+
+      if(blk.t_min > t1)
+	{
+	  if(header->flags & IMU_ARCHIVE_SORTED)
+	    break;
+	  continue;
+	}
+      if(blk.t_max < t0)
+	continue;
+
+      tmp.clear();
+      read_block(b, tmp);
+
+      const double* t = tmp.t();
+      if(header->flags & IMU_ARCHIVE_SORTED)
+	{
+	  const size_t i0 = std::lower_bound(t, t + tmp.size(), t0) - t;
+	  const size_t i1 = std::upper_bound(t, t + tmp.size(), t1) - t;
+	  archive_append(out, tmp, i0, i1 - i0);
+	}
+      else
+	for(size_t i=0; i<tmp.size(); i++)
+	  if(t[i] >= t0 && t[i] <= t1)
+	    archive_append(out, tmp, i, 1);
+    }
+
+  return (long) (out.size() - before);
+
+}
+
+long ImuArchive::read_all(ImuBatch& out) const
+{
+
+  const size_t before = out.size();
+
+  out.reserve(before + size());
+  for(int b=0; b<num_blocks(); b++)
+    read_block(b, out);
+
+  return (long) (out.size() - before);
+
+}
+
+
+long imu_archive_convert(const std::vector<std::string>& files, const char* archive, bool compress, double hz)
+{
+
+  ImuBatch batch;
+
+  if(ingest_files(files, batch, NULL, hz) < 0)
+    return -1;
+
+  ImuArchiveWriter w;
+  if(w.open(archive, compress) != 0)
+    return -1;
+
+  w.append(batch);
+
+  if(w.close() != 0)
+    return -1;
+
+  return (long) batch.size();
+
+}
@@ -0,0 +1,305 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of imu_batch.h.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <helper_funcs/imu_batch.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define IMU_BATCH_ALIGN 64
+
+// reallocate one column, keeping its first num elements
+template<typename T>
+static void imu_batch_realloc(T*& col, size_t num, size_t cap)
+{
+
+  void* p = NULL;
+
+  if(posix_memalign(&p, IMU_BATCH_ALIGN, cap*sizeof(T)) != 0)
+    throw std::bad_alloc();
+
+  if(col != NULL)
+    {
+      memcpy(p, col, num*sizeof(T));
+      free(col);
+    }
+
+  col = (T*) p;
+
+}
+
+ImuBatchView ImuBatchView::sub(size_t begin, size_t n) const
+{
+
+  ImuBatchView w = *this;
+
+  for(int k=0; k<9; k++)
+    w.axis[k] += begin;
+  w.t += begin;
+  w.dt += begin;
+  w.seq_num += begin;
+  w.fluid_pressure += begin;
+  w.size = n;
+
+  return w;
+
+}
+
+ImuBatch::ImuBatch(void)
+  : num(0), cap(0), col_t(NULL), col_dt(NULL), col_seq_num(NULL), col_fluid_pressure(NULL)
+{
+
+  for(int k=0; k<9; k++)
+    col_axis[k] = NULL;
+
+}
+
+ImuBatch::ImuBatch(const ImuBatch& other)
+  : num(0), cap(0), col_t(NULL), col_dt(NULL), col_seq_num(NULL), col_fluid_pressure(NULL)
+{
+
+  for(int k=0; k<9; k++)
+    col_axis[k] = NULL;
+
+  *this = other;
+
+}
+
+ImuBatch& ImuBatch::operator=(const ImuBatch& other)
+{
+
+  if(this == &other)
+    return *this;
+
+  num = 0;
+  reserve(other.num);
+
+  for(int k=0; k<9; k++)
+    memcpy(col_axis[k], other.col_axis[k], other.num*sizeof(double));
+  memcpy(col_t, other.col_t, other.num*sizeof(double));
+  memcpy(col_dt, other.col_dt, other.num*sizeof(double));
+  memcpy(col_seq_num, other.col_seq_num, other.num*sizeof(int32_t));
+  memcpy(col_fluid_pressure, other.col_fluid_pressure, other.num*sizeof(float));
+
+  num = other.num;
+
+  return *this;
+
+}
+
+ImuBatch::~ImuBatch(void)
+{
+
+  for(int k=0; k<9; k++)
+    free(col_axis[k]);
+  free(col_t);
+  free(col_dt);
+  free(col_seq_num);
+  free(col_fluid_pressure);
+
+}
+
+void ImuBatch::reserve(size_t n)
+{
+
+  if(n <= cap)
+    return;
+
+  for(int k=0; k<9; k++)
+    imu_batch_realloc(col_axis[k], num, n);
+  imu_batch_realloc(col_t, num, n);
+  imu_batch_realloc(col_dt, num, n);
+  imu_batch_realloc(col_seq_num, num, n);
+  imu_batch_realloc(col_fluid_pressure, num, n);
+
+  cap = n;
+
+}
+
+void ImuBatch::grow(size_t n)
+{
+
+  if(n <= cap)
+    return;
+
+  size_t new_cap = (cap < 1024) ? 1024 : cap;
+  while(new_cap < n)
+    new_cap *= 2;
+
+  reserve(new_cap);
+
+}
+
+void ImuBatch::resize(size_t n)
+{
+
+  grow(n);
+  num = n;
+
+}
+
+void ImuBatch::push_back(const ImuPacket& pkt)
+{
+
+  append(&pkt, 1);
+
+}
+
+void ImuBatch::append(const ImuPacket* pkts, size_t n)
+{
+
+  grow(num + n);
+
+  for(size_t i=0; i<n; i++)
+    {
+      const ImuPacket& p = pkts[i];
+      const size_t j = num + i;
+
+      for(int k=0; k<3; k++)
+	{
+	  col_axis[k][j]   = p.ang(k);
+	  col_axis[3+k][j] = p.acc(k);
+	  col_axis[6+k][j] = p.mag(k);
+	}
+      col_t[j]  = p.t;
+      col_dt[j] = p.dt;
+      col_seq_num[j] = p.seq_num;
+      col_fluid_pressure[j] = p.fluid_pressure;
+    }
+
+  num += n;
+
+}
+
+void ImuBatch::append(const ImuSample* samples, size_t n)
+{
+
+  grow(num + n);
+
+  for(size_t i=0; i<n; i++)
+    {
+      const ImuSample& s = samples[i];
+      const size_t j = num + i;
+
+      for(int k=0; k<3; k++)
+	{
+	  col_axis[k][j]   = s.ang[k];
+	  col_axis[3+k][j] = s.acc[k];
+	  col_axis[6+k][j] = s.mag[k];
+	}
+      col_t[j]  = s.timestamp;
+      col_dt[j] = s.diff;
+      col_seq_num[j] = (int32_t) s.seq_num;
+      col_fluid_pressure[j] = s.fluid_pressure;
+    }
+
+  num += n;
+
+}
+
+void ImuBatch::append(const GyroData& g)
+{
+
+  ImuSample s = imu_sample_from_gyro(g);
+
+  append(&s, 1);
+
+}
+
+ImuPacket ImuBatch::packet(size_t i) const
+{
+
+  ImuPacket p;
+
+  to_packets(i, 1, &p);
+
+  return p;
+
+}
+
+void ImuBatch::to_packets(size_t begin, size_t n, ImuPacket* out) const
+{
+
+  for(size_t i=0; i<n; i++)
+    {
+      ImuPacket& p = out[i];
+      const size_t j = begin + i;
+
+      p.ang = Eigen::Vector3d(col_axis[0][j], col_axis[1][j], col_axis[2][j]);
+      p.acc = Eigen::Vector3d(col_axis[3][j], col_axis[4][j], col_axis[5][j]);
+      p.mag = Eigen::Vector3d(col_axis[6][j], col_axis[7][j], col_axis[8][j]);
+      p.t  = col_t[j];
+      p.dt = col_dt[j];
+      p.seq_num = col_seq_num[j];
+      p.fluid_pressure = col_fluid_pressure[j];
+    }
+
+}
+
+ImuBatchView ImuBatch::view(size_t begin, size_t n) const
+{
+
+  ImuBatchView w;
+
+  for(int k=0; k<9; k++)
+    w.axis[k] = col_axis[k];
+  w.t = col_t;
+  w.dt = col_dt;
+  w.seq_num = col_seq_num;
+  w.fluid_pressure = col_fluid_pressure;
+  w.size = num;
+
+  return w.sub(begin, n);
+
+}
+
+Eigen::Vector3d imu_batch_mean(const ImuBatchView& w, ImuVec v)
+{
+
+  Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+
+  if(w.size == 0)
+    return mean;
+
+  for(int k=0; k<3; k++)
+    mean(k) = w.column(v, k).sum()/w.size;
+
+  return mean;
+
+}
+
+Eigen::Vector3d imu_batch_variance(const ImuBatchView& w, ImuVec v, Eigen::Vector3d* mean_out)
+{
+
+  Eigen::Vector3d mean = imu_batch_mean(w, v);
+  Eigen::Vector3d var  = Eigen::Vector3d::Zero();
+
+  if(w.size > 1)
+    for(int k=0; k<3; k++)
+      var(k) = (w.column(v, k) - mean(k)).square().sum()/(w.size - 1);
+
+  if(mean_out != NULL)
+    *mean_out = mean;
+
+  return var;
+
+}
+
+void imu_batch_subtract_bias(ImuBatch& batch, ImuVec v, const Eigen::Vector3d& bias, size_t begin, size_t n)
+{
+
+  for(int k=0; k<3; k++)
+    Eigen::Map<Eigen::ArrayXd>(batch.axis(v, k) + begin, n) -= bias(k);
+
+}
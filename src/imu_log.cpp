@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of imu_log.h.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <helper_funcs/imu_log.h>
+#include <helper_funcs/text_scan.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+int imu_log_sprintf_payload(char* str, const ImuPacket& pkt)
+{
+
+  return sprintf(str,"%.9f,%d,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.6f",
+		 pkt.t, pkt.seq_num,
+		 pkt.ang(0), pkt.ang(1), pkt.ang(2),
+		 pkt.acc(0), pkt.acc(1), pkt.acc(2),
+		 pkt.mag(0), pkt.mag(1), pkt.mag(2),
+		 pkt.fluid_pressure);
+
+}
+
+int imu_log_parse_payload(const char* str, const char* end, ImuPacket& pkt)
+{
+
+  char buf[IMU_LOG_MAX_PAYLOAD];
+  double v[IMU_LOG_NUM_FIELDS];
+  int num = 0;
+
+  // strtod needs a terminated string
+  if(end != NULL)
+    {
+      size_t len = end - str;
+      if(len >= sizeof(buf))
+	return -1;
+      memcpy(buf, str, len);
+      buf[len] = '\0';
+      str = buf;
+    }
+
+  const char* p = str;
+
+  while(num < IMU_LOG_NUM_FIELDS)
+    {
+      while(*p == ',' || *p == ' ' || *p == '\t')
+	p++;
+
+      char* next;
+      v[num] = strtod(p, &next);
+      if(next == p)
+	break;
+
+      p = next;
+      num++;
+    }
+
+  if(num < IMU_LOG_NUM_FIELDS-1)
+    return -1;
+
+  pkt.t       = v[0];
+  pkt.seq_num = (int) v[1];
+  pkt.ang     = Eigen::Vector3d(v[2], v[3], v[4]);
+  pkt.acc     = Eigen::Vector3d(v[5], v[6], v[7]);
+  pkt.mag     = Eigen::Vector3d(v[8], v[9], v[10]);
+  pkt.fluid_pressure = (num == IMU_LOG_NUM_FIELDS) ? (float) v[11] : 0.0f;
+
+  return 0;
+
+}
+
+int imu_log_parse_record(const char* line, const char* end, ImuPacket& pkt)
+{
+
+  DslRecordView rec;
+
+  if(text_scan_split_dsl(line, end, rec) != 0)
+    return -1;
+
+  return imu_log_parse_payload(rec.payload.p, rec.payload.p + rec.payload.len, pkt);
+
+}
+
+int imu_log_load(const char* filename, std::vector<ImuPacket>& pkts)
+{
+
+  FILE* fp = fopen(filename, "rb");
+  if(fp == NULL)
+    return -1;
+
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  if(size < 0)
+    {
+      fclose(fp);
+      return -1;
+    }
+
+  std::vector<char> data(size + 1);
+  size_t len = fread(&data[0], 1, size, fp);
+  fclose(fp);
+
+  const char* p = &data[0];
+  const char* end = p + len;
+  int num = 0;
+
+  pkts.reserve(pkts.size() + len/128);
+
+  while(p < end)
+    {
+      const char* eol = (const char*) memchr(p, '\n', end - p);
+      if(eol == NULL)
+	eol = end;
+
+      ImuPacket pkt;
+      if(imu_log_parse_record(p, eol, pkt) == 0)
+	{
+	  pkt.dt = (num > 0) ? pkt.t - pkts.back().t : 0.0;
+	  pkts.push_back(pkt);
+	  num++;
+	}
+
+      p = eol + 1;
+    }
+
+  return num;
+
+}
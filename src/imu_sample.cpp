@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of imu_sample.h.
+ *
+ */
+
+#include <string.h>
+#include <helper_funcs/imu_sample.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+ImuSample imu_sample_init(int hz)
+{
+
+  ImuSample s;
+  memset(&s, 0, sizeof(s));
+
+  // same initial values as GyroData::GyroData()
+  s.hz = hz;
+  s.seq_num = 500;
+  s.num_status = 6;
+  s.diff = 1.0/((double)hz);
+
+  return s;
+
+}
+
+ImuSample imu_sample_from_gyro(const GyroData& g)
+{
+
+  ImuSample s;
+  memset(&s, 0, sizeof(s));
+
+  s.ang_vec() = g.ang;
+  s.acc_vec() = g.acc;
+  s.mag_vec() = g.mag;
+
+  s.timestamp      = g.timestamp;
+  s.comp_timestamp = g.comp_timestamp;
+  s.diff           = g.diff;
+  s.t_start        = g.t_start;
+  s.hz             = g.hz;
+  s.temp           = g.temp;
+  s.fluid_pressure = g.fluid_pressure;
+  s.seq_num        = g.seq_num;
+
+  s.num_status = (g.status.size() < IMU_SAMPLE_MAX_STATUS) ? g.status.size() : IMU_SAMPLE_MAX_STATUS;
+  for(int i=0; i<s.num_status; i++)
+    if(g.status[i])
+      s.status |= (1u << i);
+
+  return s;
+
+}
+
+void imu_sample_to_gyro(const ImuSample& s, GyroData& g)
+{
+
+  g.ang = s.ang_vec();
+  g.acc = s.acc_vec();
+  g.mag = s.mag_vec();
+
+  g.timestamp      = s.timestamp;
+  g.comp_timestamp = s.comp_timestamp;
+  g.diff           = s.diff;
+  g.t_start        = s.t_start;
+  g.hz             = s.hz;
+  g.temp           = s.temp;
+  g.fluid_pressure = s.fluid_pressure;
+  g.seq_num        = s.seq_num;
+
+  g.status.resize(s.num_status);
+  for(int i=0; i<s.num_status; i++)
+    g.status[i] = s.status_bit(i);
+
+}
+
+ImuSample imu_sample_from_packet(const ImuPacket& p)
+{
+
+  ImuSample s;
+  memset(&s, 0, sizeof(s));
+
+  s.ang_vec() = p.ang;
+  s.acc_vec() = p.acc;
+  s.mag_vec() = p.mag;
+
+  s.timestamp      = p.t;
+  s.diff           = p.dt;
+  s.fluid_pressure = p.fluid_pressure;
+  s.seq_num        = (uint32_t) p.seq_num;
+
+  return s;
+
+}
+
+ImuPacket imu_sample_to_packet(const ImuSample& s)
+{
+
+  ImuPacket p;
+
+  p.ang = s.ang_vec();
+  p.acc = s.acc_vec();
+  p.mag = s.mag_vec();
+
+  p.t              = s.timestamp;
+  p.dt             = s.diff;
+  p.fluid_pressure = s.fluid_pressure;
+  p.seq_num        = (int) s.seq_num;
+
+  return p;
+
+}
@@ -0,0 +1,342 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of ingest.h.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <algorithm>
+#include <helper_funcs/ingest.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/imu_log.h>
+#include <helper_funcs/thread_pool.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+static double ingest_now(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// one piece of one file and what it parsed to
+struct IngestChunk
+{
+
+  int file;
+  size_t begin;
+  size_t end;
+  ImuBatch batch;
+  uint64_t bad;
+  uint64_t untimed; // leading samples timed from 0 by the chunk's own parser
+
+};
+
+// split one mapped file into chunks at record boundaries
+static void ingest_split(int file, const uint8_t* data, size_t size, int format,
+			 double hz, size_t chunk_bytes, std::vector<IngestChunk>& chunks)
+{
+
+  BinlogParser parser(format, hz);
+  size_t begin = 0;
+
+  while(begin < size)
+    {
+      size_t end = begin + chunk_bytes;
+
+      if(end >= size)
+	end = size;
+      else if(format == BINLOG_FORMAT_UNKNOWN)
+	{
+	  const void* nl = memchr(data + end, '\n', size - end);
+	  end = (nl == NULL) ? size : (const uint8_t*) nl - data + 1;
+	}
+      else
+	end += parser.next_frame(data + end, size - end);
+
+      IngestChunk c;
+      c.file  = file;
+      c.begin = begin;
+      c.end   = end;
+      c.bad   = 0;
+      c.untimed = 0;
+      chunks.push_back(c);
+
+      begin = end;
+    }
+
+}
+
+// parse text IMU records in [p, end)
+static void ingest_parse_text(const char* p, const char* end, IngestChunk& c)
+{
+
+  ImuPacket pkt;
+
+  while(p < end)
+    {
+      const char* nl = (const char*) memchr(p, '\n', end - p);
+      const char* line_end = (nl == NULL) ? end : nl;
+
+      if(line_end > p)
+	{
+	  if(imu_log_parse_record(p, line_end, pkt) == 0)
+	    c.batch.push_back(pkt);
+	  else
+	    c.bad++;
+	}
+
+      p = line_end + 1;
+    }
+
+}
+
+// copy n samples of src into dst starting at sample j
+static void ingest_copy(ImuBatch& dst, size_t j, const ImuBatch& src, size_t n)
+{
+
+  for(int v=0; v<3; v++)
+    for(int k=0; k<3; k++)
+      memcpy(dst.axis((ImuVec) v, k) + j, src.axis((ImuVec) v, k), n*sizeof(double));
+  memcpy(dst.t() + j, src.t(), n*sizeof(double));
+  memcpy(dst.dt() + j, src.dt(), n*sizeof(double));
+  memcpy(dst.seq_num() + j, src.seq_num(), n*sizeof(int32_t));
+  memcpy(dst.fluid_pressure() + j, src.fluid_pressure(), n*sizeof(float));
+
+}
+
+// stable sort of samples [begin, end) by t
+static void ingest_sort(ImuBatch& out, size_t begin, size_t end)
+{
+
+  const double* t = out.t();
+  std::vector<size_t> idx(end - begin);
+
+  for(size_t i=0; i<idx.size(); i++)
+    idx[i] = begin + i;
+  std::stable_sort(idx.begin(), idx.end(), [t](size_t a, size_t b) { return t[a] < t[b]; });
+
+  ImuBatch sorted;
+  sorted.resize(idx.size());
+  for(size_t i=0; i<idx.size(); i++)
+    {
+      const size_t j = idx[i];
+      for(int v=0; v<3; v++)
+	for(int k=0; k<3; k++)
+	  sorted.axis((ImuVec) v, k)[i] = out.axis((ImuVec) v, k)[j];
+      sorted.t()[i]  = out.t()[j];
+      sorted.dt()[i] = out.dt()[j];
+      sorted.seq_num()[i] = out.seq_num()[j];
+      sorted.fluid_pressure()[i] = out.fluid_pressure()[j];
+    }
+
+  ingest_copy(out, begin, sorted, sorted.size());
+
+}
+
+int ingest_list_dir(const char* dir, const char* suffix, std::vector<std::string>& files)
+{
+
+  DIR* d = opendir(dir);
+  if(d == NULL)
+    return -1;
+
+  const std::string ext = std::string(".") + suffix;
+  std::vector<std::string> names;
+  dirent* e;
+
+  while((e = readdir(d)) != NULL)
+    {
+      const std::string name = e->d_name;
+      if(name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0)
+	names.push_back(name);
+    }
+  closedir(d);
+
+  std::sort(names.begin(), names.end());
+
+  for(size_t i=0; i<names.size(); i++)
+    files.push_back(std::string(dir) + "/" + names[i]);
+
+  return (int) names.size();
+
+}
+
+long ingest_files(const std::vector<std::string>& files, ImuBatch& out,
+		  IngestStats* stats, double hz, int num_threads, size_t chunk_bytes)
+{
+
+  const double t0 = ingest_now();
+  const int num_files = (int) files.size();
+  const int format = (num_files > 0) ? binlog_format_from_filename(files[0].c_str()) : BINLOG_FORMAT_UNKNOWN;
+
+  if(chunk_bytes == 0)
+    chunk_bytes = INGEST_CHUNK_BYTES;
+
+  // map and split
+  MappedFile* maps = new MappedFile[num_files];
+  std::vector<IngestChunk> chunks;
+  uint64_t bytes = 0;
+
+  for(int f=0; f<num_files; f++)
+    {
+      if(maps[f].open(files[f].c_str()) != 0)
+	{
+	  delete [] maps;
+	  return -1;
+	}
+      ingest_split(f, maps[f].data(), maps[f].size(), format, hz, chunk_bytes, chunks);
+      bytes += maps[f].size();
+    }
+
+  WorkStealingPool pool(num_threads);
+
+  // parse
+  pool.parallel_for((int) chunks.size(), [&](int i) {
+      IngestChunk& c = chunks[i];
+      const uint8_t* data = maps[c.file].data();
+
+      if(format == BINLOG_FORMAT_UNKNOWN)
+	ingest_parse_text((const char*) data + c.begin, (const char*) data + c.end, c);
+      else
+	{
+	  BinlogParser parser(format, hz);
+	  parser.parse(data + c.begin, c.end - c.begin, c.batch, true);
+	  c.bad = parser.stats().bad_checksum;
+	  c.untimed = parser.stats().untimed_leading;
+	}
+    });
+
+  delete [] maps;
+
+  // MIP without GPS time: carry the time on from the chunk before, as
+  // one parser over the files back to back would
+  if(format == BINLOG_FORMAT_MST)
+    {
+      bool have_prev = false;
+      double t_prev = 0.0;
+      double step = 0.0;
+
+      for(size_t i=0; i<chunks.size(); i++)
+	{
+	  ImuBatch& b = chunks[i].batch;
+	  const size_t n = b.size();
+	  if(n == 0)
+	    continue;
+
+	  if(have_prev)
+	    for(size_t k=0; k<chunks[i].untimed && k<n; k++)
+	      {
+		t_prev += step;
+		b.t()[k]  = t_prev;
+		b.dt()[k] = step;
+	      }
+
+	  t_prev = b.t()[n-1];
+	  step   = b.dt()[n-1];
+	  have_prev = true;
+	}
+    }
+
+  // order the chunks by their first sample (empty ones last); untimed
+  // KVH keeps file order
+  std::vector<int> order(chunks.size());
+  std::vector<double> first(chunks.size());
+  for(size_t i=0; i<order.size(); i++)
+    {
+      order[i] = (int) i;
+      first[i] = (chunks[i].batch.size() > 0) ? chunks[i].batch.t()[0] : HUGE_VAL;
+    }
+  if(format != BINLOG_FORMAT_KVH)
+    std::stable_sort(order.begin(), order.end(), [&first](int a, int b) { return first[a] < first[b]; });
+
+  // stitch
+  const size_t before = out.size();
+  std::vector<size_t> offset(chunks.size());
+  size_t total = 0;
+  uint64_t bad = 0;
+
+  for(size_t i=0; i<order.size(); i++)
+    {
+      offset[order[i]] = before + total;
+      total += chunks[order[i]].batch.size();
+      bad += chunks[order[i]].bad;
+    }
+
+  out.resize(before + total);
+
+  pool.parallel_for((int) chunks.size(), [&](int i) {
+      ingest_copy(out, offset[i], chunks[i].batch, chunks[i].batch.size());
+    });
+
+  // times
+  bool reordered = false;
+  double* t  = out.t();
+  double* dt = out.dt();
+
+  if(format == BINLOG_FORMAT_KVH)
+    {
+      const double step = (hz > 0.0) ? 1.0/hz : 0.0;
+      for(size_t i=0; i<total; i++)
+	{
+	  t[before + i]  = i*step;
+	  dt[before + i] = step;
+	}
+    }
+  else
+    {
+      for(size_t i=before+1; i<before+total && !reordered; i++)
+	reordered = t[i] < t[i-1];
+
+      if(reordered)
+	ingest_sort(out, before, before + total);
+
+      for(size_t i=0; i<total; i++)
+	dt[before + i] = (i > 0) ? t[before + i] - t[before + i - 1] : 0.0;
+    }
+
+  // MIP has no sequence number; each parser numbered its chunk from 0
+  if(format == BINLOG_FORMAT_MST)
+    {
+      int32_t* seq = out.seq_num();
+      for(size_t i=0; i<total; i++)
+	seq[before + i] = (int32_t) (i & 0x7FFFFFFF);
+    }
+
+  if(stats != NULL)
+    {
+      stats->files = num_files;
+      stats->chunks = (int) chunks.size();
+      stats->bytes = bytes;
+      stats->records = total;
+      stats->bad_records = bad;
+      stats->reordered = reordered;
+      stats->elapsed = ingest_now() - t0;
+    }
+
+  return (long) total;
+
+}
+
+long ingest_dir(const char* dir, const char* suffix, ImuBatch& out,
+		IngestStats* stats, double hz, int num_threads, size_t chunk_bytes)
+{
+
+  std::vector<std::string> files;
+
+  if(ingest_list_dir(dir, suffix, files) < 0)
+    return -1;
+
+  return ingest_files(files, out, stats, hz, num_threads, chunk_bytes);
+
+}
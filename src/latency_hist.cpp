@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of latency_hist.h.
+ *
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <helper_funcs/latency_hist.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+long long latency_hist_bucket_low(int bucket)
+{
+
+  if(bucket < (1 << LATENCY_HIST_SUB_BITS))
+    return bucket;
+
+  const int shift = (bucket >> LATENCY_HIST_SUB_BITS) - 1;
+  const long long sub = bucket & ((1 << LATENCY_HIST_SUB_BITS) - 1);
+
+  return ((1LL << LATENCY_HIST_SUB_BITS) + sub) << shift;
+
+}
+
+long long latency_hist_bucket_high(int bucket)
+{
+
+  if(bucket >= LATENCY_HIST_BUCKETS - 1)
+    return LLONG_MAX;
+  if(bucket < (1 << LATENCY_HIST_SUB_BITS))
+    return bucket;
+
+  return latency_hist_bucket_low(bucket + 1) - 1;
+
+}
+
+void LatencySnapshot::clear(void)
+{
+
+  memset(counts, 0, sizeof(counts));
+  count = 0;
+  sum_ns = 0;
+  max_ns = 0;
+
+}
+
+void LatencySnapshot::add(const LatencySnapshot& other)
+{
+
+  for(int i=0; i<LATENCY_HIST_BUCKETS; i++)
+    counts[i] += other.counts[i];
+  count += other.count;
+  sum_ns += other.sum_ns;
+  if(other.max_ns > max_ns)
+    max_ns = other.max_ns;
+
+}
+
+long long LatencySnapshot::percentile(double p) const
+{
+
+  if(count == 0)
+    return 0;
+
+  // rank of the value, 1 to count
+  uint64_t rank = (uint64_t) ceil(p*count);
+  if(rank < 1)
+    rank = 1;
+  if(rank > count)
+    rank = count;
+
+  uint64_t seen = 0;
+  for(int i=0; i<LATENCY_HIST_BUCKETS; i++)
+    {
+      seen += counts[i];
+      if(seen >= rank)
+	{
+	  // the max can lag the buckets by a value recorded during the swap
+	  const long long high = latency_hist_bucket_high(i);
+	  const long long low = latency_hist_bucket_low(i);
+	  return high < max_ns ? high : (max_ns > low ? max_ns : low);
+	}
+    }
+
+  return max_ns;
+
+}
+
+LatencyHistogram::LatencyHistogram(void) : sum(0), max(0)
+{
+
+  for(int i=0; i<LATENCY_HIST_BUCKETS; i++)
+    counts[i].store(0, std::memory_order_relaxed);
+
+}
+
+void LatencyHistogram::snapshot_and_reset(LatencySnapshot& snap)
+{
+
+  snap.count = 0;
+  for(int i=0; i<LATENCY_HIST_BUCKETS; i++)
+    {
+      // most buckets are empty; skip the write for them
+      snap.counts[i] = counts[i].load(std::memory_order_relaxed) ? counts[i].exchange(0, std::memory_order_relaxed) : 0;
+      snap.count += snap.counts[i];
+    }
+  snap.sum_ns = sum.exchange(0, std::memory_order_relaxed);
+  snap.max_ns = max.exchange(0, std::memory_order_relaxed);
+
+}
@@ -12,6 +12,11 @@
                          Added second attempt to fclose if first fails.
    02 JUN 2005 LLW  Added logging of all targets at top of new CSV file
    2018-07-18 LLW Modified for standalone use without rov 
+   2026-10-19   AGT      Added optional sidecar time index, see log_index.h
+   2026-10-19   AGT      log_clean_string() uses the vectorized text_scan.h
+   2026-10-19   AGT      Added the trace channel and trace spans, see trace.h
+   2026-10-19   AGT      Added latency histograms and the latency channel
+   2026-10-19   AGT      Added the shared memory flight recorder, see flight_rec.h
 
 ---------------------------------------------------------------------- */
 /* standard ansi C header files */
@@ -21,6 +26,8 @@
 #include <ctype.h>
 #include <sys/types.h>
 #include <time.h>
+#include <errno.h>
+#include <mutex>
 
 // #include <vcl/syncobjs.hpp>
 
@@ -32,6 +39,10 @@
 #include "helper_funcs/log.h"      	        /* log utils */
 #include "helper_funcs/time_util.h"		/* time utils */
 #include "helper_funcs/stderr.h"		/* stderr print util */
+#include "helper_funcs/text_scan.h"		/* vectorized string scans */
+#include "helper_funcs/trace.h"		/* trace spans */
+#include "helper_funcs/latency_hist.h"	/* latency histograms */
+#include "helper_funcs/flight_rec.h"		/* shared memory flight recorder */
 
 // TCriticalSection * LogCritSec = NULL;
 
@@ -45,6 +56,13 @@ typedef struct {
   int                log_file_bytes_per_sec;
   double             log_file_bytes_per_sec_lowpass;
   int                log_file_last_hour_or_day;
+  // 2026-10-19 sidecar time index
+  FILE             * log_index_pointer;
+  int                log_index_every_records;   /* 0 = not by record count */
+  int                log_index_every_ms;        /* 0 = not by time */
+  int                log_index_records_since;
+  long long          log_index_last_ns;
+  unsigned long long log_file_offset;           /* current size of the log file */
 } logging_t;
 
 
@@ -57,6 +75,8 @@ static logging_t log[LOG_MAX_NUM_LOG_FILES+1] = {{1, (char *) LOG_FID_KVH_SUFFIX
 						 {1, (char *) LOG_FID_KVH_BINARY_SUFFIX},
 						 {1, (char *) LOG_FID_MST_FILT_SUFFIX},
 						 {1, (char *) LOG_FID_PHINS_BINARY_SUFFIX},
+						 {1, (char *) LOG_FID_TRACE_SUFFIX},
+						 {1, (char *) LOG_FID_LATENCY_SUFFIX},
 						 {0, NULL}
 };
 
@@ -79,6 +99,8 @@ static char * cfg_data_log_dir[LOG_MAX_NUM_LOG_FILES+1] = {(char *) "/log/kvh",
 							   (char *) "/log/kvh",
 							   (char *) "/log/microstrain",
 							   (char *) "/log/phins",
+							   (char *) "/log/trace",
+							   (char *) "/log/latency",
 							   NULL};
 
 char * PNS_LOG_STRING[65535];
@@ -86,6 +108,63 @@ char * PAS_LOG_STRING[65535];
 
 char  CSV_SCIENCE_LABEL_STR[]  = "Col 1 label, Col 2 label, ....";
 
+// 2026-10-19 latency histograms, recorded from any thread, and the last
+//            second's snapshot of each, under log_latency_mutex
+static LatencyHistogram log_latency[LOG_MAX_NUM_LOG_FILES][LOG_LATENCY_NUM];
+static LatencySnapshot  log_latency_last[LOG_MAX_NUM_LOG_FILES][LOG_LATENCY_NUM];
+static std::mutex       log_latency_mutex;
+static int              log_latency_log_flag = 0;
+
+static const char * log_latency_name[LOG_LATENCY_NUM] = {"write", "rotate", "queue"};
+
+// 2026-10-19 flight recorder of each channel, NULL when off
+static FlightRecorder * log_flight[LOG_MAX_NUM_LOG_FILES];
+
+
+static void log_latency_log_snapshots(void);
+
+
+/* ---------------------------------------------------------------------- */
+static void log_flight_write(int log_fid, const char * record_name, const char * time_str,
+			     const char * record_data, int len)
+
+  /*
+
+   Copies a record into the channel's flight recorder, if it has one,
+   as the log file gets it: "name time data\n" for a dsl format record,
+   "data\n" for a string (len -1), or len bytes of binary data.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+  struct iovec iov[6];
+  int n = 0;
+
+  if(log_flight[log_fid] == NULL)
+    return;
+
+  if(record_name != NULL)
+    {
+      iov[n].iov_base = (void *) record_name;  iov[n++].iov_len = strlen(record_name);
+      iov[n].iov_base = (void *) " ";          iov[n++].iov_len = 1;
+      iov[n].iov_base = (void *) time_str;     iov[n++].iov_len = strlen(time_str);
+      iov[n].iov_base = (void *) " ";          iov[n++].iov_len = 1;
+    }
+  iov[n].iov_base = (void *) record_data;
+  iov[n++].iov_len = (len < 0) ? strlen(record_data) : (size_t) len;
+  if(len < 0)
+    {
+      iov[n].iov_base = (void *) "\n";         iov[n++].iov_len = 1;
+    }
+
+  log_flight[log_fid]->write(iov, n);
+
+}
+
 
 /* ---------------------------------------------------------------------- */
 int log_bytes_per_sec(void)
@@ -120,10 +199,13 @@ void log_one_hertz_update(void)
    DATE         WHO             WHAT
    -----------  --------------  ----------------------------
    20 Mar 2001  Louis Whitcomb  Created and Written
+   2026-10-19   AGT             Snapshot and reset the latency histograms,
+                                and log the snapshots if enabled
 
    ---------------------------------------------------------------------- */
 {
   int i;
+  int k;
 
   for(i=0; i<LOG_MAX_NUM_LOG_FILES; i++)
     {
@@ -136,6 +218,219 @@ void log_one_hertz_update(void)
       log[i].log_file_bytes_written_last = log[i].log_file_bytes_written;
     }
 
+  // 2026-10-19 the last second's latencies
+  {
+    std::lock_guard<std::mutex> lock(log_latency_mutex);
+
+    for(i=0; i<LOG_MAX_NUM_LOG_FILES; i++)
+      for(k=0; k<LOG_LATENCY_NUM; k++)
+	log_latency[i][k].snapshot_and_reset(log_latency_last[i][k]);
+  }
+
+  if(log_latency_log_flag)
+    log_latency_log_snapshots();
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+static int log_latency_sprintf(char * str, int len, const char * what, const LatencySnapshot & snap)
+
+  /*
+
+   Appends " what n N p50_us ... max_us M" for one histogram.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  if(snap.count == 0)
+    return snprintf(str, len, " %s n 0", what);
+
+  return snprintf(str, len, " %s n %llu p50_us %.1f p90_us %.1f p99_us %.1f p999_us %.1f max_us %.1f mean_us %.1f",
+		  what,
+		  (unsigned long long) snap.count,
+		  1e-3*snap.percentile(0.50),
+		  1e-3*snap.percentile(0.90),
+		  1e-3*snap.percentile(0.99),
+		  1e-3*snap.percentile(0.999),
+		  1e-3*snap.max_ns,
+		  1e-3*snap.mean());
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void log_latency_log_snapshots(void)
+
+  /*
+
+   Writes one LAT record per channel with any latencies in the last
+   second to LOG_FID_LATENCY_FORMAT:
+
+   LAT YYYY/MM/DD HH:MM:SS.SSS KVH write n 1000 p50_us 3.2 ... rotate n 0 queue n 0
+
+   The latency channel's own writes are left out.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+  LatencySnapshot snap[LOG_LATENCY_NUM];
+  char record[1024];
+  int  i;
+  int  k;
+  int  n;
+  int  any;
+
+  for(i=0; i<LOG_MAX_NUM_LOG_FILES; i++)
+    {
+      if(i == LOG_FID_LATENCY_FORMAT)
+	continue;
+
+      any = 0;
+      for(k=0; k<LOG_LATENCY_NUM; k++)
+	{
+	  log_latency_snapshot(i, k, &snap[k]);
+	  any += (snap[k].count != 0);
+	}
+      if(!any)
+	continue;
+
+      n = snprintf(record, sizeof(record), "%s", log[i].log_file_name_suffix);
+      for(k=0; k<LOG_LATENCY_NUM && n < (int) sizeof(record); k++)
+	n += log_latency_sprintf(record + n, sizeof(record) - n, log_latency_name[k], snap[k]);
+
+      log_this_now_dsl_format(LOG_FID_LATENCY_FORMAT, (char *) LOG_FID_LATENCY_SUFFIX, record);
+    }
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+void log_record_queue_wait(int log_fid, long long wait_ns)
+
+  /*
+
+   For producers that queue records for a writer thread: the time from
+   queueing a record to writing it.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  if((log_fid >= 0) && (log_fid < LOG_MAX_NUM_LOG_FILES))
+    log_latency[log_fid][LOG_LATENCY_QUEUE].record(wait_ns);
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+int log_latency_snapshot(int log_fid, int which, LatencySnapshot * snap)
+
+  /*
+
+   Copies the last second's snapshot of one histogram.  Returns -1 for
+   a bad log_fid or which.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  if((log_fid < 0) || (log_fid >= LOG_MAX_NUM_LOG_FILES) || (which < 0) || (which >= LOG_LATENCY_NUM))
+    return -1;
+
+  std::lock_guard<std::mutex> lock(log_latency_mutex);
+  *snap = log_latency_last[log_fid][which];
+
+  return 0;
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+long long log_latency_percentile(int log_fid, int which, double p)
+
+  /*
+
+   Percentile p (0.99 for p99) of the last second's latencies, in ns,
+   0 if there were none, -1 for a bad log_fid or which.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  if((log_fid < 0) || (log_fid >= LOG_MAX_NUM_LOG_FILES) || (which < 0) || (which >= LOG_LATENCY_NUM))
+    return -1;
+
+  std::lock_guard<std::mutex> lock(log_latency_mutex);
+
+  return log_latency_last[log_fid][which].percentile(p);
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+long long log_latency_count(int log_fid, int which)
+
+  /*
+
+   Number of latencies in the last second, -1 for a bad log_fid or which.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  if((log_fid < 0) || (log_fid >= LOG_MAX_NUM_LOG_FILES) || (which < 0) || (which >= LOG_LATENCY_NUM))
+    return -1;
+
+  std::lock_guard<std::mutex> lock(log_latency_mutex);
+
+  return (long long) log_latency_last[log_fid][which].count;
+
+}
+
+
+/* ---------------------------------------------------------------------- */
+void log_set_latency_log(int enable)
+
+  /*
+
+   Turns the LAT records of log_one_hertz_update() on or off.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written
+
+   ---------------------------------------------------------------------- */
+{
+
+  log_latency_log_flag = enable;
+
 }
 
 
@@ -183,6 +478,304 @@ int log_get_log_status(int log_fid)
     return 0;
 }
 
+/* ---------------------------------------------------------------------- */
+static void log_close_index_file(int log_fid, int remove_it)
+
+  /*
+    Closes the sidecar index of a log file, and deletes it if asked.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  char filename[1024];
+
+  if(log[log_fid].log_index_pointer == NULL)
+    return;
+
+  fclose(log[log_fid].log_index_pointer);
+  log[log_fid].log_index_pointer = NULL;
+
+  if(remove_it)
+    {
+      snprintf(filename, sizeof(filename), "%s.%s", log[log_fid].log_file_name, LOG_INDEX_SUFFIX);
+      remove(filename);
+    }
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void log_open_index_file(int log_fid)
+
+  /*
+    Opens the sidecar index "<log file>.idx" of the current log file
+    when indexing is enabled.  An existing index is appended to, as the
+    log file itself is; the next record is always indexed.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  char filename[1024];
+  log_index_header_t header;
+
+  log_close_index_file(log_fid, 0);
+
+  log[log_fid].log_index_records_since = 0;
+  log[log_fid].log_index_last_ns = ROV_TIME_NS_INVALID;
+
+  if((log[log_fid].log_file_pointer == NULL) ||
+     ((log[log_fid].log_index_every_records <= 0) && (log[log_fid].log_index_every_ms <= 0)))
+    return;
+
+  snprintf(filename, sizeof(filename), "%s.%s", log[log_fid].log_file_name, LOG_INDEX_SUFFIX);
+  log[log_fid].log_index_pointer = fopen(filename, "ab");
+
+  if(log[log_fid].log_index_pointer == NULL)
+    {
+      stderr_printf("ERROR: Log index file %s failed to open.\n", filename);
+      return;
+    }
+
+  fseek(log[log_fid].log_index_pointer, 0, SEEK_END);
+  if(ftell(log[log_fid].log_index_pointer) == 0)
+    {
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic));
+      header.version = LOG_INDEX_VERSION;
+      fwrite(&header, sizeof(header), 1, log[log_fid].log_index_pointer);
+    }
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void log_index_this_record(int log_fid, char * dsl_date_time_str)
+
+  /*
+    Adds an index entry for the record about to be written at the
+    current end of the log file, if one is due: for the first record of
+    a file, then every log_index_every_records records or
+    log_index_every_ms milliseconds, whichever comes first.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  logging_t * l = &log[log_fid];
+  log_index_entry_t entry;
+  long long t;
+  int due;
+
+  if(l->log_index_pointer == NULL)
+    return;
+
+  t = rov_parse_dsl_time_string_ns(dsl_date_time_str, NULL, NULL);
+  if(t == ROV_TIME_NS_INVALID)
+    return;
+
+  l->log_index_records_since++;
+
+  due = (l->log_index_last_ns == ROV_TIME_NS_INVALID) ||
+    ((l->log_index_every_records > 0) && (l->log_index_records_since >= l->log_index_every_records)) ||
+    ((l->log_index_every_ms > 0) && (t - l->log_index_last_ns >= l->log_index_every_ms * 1000000LL));
+
+  if(!due)
+    return;
+
+  entry.time_ns = t;
+  entry.offset  = l->log_file_offset;
+  fwrite(&entry, sizeof(entry), 1, l->log_index_pointer);
+
+  l->log_index_last_ns = t;
+  l->log_index_records_since = 0;
+}
+
+
+/* ---------------------------------------------------------------------- */
+void log_set_index_interval(int log_fid, int every_records, int every_ms)
+
+  /*
+    Enables the sidecar time index for a log channel, or disables it if
+    both intervals are 0.  Takes effect immediately for an open log file.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  if (inrange(log_fid, 0, LOG_MAX_NUM_LOG_FILES-1)==0)
+    return;
+
+  log[log_fid].log_index_every_records = (every_records > 0) ? every_records : 0;
+  log[log_fid].log_index_every_ms      = (every_ms > 0) ? every_ms : 0;
+
+  log_open_index_file(log_fid);
+}
+
+
+/* ---------------------------------------------------------------------- */
+void log_set_log_dir(int log_fid, char * dir)
+
+  /*
+    Sets the log directory of a log channel.  The string is not copied.
+    Takes effect when the next log file is opened.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  if (inrange(log_fid, 0, LOG_MAX_NUM_LOG_FILES-1)==0)
+    return;
+
+  cfg_data_log_dir[log_fid] = dir;
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void log_flight_close_all(void)
+
+  /*
+    Closes every flight recorder at a normal exit, so the next start
+    does not take their segments for a crash.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  int log_fid;
+
+  for(log_fid=0; log_fid<LOG_MAX_NUM_LOG_FILES; log_fid++)
+    if(log_flight[log_fid] != NULL)
+      {
+	delete log_flight[log_fid];
+	log_flight[log_fid] = NULL;
+      }
+}
+
+
+/* ---------------------------------------------------------------------- */
+void log_flight_name(int log_fid, char * name, int len)
+
+  /*
+    Shared memory segment name of a channel's flight recorder:
+    "/<program name>_<suffix>", e.g. /dev/shm/kvh_node_KVH.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  if (inrange(log_fid, 0, LOG_MAX_NUM_LOG_FILES-1)==0)
+    {
+      snprintf(name, len, "/%s_%d", program_invocation_short_name, log_fid);
+      return;
+    }
+
+  snprintf(name, len, "/%s_%s", program_invocation_short_name, log[log_fid].log_file_name_suffix);
+}
+
+
+/* ---------------------------------------------------------------------- */
+int log_set_flight_recorder(int log_fid, long long bytes, double recover_seconds)
+
+  /*
+    Turns on the flight recorder of a log channel, a ring of bytes in
+    shared memory (log_flight_name()) that gets a copy of every record
+    written to the channel and survives a crash; bytes 0 turns it off.
+    Call it before the channel is written from other threads.
+
+    A segment of the same name left by a run that died is first dumped,
+    its last recover_seconds (0 for all), next to the log files as
+    YYYY_MM_DD_HH_MM_SS_crash.<suffix>.  One that another run of the
+    program still has open is left alone, and this run gets no recorder.
+
+    Returns the number of records recovered, or -1 if the recorder could
+    not be created.
+
+    MODIFICATION HISTORY
+    DATE         WHO             WHAT
+    -----------  --------------  ----------------------------
+    2026-10-19   AGT             Created and written
+
+    ---------------------------------------------------------------------- */
+{
+  static int  registered = 0;
+  char        name[256];
+  char        crash_file[1024];
+  int         recovered;
+  rov_time_struct_t now;
+
+  if (inrange(log_fid, 0, LOG_MAX_NUM_LOG_FILES-1)==0)
+    return -1;
+
+  log_flight_name(log_fid, name, sizeof(name));
+
+  if(bytes <= 0)
+    {
+      delete log_flight[log_fid];
+      log_flight[log_fid] = NULL;
+      return 0;
+    }
+
+  // a segment a crashed run left behind
+  now = rov_get_time_struct();
+  snprintf(crash_file, sizeof(crash_file), "%s/%04d_%02d_%02d_%02d_%02d_%02d_crash.%s",
+	   cfg_data_log_dir[log_fid],
+	   now.year,
+	   now.month,
+	   now.day,
+	   now.hour,
+	   now.min,
+	   now.sec_int,
+	   log[log_fid].log_file_name_suffix);
+
+  recovered = flight_rec_recover(name, crash_file, recover_seconds);
+  if(recovered > 0)
+    stderr_printf("LOG: Recovered   %d records of a crashed run from /dev/shm%s to %s.\n", recovered, name, crash_file);
+  else if(recovered < 0)
+    stderr_printf("LOG: ERROR recovering /dev/shm%s to %s !!\n", name, crash_file);
+
+  if(log_flight[log_fid] == NULL)
+    log_flight[log_fid] = new FlightRecorder;
+
+  if(log_flight[log_fid]->open(name, (size_t) bytes) != 0)
+    {
+      stderr_printf("LOG: ERROR creating flight recorder /dev/shm%s (%s) !!\n", name,
+		    (errno == EBUSY) ? "in use by another running process" : strerror(errno));
+      delete log_flight[log_fid];
+      log_flight[log_fid] = NULL;
+      return -1;
+    }
+
+  if(!registered)
+    {
+      atexit(log_flight_close_all);
+      registered = 1;
+    }
+
+  return (recovered > 0) ? recovered : 0;
+}
+
+
 /* ---------------------------------------------------------------------- */
 static int log_open_log_file(int log_fid)
 
@@ -197,6 +790,7 @@ static int log_open_log_file(int log_fid)
     09 JAN 2004 LLW Modified to use time_util.cpp
     02 JUN 2005 LLW  Added logging of all targets at top of new CSV file
     2018-08-20 LLW Commented out static and added local var for "filename"
+    2026-10-19   AGT     Track the file offset and open the sidecar time index
 
     ---------------------------------------------------------------------- */
 
@@ -228,6 +822,7 @@ static int log_open_log_file(int log_fid)
 	  fclose(log[log_fid].log_file_pointer);
 	  log[log_fid].log_file_pointer = NULL;
 	}
+      log_close_index_file(log_fid, 0);
     }
 
   // fflush the data file
@@ -260,7 +855,11 @@ static int log_open_log_file(int log_fid)
       last_hour[log_fid] = now.hour;
       last_day[log_fid]  = now.day;
 
+      TRACE_SPAN("log", "log_rotate");
+      long long rotate_t0 = rov_get_clock_ns();
+
       /* close existing log file */
+      log_close_index_file(log_fid, 0);
       if(log[log_fid].log_file_pointer != NULL)
 	{
 	  if(0== fclose(log[log_fid].log_file_pointer))
@@ -316,13 +915,26 @@ static int log_open_log_file(int log_fid)
 	  strcpy(log[log_fid].log_file_name, filename);
 	  stderr_printf("LOG: Opened      log file %s OK.\n",log[log_fid].log_file_name);
 
+	  // 2026-10-19 index offsets are from the start of the file, which
+	  //            may already hold data when appending
+	  fseek(log[log_fid].log_file_pointer, 0, SEEK_END);
+	  log[log_fid].log_file_offset = ftell(log[log_fid].log_file_pointer);
+	  log_open_index_file(log_fid);
+
 	  // if we have opened a new spreadsheet file, log column labels
 	  if( log_fid == LOG_FID_CSV_FORMAT)
             {
 	      log_this_now( LOG_FID_CSV_FORMAT, CSV_SCIENCE_LABEL_STR);
             }
+
+	  // 2026-10-19 a new trace file opens the JSON array
+	  if((log_fid == LOG_FID_TRACE_FORMAT) && (log[log_fid].log_file_offset == 0))
+            {
+	      log_this_now( LOG_FID_TRACE_FORMAT, (char *) "[");
+            }
 	}
 
+      log_latency[log_fid][LOG_LATENCY_ROTATE].record(rov_get_clock_ns() - rotate_t0);
     }
 
   //   LogCritSec->Acquire();
@@ -341,16 +953,12 @@ void log_clean_string(char * str)
    DATE         WHO             WHAT
    -----------  --------------  ----------------------------
    18 Apr 1999  Louis Whitcomb  Created and Written based on Dana's original write_dvl
+   2026-10-19   AGT             Replace 16 bytes at a time with text_scan_clean()
 
    ---------------------------------------------------------------------- */
 {
 
-  while(*str != '\0')
-    {
-      if((*str == '\n') || (*str == '\r'))
-	*str = ' ';
-      str++;
-    }
+  text_scan_clean(str, strlen(str), TEXT_SCAN_CLEAN_EOL);
 
 }
 
@@ -369,10 +977,15 @@ int log_this_now_dsl_format(int log_fid,
    DATE         WHO             WHAT
    -----------  --------------  ----------------------------
    18 Apr 1999  Louis Whitcomb  Created and Written based on Dana's original write_dvl
+   2026-10-19   AGT             Index the record in the sidecar time index
+   2026-10-19   AGT             Trace span and write latency
+   2026-10-19   AGT             Flight recorder
 
    ---------------------------------------------------------------------- */
 
 {
+  TRACE_SPAN("log", "log_this_now_dsl_format");
+  long long t0 = rov_get_clock_ns();
   char dsl_date_time_str[128];
   int len;
 
@@ -398,23 +1011,32 @@ int log_this_now_dsl_format(int log_fid,
 	// generate a date time string
 	rov_sprintf_dsl_time_string(dsl_date_time_str);
 
+	// 2026-10-19 index it at the offset it is about to be written at
+	log_index_this_record(log_fid, dsl_date_time_str);
+
 	/* prepend record name and timestamp and write it to the log file */
 	len = fprintf(log[log_fid].log_file_pointer,"%s %s %s\n", record_name, dsl_date_time_str, record_data);
+	log_flight_write(log_fid, record_name, dsl_date_time_str, record_data, -1);
 
 	// update the stats
 	log[log_fid].log_file_bytes_written += len;
+	log[log_fid].log_file_offset += len;
 
       }
     else
       {
 	/* write to file */
 	len = fprintf(log[log_fid].log_file_pointer,"%s\n",record_data);
+	log_flight_write(log_fid, NULL, NULL, record_data, -1);
 
 	// update the stats
 	log[log_fid].log_file_bytes_written += len;
+	log[log_fid].log_file_offset += len;
 
       }
 
+  log_latency[log_fid][LOG_LATENCY_WRITE].record(rov_get_clock_ns() - t0);
+
   // leave critical section
   //   LogCritSec->Release();
 
@@ -433,10 +1055,14 @@ int log_this_now(int log_fid, char * record_data)
    DATE         WHO             WHAT
    -----------  --------------  ----------------------------
    13 Apr 2002   Louis Whitcomb  Created and Written
+   2026-10-19   AGT              Trace span and write latency
+   2026-10-19   AGT              Flight recorder
 
    ---------------------------------------------------------------------- */
 
 {
+  TRACE_SPAN("log", "log_this_now");
+  long long t0 = rov_get_clock_ns();
   char dsl_date_time_str[128];
   int len;
 
@@ -460,12 +1086,16 @@ int log_this_now(int log_fid, char * record_data)
     {
       /* write to file */
       len = fprintf(log[log_fid].log_file_pointer,"%s\n",record_data);
+      log_flight_write(log_fid, NULL, NULL, record_data, -1);
 
       // update the stats
       log[log_fid].log_file_bytes_written += len;
+      log[log_fid].log_file_offset += len;
 
     }
 
+  log_latency[log_fid][LOG_LATENCY_WRITE].record(rov_get_clock_ns() - t0);
+
   // leave critical section
   //  LogCritSec->Release();
 
@@ -484,10 +1114,14 @@ int log_this_now(int log_fid, char * record_data, int len)
    -----------  --------------  ----------------------------
    13 Apr 2002   Louis Whitcomb  Created and Written
    07 DEC 2005   LLW             Created this version to accomodate binary data
+   2026-10-19   AGT              Trace span and write latency
+   2026-10-19   AGT              Flight recorder
 
    ---------------------------------------------------------------------- */
 
 {
+  TRACE_SPAN("log", "log_this_now_binary");
+  long long t0 = rov_get_clock_ns();
   int i;
   int bytes_written;
   unsigned char * data;
@@ -517,6 +1151,7 @@ int log_this_now(int log_fid, char * record_data, int len)
       //  fputc(record_data[i], log[log_fid].log_file_pointer);
 
       bytes_written = fwrite(record_data, 1,  len,   log[log_fid].log_file_pointer);
+      log_flight_write(log_fid, NULL, NULL, record_data, len);
 
       // for debug
       // fflush(log[log_fid].log_file_pointer );
@@ -525,10 +1160,13 @@ int log_this_now(int log_fid, char * record_data, int len)
 
       // update the stats
       log[log_fid].log_file_bytes_written += bytes_written;
+      log[log_fid].log_file_offset += bytes_written;
 
 
     }
 
+  log_latency[log_fid][LOG_LATENCY_WRITE].record(rov_get_clock_ns() - t0);
+
   // leave critical section
   //  LogCritSec->Release();
 
@@ -574,6 +1212,7 @@ void log_flush_and_close_log_files(void)
 	  fclose(log[log_fid].log_file_pointer);
 	  log[log_fid].log_file_pointer = NULL;
 	}
+      log_close_index_file(log_fid, 0);
 
       // close any remaining open files, e.g. stdout, stdin
       //_fcloseall();
@@ -629,6 +1268,7 @@ void log_flush_and_close_and_delete_current_log_files(void)
 	  log[log_fid].log_file_pointer = NULL;
 
           //delete current files
+          log_close_index_file(log_fid, 1);
           remove(log[log_fid].log_file_name);
 	}
 
@@ -0,0 +1,227 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of log_index.h.
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <helper_funcs/log_index.h>
+#include <helper_funcs/log_merge.h>
+#include <helper_funcs/ingest.h>
+#include <helper_funcs/thread_pool.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+std::string log_index_filename(const char* log_filename)
+{
+  return std::string(log_filename) + "." + LOG_INDEX_SUFFIX;
+}
+
+int LogIndex::open(const char* log_filename)
+{
+
+  close();
+
+  if(map.open(log_index_filename(log_filename).c_str()) != 0)
+    return -1;
+
+  const log_index_header_t* header = (const log_index_header_t*) map.data();
+
+  if(map.size() < sizeof(log_index_header_t) ||
+     memcmp(header->magic, LOG_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+     header->version != LOG_INDEX_VERSION)
+    {
+      close();
+      return -1;
+    }
+
+  entries = (const log_index_entry_t*) (map.data() + sizeof(log_index_header_t));
+  num = (map.size() - sizeof(log_index_header_t))/sizeof(log_index_entry_t);
+
+  return 0;
+
+}
+
+void LogIndex::close(void)
+{
+
+  map.close();
+  entries = NULL;
+  num = 0;
+
+}
+
+uint64_t LogIndex::offset_before(int64_t t_ns) const
+{
+
+  // first entry with time > t_ns
+  const log_index_entry_t* e = std::upper_bound(entries, entries + num, t_ns,
+						 [](int64_t t, const log_index_entry_t& a) { return t < a.time_ns; });
+
+  return (e == entries) ? 0 : (e - 1)->offset;
+
+}
+
+// offset of the first timestamped line in [p, end) with time >= t_ns
+static const char* log_index_scan(const char* p, const char* end, int64_t t_ns)
+{
+
+  while(p < end)
+    {
+      const char* nl = (const char*) memchr(p, '\n', end - p);
+      const char* le = (nl == NULL) ? end : nl;
+      const int64_t t = log_merge_parse_time(p, le);
+
+      if(t != LOG_MERGE_BAD_TIME && t >= t_ns)
+	return p;
+
+      p = (nl == NULL) ? end : nl + 1;
+    }
+
+  return end;
+
+}
+
+long log_index_find(const char* log_filename, int64_t t_ns)
+{
+
+  MappedFile log;
+
+  if(log.open(log_filename) != 0)
+    return -1;
+
+  const char* data = (const char*) log.data();
+  const size_t size = log.size();
+  uint64_t start = 0;
+
+  LogIndex index;
+  if(index.open(log_filename) == 0)
+    start = std::min((uint64_t) size, index.offset_before(t_ns));
+
+  return (long) (log_index_scan(data + start, data + size, t_ns) - data);
+
+}
+
+FILE* log_index_open_at(const char* log_filename, int64_t t_ns)
+{
+
+  const long offset = log_index_find(log_filename, t_ns);
+
+  if(offset < 0)
+    return NULL;
+
+  FILE* fp = fopen(log_filename, "r");
+  if(fp != NULL && fseek(fp, offset, SEEK_SET) != 0)
+    {
+      fclose(fp);
+      fp = NULL;
+    }
+
+  return fp;
+
+}
+
+long log_index_build(const char* log_filename, int every_records, int every_ms)
+{
+
+  MappedFile log;
+
+  if(log.open(log_filename) != 0)
+    return -1;
+
+  // same rule as log_index_this_record() in log.cpp
+  std::vector<log_index_entry_t> entries;
+  const char* data = (const char*) log.data();
+  const char* end = data + log.size();
+  const char* p = data;
+  int64_t last = LOG_MERGE_BAD_TIME;
+  int since = 0;
+
+  while(p < end)
+    {
+      const char* nl = (const char*) memchr(p, '\n', end - p);
+      const char* le = (nl == NULL) ? end : nl;
+      const int64_t t = log_merge_parse_time(p, le);
+
+      if(t != LOG_MERGE_BAD_TIME)
+	{
+	  since++;
+
+	  if(last == LOG_MERGE_BAD_TIME ||
+	     (every_records > 0 && since >= every_records) ||
+	     (every_ms > 0 && t - last >= every_ms*1000000LL))
+	    {
+	      log_index_entry_t e;
+	      e.time_ns = t;
+	      e.offset = p - data;
+	      entries.push_back(e);
+
+	      last = t;
+	      since = 0;
+	    }
+	}
+
+      p = (nl == NULL) ? end : nl + 1;
+    }
+
+  log.close();
+
+  // write and rename, so readers never see a partial sidecar
+  const std::string filename = log_index_filename(log_filename);
+  const std::string tmp = filename + ".tmp";
+
+  FILE* fp = fopen(tmp.c_str(), "wb");
+  if(fp == NULL)
+    return -1;
+
+  log_index_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic));
+  header.version = LOG_INDEX_VERSION;
+
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  if(!entries.empty())
+    ok = ok && fwrite(&entries[0], sizeof(log_index_entry_t), entries.size(), fp) == entries.size();
+  ok = (fclose(fp) == 0) && ok;
+
+  if(!ok || rename(tmp.c_str(), filename.c_str()) != 0)
+    {
+      remove(tmp.c_str());
+      return -1;
+    }
+
+  return (long) entries.size();
+
+}
+
+int log_index_build_dir(const char* dir, const char* suffix,
+			int every_records, int every_ms, int num_threads)
+{
+
+  std::vector<std::string> files;
+
+  if(ingest_list_dir(dir, suffix, files) < 0)
+    return -1;
+
+  std::vector<long> result(files.size());
+  WorkStealingPool pool(num_threads);
+
+  pool.parallel_for((int) files.size(), [&](int i) {
+      result[i] = log_index_build(files[i].c_str(), every_records, every_ms);
+    });
+
+  for(size_t i=0; i<result.size(); i++)
+    if(result[i] < 0)
+      return -1;
+
+  return (int) files.size();
+
+}
@@ -0,0 +1,293 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of log_merge.h.
+ *
+ */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <helper_funcs/log_merge.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/ingest.h>
+#include <helper_funcs/time_util.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define LOG_MERGE_PAGE 4096
+
+// one file of one channel
+struct LogMergeCursor
+{
+
+  std::string filename;
+  int channel;
+  int seq;
+  int64_t first_t;
+
+  MappedFile map;
+  const char* pos;
+  const char* end;
+  size_t prefetched;
+
+  // current record
+  const char* line;
+  size_t len;
+  int64_t t;
+
+};
+
+int64_t log_merge_parse_time(const char* line, const char* end)
+{
+
+  const char* p = line;
+
+  // record name
+  while(p < end && *p != ' ' && *p != '\t')
+    p++;
+  while(p < end && (*p == ' ' || *p == '\t'))
+    p++;
+
+  if(p >= end)
+    return LOG_MERGE_BAD_TIME;
+
+  const long long t = rov_parse_dsl_time_string_ns(p, end, NULL);
+
+  return (t == ROV_TIME_NS_INVALID) ? LOG_MERGE_BAD_TIME : (int64_t) t;
+
+}
+
+// move a cursor to its next timestamped line
+static bool log_merge_advance(LogMergeCursor* c, size_t prefetch, uint64_t* bad_lines)
+{
+
+  while(c->pos < c->end)
+    {
+      const char* nl = (const char*) memchr(c->pos, '\n', c->end - c->pos);
+      const char* le = (nl == NULL) ? c->end : nl;
+
+      c->line = c->pos;
+      c->len  = le - c->pos;
+      c->t    = log_merge_parse_time(c->pos, le);
+      c->pos  = (nl == NULL) ? c->end : nl + 1;
+
+      if(c->t != LOG_MERGE_BAD_TIME)
+	{
+	  // keep a window of read-ahead in front of the read position
+	  const size_t size = c->map.size();
+	  const size_t off = c->pos - (const char*) c->map.data();
+	  if(prefetch > 0 && c->prefetched < size && off + prefetch/2 >= c->prefetched)
+	    {
+	      const size_t n = std::min(prefetch, size - c->prefetched);
+	      madvise((void*) (c->map.data() + c->prefetched), n, MADV_WILLNEED);
+	      c->prefetched += n;
+	    }
+	  return true;
+	}
+
+      if(c->len > 0 && bad_lines != NULL)
+	(*bad_lines)++;
+    }
+
+  return false;
+
+}
+
+static bool log_merge_open(LogMergeCursor* c)
+{
+
+  if(c->map.open(c->filename.c_str()) != 0)
+    return false;
+
+  c->pos = (const char*) c->map.data();
+  c->end = c->pos + c->map.size();
+  c->prefetched = 0;
+
+  return true;
+
+}
+
+// true if a comes after b
+static inline bool log_merge_after(const LogMergeCursor* a, const LogMergeCursor* b)
+{
+  if(a->t != b->t)
+    return a->t > b->t;
+  if(a->channel != b->channel)
+    return a->channel > b->channel;
+  return a->seq > b->seq;
+}
+
+static bool log_merge_pending_before(const LogMergeCursor* a, const LogMergeCursor* b)
+{
+  if(a->first_t != b->first_t)
+    return a->first_t < b->first_t;
+  if(a->channel != b->channel)
+    return a->channel < b->channel;
+  return a->seq < b->seq;
+}
+
+LogMerge::LogMerge(size_t prefetch_bytes)
+  : prefetch((prefetch_bytes + LOG_MERGE_PAGE - 1)/LOG_MERGE_PAGE*LOG_MERGE_PAGE),
+    num_channels(0), file_seq(0), next_pending(0), current(NULL)
+{
+
+  memset(&st, 0, sizeof(st));
+
+}
+
+LogMerge::~LogMerge(void)
+{
+
+  for(size_t i=next_pending; i<pending.size(); i++)
+    delete pending[i];
+  for(size_t i=0; i<heap.size(); i++)
+    delete heap[i];
+  delete current;
+
+}
+
+int LogMerge::add_channel(const std::vector<std::string>& files)
+{
+
+  const int channel = num_channels++;
+
+  for(size_t f=0; f<files.size(); f++)
+    {
+      LogMergeCursor* c = new LogMergeCursor;
+      c->filename = files[f];
+      c->channel = channel;
+      c->seq = file_seq++;
+
+      // read the first timestamp, then close until the merge gets there
+      if(!log_merge_open(c))
+	{
+	  delete c;
+	  return -1;
+	}
+
+      uint64_t bad = 0;
+      const bool any = log_merge_advance(c, 0, &bad);
+      c->first_t = c->t;
+      c->map.close();
+
+      if(!any)
+	{
+	  st.bad_lines += bad;
+	  delete c;
+	  continue;
+	}
+
+      pending.push_back(c);
+    }
+
+  std::stable_sort(pending.begin() + next_pending, pending.end(), log_merge_pending_before);
+
+  return channel;
+
+}
+
+int LogMerge::add_channel(const char* dir, const char* suffix)
+{
+
+  std::vector<std::string> files;
+
+  if(ingest_list_dir(dir, suffix, files) < 0)
+    return -1;
+
+  return add_channel(files);
+
+}
+
+void LogMerge::heap_push(LogMergeCursor* c)
+{
+
+  heap.push_back(c);
+  std::push_heap(heap.begin(), heap.end(), log_merge_after);
+
+}
+
+LogMergeCursor* LogMerge::heap_pop(void)
+{
+
+  std::pop_heap(heap.begin(), heap.end(), log_merge_after);
+  LogMergeCursor* c = heap.back();
+  heap.pop_back();
+
+  return c;
+
+}
+
+// open every pending file that starts no later than the heap minimum
+void LogMerge::activate(void)
+{
+
+  while(next_pending < pending.size() &&
+	(heap.empty() || pending[next_pending]->first_t <= heap.front()->t))
+    {
+      LogMergeCursor* c = pending[next_pending++];
+
+      if(log_merge_open(c) && log_merge_advance(c, prefetch, &st.bad_lines))
+	{
+	  heap_push(c);
+	  st.files_opened++;
+	  if((int) heap.size() > st.max_open)
+	    st.max_open = (int) heap.size();
+	}
+      else
+	delete c;
+    }
+
+}
+
+bool LogMerge::next(LogMergeRecord& rec)
+{
+
+  if(current != NULL)
+    {
+      if(log_merge_advance(current, prefetch, &st.bad_lines))
+	heap_push(current);
+      else
+	delete current;
+      current = NULL;
+    }
+
+  activate();
+
+  if(heap.empty())
+    return false;
+
+  current = heap_pop();
+
+  rec.line = current->line;
+  rec.len = current->len;
+  rec.time_ns = current->t;
+  rec.channel = current->channel;
+
+  st.records++;
+
+  return true;
+
+}
+
+long log_merge_write(LogMerge& merge, FILE* fp)
+{
+
+  LogMergeRecord rec;
+  long n = 0;
+
+  while(merge.next(rec))
+    {
+      fwrite(rec.line, 1, rec.len, fp);
+      fputc('\n', fp);
+      n++;
+    }
+
+  return n;
+
+}
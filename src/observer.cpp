@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of observer.h.
+ *
+ */
+
+#include <math.h>
+#include <helper_funcs/observer.h>
+#include <helper_funcs/so3.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+ObserverGains observer_gains(const config_params& params)
+{
+
+  ObserverGains k;
+
+  k.k_acc      = params.K_acc.diagonal();
+  k.k_mag      = params.K_mag.diagonal();
+  k.k_ang_bias = params.K_ang_bias.diagonal();
+  k.k_acc_bias = params.K_acc_bias.diagonal();
+  k.k_mag_bias = params.K_mag_bias.diagonal();
+  k.k_E_n      = params.K_E_n.diagonal();
+  k.k_g        = params.K_g.diagonal();
+  k.k_north    = params.K_north.diagonal();
+
+  k.R_align = params.R_align;
+
+  k.dt = (params.hz > 0) ? 1.0/((double)params.hz) : 0.0;
+
+  return k;
+
+}
+
+void observer_init(const config_params& params, const ImuPacket& pkt, ObserverState& x)
+{
+
+  // load_params() sets unspecified acc_hat and w_E_north to this sentinel
+  const Eigen::Vector3d sentinel(-100.0,-100.0,-100.0);
+
+  x.R = params.R0;
+
+  x.ang_bias = params.ang_bias;
+  x.acc_bias = params.acc_bias;
+  x.mag_bias = params.mag_bias;
+
+  if(params.acc_hat == sentinel)
+    x.acc_hat = pkt.acc - params.acc_bias;
+  else
+    x.acc_hat = params.acc_hat;
+
+  x.mag_hat = pkt.mag - params.mag_bias;
+
+  if(params.w_E_north == sentinel)
+    {
+      const double rate = 15.041*M_PI/180/3600;
+      x.w_E_n = rate*Eigen::Vector3d(cos(params.lat), 0.0, -sin(params.lat));
+    }
+  else
+    x.w_E_n = params.w_E_north;
+
+  x.t = pkt.t;
+
+}
+
+void observer_step(const ObserverGains& k, const ImuPacket& pkt, const ObserverState& x, ObserverState& x_next)
+{
+
+  const double dt = (pkt.dt > 0.0) ? pkt.dt : k.dt;
+
+  const Eigen::Vector3d w   = pkt.ang - x.ang_bias;
+  const Eigen::Vector3d e_a = x.acc_hat - (pkt.acc - x.acc_bias);
+  const Eigen::Vector3d e_m = x.mag_hat - (pkt.mag - x.mag_bias);
+
+  // gravity error, instrument frame: up is -e_3 in NED
+  const Eigen::Vector3d up = -x.R.row(2).transpose();
+  const double a_norm = x.acc_hat.norm();
+  const Eigen::Vector3d e_g = (a_norm > 0.0) ? Eigen::Vector3d(x.acc_hat.cross(up)/a_norm) : Eigen::Vector3d::Zero();
+
+  // north error: rotate the horizontal field direction onto e_1
+  const Eigen::Vector3d m_n = x.R*x.mag_hat;
+  const double h_norm = sqrt(m_n(0)*m_n(0) + m_n(1)*m_n(1));
+  const double e_yaw = (h_norm > 0.0) ? -m_n(1)/h_norm : 0.0;
+  const Eigen::Vector3d e_north = e_yaw*x.R.row(2).transpose();
+
+  const Eigen::Vector3d w_c = k.k_g.cwiseProduct(e_g) + k.k_north.cwiseProduct(e_north);
+
+  const Eigen::Matrix3d R_next = so3::exp(-dt*x.w_E_n)*x.R*so3::exp(dt*(w + w_c));
+
+  // every output from x before any is stored: x and x_next may be the same
+  const Eigen::Vector3d acc_hat  = x.acc_hat + dt*(-w.cross(x.acc_hat) - k.k_acc.cwiseProduct(e_a));
+  const Eigen::Vector3d mag_hat  = x.mag_hat + dt*(-w.cross(x.mag_hat) - k.k_mag.cwiseProduct(e_m));
+  const Eigen::Vector3d ang_bias = x.ang_bias + dt*k.k_ang_bias.cwiseProduct(e_a.cross(x.acc_hat));
+  const Eigen::Vector3d acc_bias = x.acc_bias - dt*k.k_acc_bias.cwiseProduct(e_a);
+  const Eigen::Vector3d mag_bias = x.mag_bias - dt*k.k_mag_bias.cwiseProduct(e_m);
+  const Eigen::Vector3d w_E_n    = x.w_E_n - dt*k.k_E_n.cwiseProduct(x.R*w_c);
+
+  x_next.acc_hat  = acc_hat;
+  x_next.mag_hat  = mag_hat;
+  x_next.ang_bias = ang_bias;
+  x_next.acc_bias = acc_bias;
+  x_next.mag_bias = mag_bias;
+  x_next.w_E_n    = w_E_n;
+  x_next.R        = R_next;
+  x_next.t        = pkt.t;
+
+}
+
+void observer_run(const ObserverGains& k, const ImuPacket* pkts, int n, ObserverState& x)
+{
+
+  for(int i=0; i<n; i++)
+    observer_step(k, pkts[i], x, x);
+
+}
+
+Eigen::Matrix3d observer_vehicle_attitude(const ObserverGains& k, const ObserverState& x)
+{
+
+  return x.R*k.R_align.transpose();
+
+}
@@ -0,0 +1,1966 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Checks and timings for the binary log parsers.
+ *
+ * Builds synthetic KVH, Microstrain and PHINS streams with corrupted
+ * frames and junk between frames, and checks that every good frame is
+ * decoded, every corrupted one rejected, and the scanner resyncs.  The
+ * streams are parsed whole, in random-sized pieces, and from a mapped
+ * file.  Then times parsing large in-memory streams of each format.
+ *
+ * The ingest checks write a directory of hourly text, KVH and
+ * Microstrain (with and without GPS time) binary logs, ingest it in
+ * small chunks and compare against a serial read.
+ * The ingest benchmark writes a corpus of the size given on the command
+ * line (units: MB, default 128) and times it against the thread count.
+ *
+ * The merge check writes three channels of overlapping hourly text
+ * logs and compares LogMerge against a sort of every line; the merge
+ * benchmark times a corpus of the same size.
+ *
+ * The archive check round-trips samples through raw and compressed
+ * columnar archives, checks that archives with a damaged block index do
+ * not open, and converts text logs; the archive benchmark
+ * reports size, open time and time-range query time.
+ *
+ * The index check writes a log through log.cpp with the sidecar time
+ * index on, checks it against log_index_build() and checks seeks against
+ * a linear scan; the index benchmark times backfilling and seeking.
+ *
+ * The text scan check compares text_scan_clean() against byte loops on
+ * random text at every alignment and checks text_scan_split_dsl(); the
+ * text scan benchmark reports GB/s for finding lines with memchr(),
+ * cleaning strings and splitting DSL records.
+ *
+ * The replay check plays text and binary logs into a sample ring and
+ * compares them with ingest_files(), and checks pacing and the RENAV
+ * clock; the replay benchmark reports unthrottled throughput and lag at
+ * 100x.
+ *
+ * The config parse check feeds config_parse() every field, CRLF line
+ * ends, comments, a typo, a bad value, a repeat and a missing key, and
+ * checks the values and the report; it loads a set of files in parallel
+ * and serially and compares them.  The config parse benchmark times
+ * loading a sweep's worth of files against the thread count.
+ *
+ * The config check loads a config file through ConfigWatcher, edits it
+ * in place and by rename while a reader thread spins on current(), and
+ * checks that a broken edit is rejected and every snapshot read is
+ * whole; the config benchmark times current().
+ *
+ * The sweep check sweeps a text log over a set of config files, one of
+ * them broken, on every core and on one thread, and checks that the
+ * broken one is skipped and the runs agree.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/imu_log.h>
+#include <helper_funcs/ingest.h>
+#include <helper_funcs/log_merge.h>
+#include <helper_funcs/imu_archive.h>
+#include <helper_funcs/log_index.h>
+#include <helper_funcs/time_util.h>
+#include <helper_funcs/text_scan.h>
+#include <helper_funcs/replay.h>
+#include <helper_funcs/config_watch.h>
+#include <helper_funcs/config_parse.h>
+#include <helper_funcs/sweep.h>
+
+#define NUM_FRAMES 20000
+#define BENCH_BYTES (256 << 20)
+#define INGEST_FILES 6
+
+static double now_sec(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static ImuPacket make_packet(int i)
+{
+  ImuPacket p;
+  p.ang = Eigen::Vector3d(0.01*sin(0.001*i), -0.02, 0.003*i/NUM_FRAMES);
+  p.acc = Eigen::Vector3d(0.1, -0.2*cos(0.002*i), 9.81);
+  p.mag = Eigen::Vector3d(0.2, 0.05, -0.4);
+  p.seq_num = i;
+  p.t = 1000.0 + 0.01*i;
+  p.dt = 0.01;
+  p.fluid_pressure = 1013.25f;
+  return p;
+}
+
+static int encode(int format, const ImuPacket& p, uint8_t* buf)
+{
+  switch(format)
+    {
+    case BINLOG_FORMAT_KVH: return binlog_encode_kvh(p, true, buf);
+    case BINLOG_FORMAT_MST: return binlog_encode_mst(p, buf);
+    default:                return binlog_encode_phins(p, buf);
+    }
+}
+
+// build a stream; every 97th frame is corrupted and junk follows every 50th
+static void build_stream(int format, std::vector<uint8_t>& stream, std::vector<int>& good)
+{
+  uint8_t buf[BINLOG_MAX_FRAME];
+
+  srand(format + 1);
+  stream.clear();
+  good.clear();
+
+  for(int i=0; i<NUM_FRAMES; i++)
+    {
+      int len = encode(format, make_packet(i), buf);
+
+      if(i % 97 == 5)
+	buf[len/2] ^= 0x10;
+      else
+	good.push_back(i);
+
+      stream.insert(stream.end(), buf, buf + len);
+
+      if(i % 50 == 3)
+	for(int j=0; j<7; j++)
+	  stream.push_back((uint8_t) rand());
+    }
+}
+
+static int check_batch(const char* what, int format, const ImuBatch& out, const std::vector<int>& good)
+{
+  if(out.size() != good.size())
+    {
+      printf("FAIL: %s decoded %d samples, expected %d\n", what, (int) out.size(), (int) good.size());
+      return 1;
+    }
+
+  for(size_t j=0; j<good.size(); j++)
+    {
+      ImuPacket e = make_packet(good[j]);
+      ImuPacket d = out.packet(j);
+
+      double err = (d.ang - e.ang).norm() + (d.acc - e.acc).norm();
+      if(format == BINLOG_FORMAT_KVH || format == BINLOG_FORMAT_MST)
+	err += (d.mag - e.mag).norm();
+      if(format != BINLOG_FORMAT_KVH)
+	err += fabs(d.t - e.t);
+
+      bool seq_ok;
+      if(format == BINLOG_FORMAT_KVH)
+	seq_ok = d.seq_num == (e.seq_num & 0x7F);
+      else if(format == BINLOG_FORMAT_MST)
+	seq_ok = d.seq_num == (int) j;
+      else
+	seq_ok = d.seq_num == e.seq_num;
+
+      if(err > 1e-5 || !seq_ok)
+	{
+	  printf("FAIL: %s sample %d (frame %d) decoded wrongly, err %g\n", what, (int) j, good[j], err);
+	  return 1;
+	}
+    }
+
+  return 0;
+}
+
+// STDBIN frames laid out by hand from the iXblue protocol description,
+// independent of binlog_encode_phins(): a v2 frame with attitude,
+// real-time heave, smart heave, rotation rate and acceleration (nav bits
+// 0, 2, 3, 5, 6) and a v3 frame with attitude, attitude std dev,
+// heading/roll/pitch rate, rotation rate and acceleration (bits 0, 1, 4,
+// 5, 6) and a non-zero extended navigation bitmask
+static const uint8_t phins_v2_frame[85] = {
+    0x49, 0x58, 0x02, 0x00, 0x00, 0x00, 0x6d, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x55, 0x07, 0x5b, 0xcd, 0x15, 0x00, 0x00, 0x00, 0x2a, 0x42, 0xb4, 0x00,
+    0x00, 0x3f, 0xc0, 0x00, 0x00, 0xc0, 0x10, 0x00, 0x00, 0x3d, 0xcc, 0xcc,
+    0xcd, 0x3e, 0x4c, 0xcc, 0xcd, 0xbe, 0x99, 0x99, 0x9a, 0x3e, 0xcc, 0xcc,
+    0xcd, 0x00, 0x00, 0x30, 0x39, 0x3f, 0x00, 0x00, 0x00, 0x41, 0x20, 0x00,
+    0x00, 0xc1, 0xa0, 0x00, 0x00, 0x40, 0xa0, 0x00, 0x00, 0x3e, 0x80, 0x00,
+    0x00, 0xbf, 0x00, 0x00, 0x00, 0x41, 0x1d, 0x00, 0x00, 0x00, 0x00, 0x14,
+    0xaf};
+
+static const uint8_t phins_v3_frame[89] = {
+    0x49, 0x58, 0x03, 0x00, 0x00, 0x00, 0x73, 0x00, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x59, 0x00, 0x03, 0x0d, 0x40, 0x00, 0x00, 0x00,
+    0x07, 0x43, 0x34, 0x00, 0x00, 0xbf, 0x80, 0x00, 0x00, 0x40, 0x40, 0x00,
+    0x00, 0x3c, 0x23, 0xd7, 0x0a, 0x3c, 0xa3, 0xd7, 0x0a, 0x3c, 0xf5, 0xc2,
+    0x8f, 0x3f, 0x80, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40, 0x40, 0x00,
+    0x00, 0xc2, 0x34, 0x00, 0x00, 0x42, 0xb4, 0x00, 0x00, 0x3f, 0x00, 0x00,
+    0x00, 0xc1, 0x1c, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x3f, 0x80, 0x00,
+    0x00, 0x00, 0x00, 0x0f, 0x04};
+
+static int check_phins_frame(const char* what, const uint8_t* frame, size_t len,
+			     const Eigen::Vector3d& ang_deg, const Eigen::Vector3d& acc,
+			     double t, int seq_num)
+{
+  BinlogParser parser(BINLOG_FORMAT_PHINS, 100.0);
+  ImuBatch out;
+  size_t used = parser.parse(frame, len, out);
+
+  if(used != len || out.size() != 1)
+    {
+      printf("FAIL: %s consumed %d of %d bytes, %d samples\n", what, (int) used, (int) len, (int) out.size());
+      return 1;
+    }
+
+  ImuPacket d = out.packet(0);
+  double err = (d.ang - ang_deg*(M_PI/180.0)).norm() + (d.acc - acc).norm() + fabs(d.t - t);
+  if(err > 1e-6 || d.seq_num != seq_num)
+    {
+      printf("FAIL: %s decoded wrongly, err %g, seq %d\n", what, err, d.seq_num);
+      return 1;
+    }
+
+  return 0;
+}
+
+static int check_phins_fixture(void)
+{
+  int errors = 0;
+
+  errors += check_phins_frame("PHINS v2 fixture", phins_v2_frame, sizeof(phins_v2_frame),
+			      Eigen::Vector3d(10.0, -20.0, 5.0), Eigen::Vector3d(0.25, -0.5, 9.8125),
+			      12345.6789, 42);
+  errors += check_phins_frame("PHINS v3 fixture", phins_v3_frame, sizeof(phins_v3_frame),
+			      Eigen::Vector3d(-45.0, 90.0, 0.5), Eigen::Vector3d(-9.75, 0.125, 1.0),
+			      20.0, 7);
+
+  return errors;
+}
+
+static int check_format(int format, const char* name, const char* suffix)
+{
+  int errors = 0;
+  std::vector<uint8_t> stream;
+  std::vector<int> good;
+  char what[128];
+
+  build_stream(format, stream, good);
+  const int num_bad = NUM_FRAMES - (int) good.size();
+
+  // whole buffer
+  {
+    BinlogParser parser(format, 100.0);
+    ImuBatch out;
+    size_t used = parser.parse(&stream[0], stream.size(), out);
+
+    snprintf(what, sizeof(what), "%s whole", name);
+    errors += check_batch(what, format, out, good);
+    if(used != stream.size() || (int) parser.stats().bad_checksum != num_bad)
+      {
+	printf("FAIL: %s consumed %d of %d bytes, %d bad checksums (expected %d)\n", what,
+	       (int) used, (int) stream.size(), (int) parser.stats().bad_checksum, num_bad);
+	errors++;
+      }
+  }
+
+  // random-sized pieces, carrying unconsumed bytes forward
+  {
+    BinlogParser parser(format, 100.0);
+    ImuBatch out;
+    std::vector<uint8_t> carry;
+    size_t pos = 0;
+
+    while(pos < stream.size())
+      {
+	size_t n = 1 + rand() % 300;
+	if(n > stream.size() - pos)
+	  n = stream.size() - pos;
+	carry.insert(carry.end(), stream.begin() + pos, stream.begin() + pos + n);
+	pos += n;
+
+	size_t used = parser.parse(&carry[0], carry.size(), out, false);
+	carry.erase(carry.begin(), carry.begin() + used);
+      }
+    if(!carry.empty())
+      parser.parse(&carry[0], carry.size(), out, true);
+
+    snprintf(what, sizeof(what), "%s pieces", name);
+    errors += check_batch(what, format, out, good);
+  }
+
+  // mapped file
+  {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "/tmp/parse_test_%d.%s", (int) getpid(), suffix);
+
+    FILE* fp = fopen(filename, "wb");
+    fwrite(&stream[0], 1, stream.size(), fp);
+    fclose(fp);
+
+    ImuBatch out;
+    BinlogStats st;
+    long n = binlog_parse_file(filename, out, &st, 100.0);
+    remove(filename);
+
+    snprintf(what, sizeof(what), "%s file", name);
+    if(n != (long) good.size())
+      {
+	printf("FAIL: %s returned %ld\n", what, n);
+	errors++;
+      }
+    errors += check_batch(what, format, out, good);
+
+    printf("%-6s %d frames, %d bad checksums, %d resync bytes\n", name,
+	   (int) st.frames, (int) st.bad_checksum, (int) st.resync_bytes);
+  }
+
+  return errors;
+}
+
+// write num_files hourly logs of about file_bytes each, text or KVH binary
+static void write_corpus(const char* dir, bool binary, int num_files, size_t file_bytes)
+{
+  char filename[512];
+  char payload[IMU_LOG_MAX_PAYLOAD];
+  uint8_t buf[BINLOG_MAX_FRAME];
+  int i = 0;
+
+  for(int f=0; f<num_files; f++)
+    {
+      snprintf(filename, sizeof(filename), "%s/2026_10_19_%02d_00.%s", dir, f, binary ? "BKVH" : "KVH");
+      FILE* fp = fopen(filename, "wb");
+      size_t bytes = 0;
+
+      while(bytes < file_bytes)
+	{
+	  ImuPacket p = make_packet(i++);
+	  if(binary)
+	    bytes += fwrite(buf, 1, binlog_encode_kvh(p, true, buf), fp);
+	  else
+	    {
+	      imu_log_sprintf_payload(payload, p);
+	      bytes += fprintf(fp, "IMU 2026/10/19 %02d:00:00.000 %s\n", f, payload);
+	      if(i % 1000 == 0)
+		bytes += fprintf(fp, "IMU 2026/10/19 %02d:00:00.000 garbled\n", f);
+	    }
+	}
+
+      fclose(fp);
+    }
+}
+
+// write num_files hourly Microstrain logs of about file_bytes each
+static void write_mst_corpus(const char* dir, bool with_gps, int num_files, size_t file_bytes)
+{
+  char filename[512];
+  uint8_t buf[BINLOG_MAX_FRAME];
+  int i = 0;
+
+  for(int f=0; f<num_files; f++)
+    {
+      snprintf(filename, sizeof(filename), "%s/2026_10_19_%02d_00.%s", dir, f, LOG_FID_MST_BINARY_SUFFIX);
+      FILE* fp = fopen(filename, "wb");
+      size_t bytes = 0;
+
+      while(bytes < file_bytes)
+	bytes += fwrite(buf, 1, binlog_encode_mst(make_packet(i++), buf, with_gps), fp);
+
+      fclose(fp);
+    }
+}
+
+static void remove_corpus(const char* dir)
+{
+  std::vector<std::string> files;
+  ingest_list_dir(dir, "KVH", files);
+  ingest_list_dir(dir, "BKVH", files);
+  ingest_list_dir(dir, LOG_FID_MST_BINARY_SUFFIX, files);
+  for(size_t i=0; i<files.size(); i++)
+    remove(files[i].c_str());
+  rmdir(dir);
+}
+
+static int check_ingest(void)
+{
+  int errors = 0;
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_ingest_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  write_corpus(dir, false, INGEST_FILES, 1 << 20);
+  write_corpus(dir, true, INGEST_FILES, 1 << 20);
+
+  // text, against a serial imu_log_load()
+  {
+    std::vector<std::string> files;
+    std::vector<ImuPacket> ref;
+    ingest_list_dir(dir, "KVH", files);
+    for(size_t f=0; f<files.size(); f++)
+      imu_log_load(files[f].c_str(), ref);
+
+    // files given in reverse order must come back in time order
+    std::reverse(files.begin(), files.end());
+
+    ImuBatch out;
+    IngestStats st;
+    long n = ingest_files(files, out, &st, 0.0, 3, 64 << 10);
+
+    int bad = 0;
+    if(n != (long) ref.size())
+      bad++;
+    for(size_t i=0; i<ref.size() && i<out.size() && bad<1; i++)
+      {
+	ImuPacket d = out.packet(i);
+	if(d.t != ref[i].t || d.seq_num != ref[i].seq_num || d.ang != ref[i].ang ||
+	   d.acc != ref[i].acc || d.mag != ref[i].mag || (i > 0 && d.dt != ref[i].t - ref[i-1].t))
+	  bad++;
+      }
+    if(bad || st.chunks <= INGEST_FILES || (int) st.bad_records != (int) (ref.size()/1000))
+      {
+	printf("FAIL: text ingest differs from imu_log_load (%ld of %d samples, %d chunks, %d bad records)\n",
+	       n, (int) ref.size(), st.chunks, (int) st.bad_records);
+	errors++;
+      }
+  }
+
+  // KVH binary, against one parser over each file
+  {
+    std::vector<std::string> files;
+    ingest_list_dir(dir, "BKVH", files);
+
+    ImuBatch ref;
+    for(size_t f=0; f<files.size(); f++)
+      binlog_parse_file(files[f].c_str(), ref);
+
+    ImuBatch out;
+    IngestStats st;
+    long n = ingest_dir(dir, "BKVH", out, &st, 1000.0, 3, 64 << 10);
+
+    int bad = 0;
+    if(n != (long) ref.size())
+      bad++;
+    for(size_t i=0; i<ref.size() && i<out.size() && bad<1; i++)
+      {
+	ImuPacket d = out.packet(i);
+	ImuPacket e = ref.packet(i);
+	if(d.seq_num != e.seq_num || d.ang != e.ang || d.acc != e.acc || d.mag != e.mag ||
+	   fabs(d.t - 1e-3*i) > 1e-9)
+	  bad++;
+      }
+    if(bad || st.chunks <= INGEST_FILES)
+      {
+	printf("FAIL: binary ingest differs from binlog_parse_file (%ld of %d samples)\n", n, (int) ref.size());
+	errors++;
+      }
+  }
+
+  // Microstrain with and without GPS time, against one parser over the
+  // files back to back: one run of seq_num and, without GPS, of t
+  for(int with_gps=1; with_gps>=0; with_gps--)
+    {
+      write_mst_corpus(dir, with_gps, INGEST_FILES, 1 << 20);
+
+      std::vector<std::string> files;
+      ingest_list_dir(dir, LOG_FID_MST_BINARY_SUFFIX, files);
+
+      BinlogParser parser(BINLOG_FORMAT_MST, 100.0);
+      ImuBatch ref;
+      for(size_t f=0; f<files.size(); f++)
+	{
+	  std::vector<uint8_t> data;
+	  uint8_t piece[65536];
+	  size_t got;
+	  FILE* fp = fopen(files[f].c_str(), "rb");
+	  while((got = fread(piece, 1, sizeof(piece), fp)) > 0)
+	    data.insert(data.end(), piece, piece + got);
+	  fclose(fp);
+	  parser.parse(data.data(), data.size(), ref, true);
+	}
+
+      ImuBatch out;
+      IngestStats st;
+      long n = ingest_dir(dir, LOG_FID_MST_BINARY_SUFFIX, out, &st, 100.0, 3, 64 << 10);
+
+      int bad = 0;
+      if(n != (long) ref.size())
+	bad++;
+      for(size_t i=0; i<ref.size() && i<out.size() && bad<1; i++)
+	{
+	  ImuPacket d = out.packet(i);
+	  ImuPacket e = ref.packet(i);
+	  if(d.seq_num != e.seq_num || d.t != e.t || d.ang != e.ang || d.acc != e.acc || d.mag != e.mag ||
+	     (i > 0 && fabs(d.dt - 0.01) > 1e-9))
+	    bad++;
+	}
+      if(bad || st.chunks <= INGEST_FILES || st.reordered)
+	{
+	  printf("FAIL: Microstrain ingest %s GPS time differs from one parser (%ld of %d samples)\n",
+		 with_gps ? "with" : "without", n, (int) ref.size());
+	  errors++;
+	}
+
+      files.clear();
+      ingest_list_dir(dir, LOG_FID_MST_BINARY_SUFFIX, files);
+      for(size_t f=0; f<files.size(); f++)
+	remove(files[f].c_str());
+    }
+
+  remove_corpus(dir);
+
+  return errors;
+}
+
+static void bench_ingest(size_t corpus_mb)
+{
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_corpus_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  const size_t file_bytes = (corpus_mb << 20)/INGEST_FILES;
+  write_corpus(dir, false, INGEST_FILES, file_bytes);
+  write_corpus(dir, true, INGEST_FILES, file_bytes);
+
+  const int max_threads = (int) std::thread::hardware_concurrency();
+  printf("ingest, %d MB per format, %d cores\n", (int) corpus_mb, max_threads);
+
+  // serial baseline: imu_log_load() file by file
+  {
+    std::vector<std::string> files;
+    std::vector<ImuPacket> pkts;
+    ingest_list_dir(dir, "KVH", files);
+    double t0 = now_sec();
+    for(size_t f=0; f<files.size(); f++)
+      imu_log_load(files[f].c_str(), pkts);
+    double t = now_sec() - t0;
+    printf("  text, imu_log_load:      %7.0f MB/s\n", 1e-6*(corpus_mb << 20)/t);
+  }
+
+  for(int threads=1; threads<=2*max_threads; threads*=2)
+    {
+      IngestStats st_text, st_bin;
+      ImuBatch out;
+      ingest_dir(dir, "KVH", out, &st_text, 0.0, threads);
+      out.clear();
+      ingest_dir(dir, "BKVH", out, &st_bin, 1000.0, threads);
+
+      printf("  %2d threads: text %7.0f MB/s, KVH binary %7.0f MB/s\n", threads,
+	     1e-6*st_text.bytes/st_text.elapsed, 1e-6*st_bin.bytes/st_bin.elapsed);
+    }
+
+  remove_corpus(dir);
+}
+
+struct MergeLine
+{
+  int64_t t;
+  int channel;
+  int seq;
+  std::string line;
+  bool operator<(const MergeLine& o) const
+  {
+    if(t != o.t) return t < o.t;
+    if(channel != o.channel) return channel < o.channel;
+    return seq < o.seq;
+  }
+};
+
+// channel c: files of about lines_per_file lines at period_ns, each file
+// starting a little before the previous one ends
+static void write_channel(const char* dir, int c, int num_files, int lines_per_file,
+			  int64_t period_ns, std::vector<MergeLine>* ref)
+{
+  static const char* names[3] = {"KVH", "MST", "INS"};
+  const int64_t t0 = 1760868000LL*1000000000LL;  // 2025/10/19 10:00:00
+  char filename[512];
+  char line[256];
+  int seq = 0;
+
+  snprintf(filename, sizeof(filename), "%s/%s", dir, names[c]);
+  mkdir(filename, 0755);
+
+  for(int f=0; f<num_files; f++)
+    {
+      snprintf(filename, sizeof(filename), "%s/%s/2025_10_19_%02d_00.%s", dir, names[c], 10 + f, names[c]);
+      FILE* fp = fopen(filename, "w");
+
+      const int64_t start = t0 + (int64_t) f*lines_per_file*period_ns - (f > 0 ? 50*period_ns : 0);
+      for(int i=0; i<lines_per_file; i++)
+	{
+	  const int64_t t = start + i*period_ns + 7*c;
+	  const time_t s = (time_t) (t/1000000000LL);
+	  struct tm tm;
+	  gmtime_r(&s, &tm);
+	  int len = strftime(line, sizeof(line), "%Y/%m/%d %H:%M:%S", &tm);
+	  if(c == 1)
+	    len += snprintf(line + len, sizeof(line) - len, ".%03d", (int) ((t/1000000) % 1000));
+	  else
+	    len += snprintf(line + len, sizeof(line) - len, ".%09d", (int) (t % 1000000000LL));
+
+	  char rec[320];
+	  snprintf(rec, sizeof(rec), "%s %s %d,%d,0.001,0.002,0.003,0.1,0.2,9.8,0.2,0.05,-0.4", names[c], line, f, i);
+	  fprintf(fp, "%s\n", rec);
+
+	  if(ref != NULL)
+	    {
+	      MergeLine m;
+	      m.t = (c == 1) ? t/1000000*1000000 : t;
+	      m.channel = c;
+	      m.seq = seq++;
+	      m.line = rec;
+	      ref->push_back(m);
+	    }
+	}
+      fprintf(fp, "garbage without a timestamp\n");
+
+      fclose(fp);
+    }
+}
+
+static void remove_channels(const char* dir)
+{
+  static const char* names[3] = {"KVH", "MST", "INS"};
+  char sub[512];
+  for(int c=0; c<3; c++)
+    {
+      snprintf(sub, sizeof(sub), "%s/%s", dir, names[c]);
+      std::vector<std::string> files;
+      ingest_list_dir(sub, names[c], files);
+      for(size_t i=0; i<files.size(); i++)
+	{
+	  remove(files[i].c_str());
+	  remove(log_index_filename(files[i].c_str()).c_str());
+	}
+      rmdir(sub);
+    }
+  rmdir(dir);
+}
+
+static LogMerge* open_merge(const char* dir)
+{
+  static const char* names[3] = {"KVH", "MST", "INS"};
+  char sub[512];
+  LogMerge* m = new LogMerge;
+  for(int c=0; c<3; c++)
+    {
+      snprintf(sub, sizeof(sub), "%s/%s", dir, names[c]);
+      m->add_channel(sub, names[c]);
+    }
+  return m;
+}
+
+static int check_merge(void)
+{
+  int errors = 0;
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_merge_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  const char* s = "X 1970/01/02 00:00:01.5 data";
+  if(log_merge_parse_time(s, s + strlen(s)) != 86401500000000LL)
+    {
+      printf("FAIL: log_merge_parse_time\n");
+      errors++;
+    }
+
+  std::vector<MergeLine> ref;
+  write_channel(dir, 0, 4, 3000, 1000000, &ref);   // 1 kHz
+  write_channel(dir, 1, 3, 400, 10000000, &ref);   // 100 Hz, ms timestamps
+  write_channel(dir, 2, 5, 500, 5000000, &ref);    // 200 Hz
+  std::sort(ref.begin(), ref.end());
+
+  LogMerge* m = open_merge(dir);
+  LogMergeRecord rec;
+  size_t n = 0;
+  int bad = 0;
+  while(m->next(rec))
+    {
+      if(n >= ref.size() || rec.time_ns != ref[n].t || rec.channel != ref[n].channel ||
+	 std::string(rec.line, rec.len) != ref[n].line)
+	bad++;
+      n++;
+    }
+
+  if(bad || n != ref.size() || m->stats().bad_lines != 12)
+    {
+      printf("FAIL: LogMerge emitted %d of %d records, %d out of place, %d bad lines\n",
+	     (int) n, (int) ref.size(), bad, (int) m->stats().bad_lines);
+      errors++;
+    }
+  if(m->stats().max_open > 4)
+    {
+      printf("FAIL: LogMerge had %d files open at once\n", m->stats().max_open);
+      errors++;
+    }
+
+  delete m;
+  remove_channels(dir);
+
+  return errors;
+}
+
+static void bench_merge(size_t corpus_mb)
+{
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_merge_bench_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  // about 80 bytes per line; KVH at 1 kHz, MST and PHINS at 100 Hz
+  const int kvh_lines = (int) ((corpus_mb << 20)/80/1.2/INGEST_FILES);
+  write_channel(dir, 0, INGEST_FILES, kvh_lines, 1000000, NULL);
+  write_channel(dir, 1, INGEST_FILES, kvh_lines/10, 10000000, NULL);
+  write_channel(dir, 2, INGEST_FILES, kvh_lines/10, 10000000, NULL);
+
+  LogMerge* m = open_merge(dir);
+  LogMergeRecord rec;
+  uint64_t bytes = 0;
+  double t0 = now_sec();
+  while(m->next(rec))
+    bytes += rec.len + 1;
+  double t = now_sec() - t0;
+
+  const double rate = m->stats().records/t;
+  printf("merge, 3 channels: %7.0f MB/s, %5.1f Mrecords/s, a week at 1 kHz + 2 x 100 Hz in %.1f min\n",
+	 1e-6*bytes/t, 1e-6*rate, 7*86400*1200/rate/60);
+
+  delete m;
+  remove_channels(dir);
+}
+
+// samples with timing jitter and sensor noise, like a real log
+static void make_batch(size_t n, ImuBatch& b)
+{
+  srand(7);
+  for(size_t i=0; i<n; i++)
+    {
+      ImuPacket p = make_packet((int) i);
+      p.t += 1e-5*(rand() % 100);
+      p.ang += 1e-4*Eigen::Vector3d::Random();
+      p.acc += 1e-3*Eigen::Vector3d::Random();
+      b.push_back(p);
+    }
+  for(size_t i=1; i<n; i++)
+    b.dt()[i] = b.t()[i] - b.t()[i-1];
+}
+
+static bool same_batch(const ImuBatch& a, const ImuBatch& b, size_t offset = 0)
+{
+  for(size_t i=0; i<b.size(); i++)
+    {
+      ImuPacket x = a.packet(offset + i);
+      ImuPacket y = b.packet(i);
+      if(x.t != y.t || x.dt != y.dt || x.seq_num != y.seq_num || x.ang != y.ang ||
+	 x.acc != y.acc || x.mag != y.mag || x.fluid_pressure != y.fluid_pressure)
+	return false;
+    }
+  return true;
+}
+
+// a raw archive with one field of block 3 damaged must not open
+static int check_archive_corrupt(const char* filename)
+{
+  int errors = 0;
+  std::vector<char> good;
+  {
+    FILE* fp = fopen(filename, "rb");
+    char buf[65536];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+      good.insert(good.end(), buf, buf + n);
+    fclose(fp);
+  }
+
+  ImuArchiveHeader h;
+  memcpy(&h, &good[0], sizeof(h));
+  const size_t at = h.index_offset + 3*sizeof(ImuArchiveBlock);
+  const std::string bad_file = std::string(filename) + ".bad";
+  const char* what[4] = {"column past the end", "raw column too short", "num over block_size", "unknown encoding"};
+
+  for(int c=0; c<4; c++)
+    {
+      std::vector<char> bad = good;
+      ImuArchiveBlock b;
+      memcpy(&b, &bad[at], sizeof(b));
+      switch(c)
+	{
+	case 0: b.col_offset[IMU_ARCHIVE_COL_DT] = (uint32_t) (good.size() - b.offset); break;
+	case 1: b.col_bytes[IMU_ARCHIVE_COL_T] -= 8; break;
+	case 2: b.num = h.block_size + 1; break;
+	default: b.col_encoding[IMU_ARCHIVE_COL_SEQ] = 7; break;
+	}
+      memcpy(&bad[at], &b, sizeof(b));
+
+      FILE* fp = fopen(bad_file.c_str(), "wb");
+      fwrite(&bad[0], 1, bad.size(), fp);
+      fclose(fp);
+
+      ImuArchive a;
+      if(a.open(bad_file.c_str()) == 0)
+	{
+	  printf("FAIL: archive with a %s opened\n", what[c]);
+	  errors++;
+	}
+    }
+  remove(bad_file.c_str());
+
+  return errors;
+}
+
+static int check_archive(void)
+{
+  int errors = 0;
+  char filename[256];
+  snprintf(filename, sizeof(filename), "/tmp/parse_test_%d.imua", (int) getpid());
+
+  ImuBatch in;
+  make_batch(100000, in);
+
+  for(int compress=0; compress<2; compress++)
+    {
+      ImuArchiveWriter w;
+      w.open(filename, compress, 1000);
+      for(size_t i=0; i<500; i++)
+	w.append(in.packet(i));
+      ImuBatch rest;
+      for(size_t i=500; i<in.size(); i++)
+	rest.push_back(in.packet(i));
+      w.append(rest);
+      if(w.close() != 0)
+	{
+	  printf("FAIL: ImuArchiveWriter::close\n");
+	  errors++;
+	}
+
+      ImuArchive a;
+      ImuBatch out;
+      if(a.open(filename) != 0 || a.read_all(out) != (long) in.size() || !same_batch(in, out))
+	{
+	  printf("FAIL: archive round trip (compress %d)\n", compress);
+	  errors++;
+	}
+
+      // range query against a scan
+      const double t0 = in.t()[12345], t1 = in.t()[54321];
+      ImuBatch range;
+      a.read(t0, t1, range);
+      if(range.size() != 54321 - 12345 + 1 || !same_batch(in, range, 12345))
+	{
+	  printf("FAIL: archive range query (compress %d) returned %d samples\n", compress, (int) range.size());
+	  errors++;
+	}
+
+      // raw blocks are usable in place
+      const double* t = (const double*) a.raw_column(3, IMU_ARCHIVE_COL_T);
+      if(!compress && (t == NULL || t[5] != in.t()[3005]))
+	{
+	  printf("FAIL: archive raw column\n");
+	  errors++;
+	}
+
+      if(!compress)
+	errors += check_archive_corrupt(filename);
+
+      struct stat sb;
+      stat(filename, &sb);
+      printf("archive, %s: %5.1f bytes/sample\n", compress ? "compressed" : "raw", (double) sb.st_size/in.size());
+      a.close();
+    }
+  remove(filename);
+
+  // convert text logs
+  {
+    char dir[256];
+    snprintf(dir, sizeof(dir), "/tmp/parse_test_archive_%d", (int) getpid());
+    mkdir(dir, 0755);
+    write_corpus(dir, false, 2, 1 << 20);
+
+    std::vector<std::string> files;
+    ingest_list_dir(dir, "KVH", files);
+    ImuBatch ref, out;
+    ingest_files(files, ref);
+
+    ImuArchive a;
+    if(imu_archive_convert(files, filename) != (long) ref.size() || a.open(filename) != 0 ||
+       a.read_all(out) != (long) ref.size() || !same_batch(ref, out))
+      {
+	printf("FAIL: imu_archive_convert\n");
+	errors++;
+      }
+    a.close();
+    remove(filename);
+    remove_corpus(dir);
+  }
+
+  return errors;
+}
+
+static void bench_archive(size_t corpus_mb)
+{
+  char filename[256];
+  snprintf(filename, sizeof(filename), "/tmp/parse_test_bench_%d.imua", (int) getpid());
+
+  // corpus_mb of raw samples (about 100 bytes each)
+  const size_t n = (corpus_mb << 20)/100;
+  ImuBatch in;
+  make_batch(n, in);
+
+  double t0 = now_sec();
+  ImuArchiveWriter w;
+  w.open(filename, true);
+  w.append(in);
+  w.close();
+  const double t_write = now_sec() - t0;
+
+  t0 = now_sec();
+  ImuArchive a;
+  a.open(filename);
+  const double t_open = now_sec() - t0;
+
+  ImuBatch out;
+  t0 = now_sec();
+  a.read(in.t()[n/2], in.t()[n/2] + 1.0, out);
+  const double t_query = now_sec() - t0;
+
+  ImuBatch all;
+  t0 = now_sec();
+  a.read_all(all);
+  const double t_all = now_sec() - t0;
+
+  struct stat sb;
+  stat(filename, &sb);
+  printf("archive, %d samples: %.0f MB, write %.0f Msamples/s, open %.3f ms, 1 s query %.3f ms, read all %.0f Msamples/s\n",
+	 (int) n, 1e-6*sb.st_size, 1e-6*n/t_write, 1e3*t_open, 1e3*t_query, 1e-6*n/t_all);
+
+  a.close();
+  remove(filename);
+}
+
+static std::string read_file(const char* filename)
+{
+  std::string s;
+  FILE* fp = fopen(filename, "rb");
+  if(fp == NULL)
+    return s;
+  char buf[65536];
+  size_t n;
+  while((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    s.append(buf, n);
+  fclose(fp);
+  return s;
+}
+
+// reference seek: first timestamped line at or after t_ns
+static long scan_find(const std::string& log, int64_t t_ns)
+{
+  size_t p = 0;
+  while(p < log.size())
+    {
+      size_t nl = log.find('\n', p);
+      if(nl == std::string::npos)
+	nl = log.size();
+      const int64_t t = log_merge_parse_time(log.data() + p, log.data() + nl);
+      if(t != LOG_MERGE_BAD_TIME && t >= t_ns)
+	return (long) p;
+      p = nl + 1;
+    }
+  return (long) log.size();
+}
+
+static int check_seeks(const char* what, const char* filename, int num)
+{
+  const std::string log = read_file(filename);
+  int64_t t_begin = LOG_MERGE_BAD_TIME;
+  int64_t t_end = LOG_MERGE_BAD_TIME;
+  int bad = 0;
+
+  for(size_t p=0, nl; p < log.size(); p = nl + 1)
+    {
+      nl = log.find('\n', p);
+      if(nl == std::string::npos)
+	nl = log.size();
+      const int64_t t = log_merge_parse_time(log.data() + p, log.data() + nl);
+      if(t != LOG_MERGE_BAD_TIME)
+	{
+	  if(t_begin == LOG_MERGE_BAD_TIME)
+	    t_begin = t;
+	  t_end = t;
+	}
+    }
+
+  if(t_begin == LOG_MERGE_BAD_TIME)
+    {
+      printf("FAIL: %s: could not read %s\n", what, filename);
+      return 1;
+    }
+
+  srand(38);
+  for(int i=0; i<num; i++)
+    {
+      // before, inside and after the file, on and between records
+      int64_t t = t_begin - 1000000000LL + (int64_t) ((t_end - t_begin + 2000000000LL)*(rand()/(RAND_MAX + 1.0)));
+      if(i % 3 == 0)
+	t = t/1000000*1000000;
+      if(log_index_find(filename, t) != scan_find(log, t))
+	bad++;
+    }
+
+  if(bad)
+    {
+      printf("FAIL: %s: %d of %d seeks disagree with a linear scan\n", what, bad, num);
+      return 1;
+    }
+
+  return 0;
+}
+
+static int check_index(void)
+{
+  int errors = 0;
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_index_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  // the seek key parser takes four-digit years only
+  const char* after = NULL;
+  if(rov_parse_dsl_time_string_ns("2025/10/19 10:00:00.5 KVH", NULL, &after) != 1760868000500000000LL ||
+     strcmp(after, " KVH") != 0 ||
+     rov_parse_dsl_time_string_ns("25/10/19 10:00:00.5", NULL, NULL) != ROV_TIME_NS_INVALID ||
+     rov_parse_dsl_time_string_ns("925/10/19 10:00:00.5", NULL, NULL) != ROV_TIME_NS_INVALID)
+    {
+      printf("FAIL: rov_parse_dsl_time_string_ns\n");
+      errors++;
+    }
+
+  // a log written by the logger, in renav time: 200 Hz with a few gaps
+  rov_time_mode_set(ROV_TIME_MODE_RENAV);
+  log_set_log_dir(LOG_FID_KVH_FORMAT, dir);
+  log_set_index_interval(LOG_FID_KVH_FORMAT, 100, 250);
+
+  char name[] = "KVH";
+  char data[256];
+  double t = 1760868000.0;  // 2025/10/19 10:00:00
+  for(int i=0; i<20000; i++)
+    {
+      t += (i % 3000 == 2999) ? 1.7 : 0.005;
+      rov_time_set(t);
+      snprintf(data, sizeof(data), "%d,0.001,0.002,0.003,0.1,0.2,9.8,0.2,0.05,-0.4", i);
+      log_this_now_dsl_format(LOG_FID_KVH_FORMAT, name, data);
+    }
+  log_flush_and_close_log_files();
+  log_set_index_interval(LOG_FID_KVH_FORMAT, 0, 0);
+  rov_time_mode_set(ROV_TIME_MODE_NORMAL);
+
+  std::vector<std::string> files;
+  ingest_list_dir(dir, "KVH", files);
+  if(files.size() != 1)
+    {
+      printf("FAIL: logger wrote %d files\n", (int) files.size());
+      errors++;
+    }
+  else
+    {
+      const char* filename = files[0].c_str();
+      const std::string log = read_file(filename);
+      const std::string written = read_file(log_index_filename(filename).c_str());
+
+      LogIndex index;
+      int bad = 0;
+      if(index.open(filename) != 0 || index.size() < 200)
+	bad++;
+      for(size_t i=0; i<index.size(); i++)
+	{
+	  const log_index_entry_t& e = index.entry(i);
+	  if(e.offset >= log.size() || (e.offset > 0 && log[e.offset - 1] != '\n') ||
+	     log_merge_parse_time(log.c_str() + e.offset, log.c_str() + log.size()) != e.time_ns)
+	    bad++;
+	}
+      index.close();
+      if(bad)
+	{
+	  printf("FAIL: logger sidecar index has %d bad entries\n", bad);
+	  errors++;
+	}
+
+      if(log_index_build(filename, 100, 250) < 0 || read_file(log_index_filename(filename).c_str()) != written)
+	{
+	  printf("FAIL: log_index_build differs from the logger's index\n");
+	  errors++;
+	}
+
+      errors += check_seeks("logger index", filename, 2000);
+
+      FILE* fp = log_index_open_at(filename, 1760868030LL*1000000000LL);
+      char line[256];
+      if(fp == NULL || fgets(line, sizeof(line), fp) == NULL ||
+	 log_merge_parse_time(line, line + strlen(line)) != 1760868030LL*1000000000LL)
+	{
+	  printf("FAIL: log_index_open_at\n");
+	  errors++;
+	}
+      if(fp != NULL)
+	fclose(fp);
+
+      // without a sidecar, seeks fall back to a scan
+      remove(log_index_filename(filename).c_str());
+      errors += check_seeks("no index", filename, 200);
+
+      remove(filename);
+    }
+  rmdir(dir);
+
+  // backfill a directory of ns-timestamped logs
+  mkdir(dir, 0755);
+  write_channel(dir, 0, 4, 3000, 1000000, NULL);
+  const std::string kvh_dir = std::string(dir) + "/KVH";
+  if(log_index_build_dir(kvh_dir.c_str(), "KVH", 0, 100) != 4)
+    {
+      printf("FAIL: log_index_build_dir\n");
+      errors++;
+    }
+  files.clear();
+  ingest_list_dir(kvh_dir.c_str(), "KVH", files);
+  for(size_t i=0; i<files.size(); i++)
+    errors += check_seeks("backfilled index", files[i].c_str(), 300);
+  remove_channels(dir);
+
+  return errors;
+}
+
+static void bench_index(size_t corpus_mb)
+{
+  char dir[256];
+  char sub[512];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_index_bench_%d", (int) getpid());
+  snprintf(sub, sizeof(sub), "%s/KVH", dir);
+  mkdir(dir, 0755);
+
+  const int lines = (int) ((corpus_mb << 20)/80/INGEST_FILES);
+  write_channel(dir, 0, INGEST_FILES, lines, 1000000, NULL);
+
+  std::vector<std::string> files;
+  ingest_list_dir(sub, "KVH", files);
+  uint64_t bytes = 0;
+  for(size_t i=0; i<files.size(); i++)
+    bytes += read_file(files[i].c_str()).size();
+
+  // linear scan to the middle of a file, before there is an index
+  const int64_t t_mid = 1760868000LL*1000000000LL + (int64_t) lines/2*1000000;
+  double t0 = now_sec();
+  log_index_find(files[0].c_str(), t_mid);
+  const double t_scan = now_sec() - t0;
+
+  t0 = now_sec();
+  log_index_build_dir(sub, "KVH", 1000, 1000);
+  const double t_build = now_sec() - t0;
+
+  const int num = 2000;
+  srand(38);
+  t0 = now_sec();
+  for(int i=0; i<num; i++)
+    log_index_find(files[i % files.size()].c_str(),
+		   1760868000LL*1000000000LL + (int64_t) (lines*(rand()/(RAND_MAX + 1.0)))*1000000);
+  const double t_seek = (now_sec() - t0)/num;
+
+  printf("index: backfill %7.0f MB/s, seek %6.1f us vs %6.1f ms linear scan to mid-file (%d MB files)\n",
+	 1e-6*bytes/t_build, 1e6*t_seek, 1e3*t_scan, (int) (bytes/files.size() >> 20));
+
+  remove_channels(dir);
+}
+
+// byte loop version of log_clean_string() before text_scan.h
+static void clean_bytes(char* str)
+{
+  while(*str != '\0')
+    {
+      if((*str == '\n') || (*str == '\r'))
+	*str = ' ';
+      str++;
+    }
+}
+
+static int check_text_scan(void)
+{
+  int errors = 0;
+  static const char alphabet[] = "abc ,\n\r\t\x01\x7f\x80\xff" "0123456789";
+  std::vector<char> buf(400);
+  srand(39);
+
+  for(int trial=0; trial<3000; trial++)
+    {
+      const size_t off = trial % 64;
+      const size_t len = rand() % 300;
+      for(size_t i=0; i<buf.size(); i++)
+	buf[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+      char* p = &buf[off];
+      char* end = p + len;
+
+      // clean
+      for(int mode=0; mode<2; mode++)
+	{
+	  std::vector<char> a(p, end), b(p, end);
+	  size_t changed = 0;
+	  for(size_t i=0; i<a.size(); i++)
+	    {
+	      const unsigned char u = (unsigned char) a[i];
+	      if((mode == TEXT_SCAN_CLEAN_EOL) ? (u == '\n' || u == '\r') : ((u < 0x20 && u != '\t') || u == 0x7f))
+		{
+		  a[i] = ' ';
+		  changed++;
+		}
+	    }
+	  if(text_scan_clean(b.empty() ? NULL : &b[0], b.size(), mode) != changed || a != b)
+	    errors++;
+	}
+    }
+
+  if(errors)
+    printf("FAIL: text_scan disagrees with byte loops %d times\n", errors);
+
+  // DSL records
+  const char* rec = "KVH  2025/10/19 10:00:00.123\t1.5,2,3\r\n";
+  DslRecordView v;
+  if(text_scan_split_dsl(rec, NULL, v) != 0 || std::string(v.name.p, v.name.len) != "KVH" ||
+     std::string(v.time.p, v.time.len) != "2025/10/19 10:00:00.123" ||
+     std::string(v.payload.p, v.payload.len) != "1.5,2,3" ||
+     text_scan_split_dsl("KVH 2025/10/19", NULL, v) == 0 ||
+     text_scan_split_dsl("KVH 2025/10/19 10:00:00", NULL, v) != 0 || v.payload.len != 0)
+    {
+      printf("FAIL: text_scan_split_dsl\n");
+      errors++;
+    }
+
+  char str[] = "a\nb\rc\n";
+  log_clean_string(str);
+  if(strcmp(str, "a b c ") != 0)
+    {
+      printf("FAIL: log_clean_string\n");
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_text_scan(size_t corpus_mb)
+{
+  // DSL records like the KVH log
+  std::string text;
+  text.reserve((corpus_mb << 20) + 256);
+  char line[256];
+  for(int i=0; text.size() < (corpus_mb << 20); i++)
+    {
+      snprintf(line, sizeof(line), "KVH 2025/10/19 10:%02d:%02d.%03d %d,0.001234,-0.002345,0.003456,0.1234,0.2345,9.8123,0.2,0.05,-0.4\n",
+	       (i/60000) % 60, (i/1000) % 60, i % 1000, i);
+      text += line;
+    }
+  const char* p = text.data();
+  const char* end = p + text.size();
+  const double gb = 1e-9*text.size();
+  volatile size_t sink = 0;
+  double t0, t;
+
+  printf("text scan, %d MB of DSL records:\n", (int) (text.size() >> 20));
+
+  // lines
+  {
+    size_t n = 0;
+    t0 = now_sec();
+    for(const char* q = p; q < end; q++)
+      n += (*q == '\n');
+    t = now_sec() - t0;
+    sink += n;
+    printf("  lines, byte loop:        %6.2f GB/s\n", gb/t);
+
+    n = 0;
+    t0 = now_sec();
+    for(const char* q = p; q < end; n++)
+      {
+	const char* nl = (const char*) memchr(q, '\n', end - q);
+	q = (nl == NULL) ? end : nl + 1;
+      }
+    t = now_sec() - t0;
+    sink += n;
+    printf("  lines, memchr:           %6.2f GB/s\n", gb/t);
+  }
+
+  // clean, on NUL-terminated copies as log_clean_string() sees them
+  {
+    std::string a = text, b = text;
+
+    t0 = now_sec();
+    clean_bytes(&a[0]);
+    t = now_sec() - t0;
+    printf("  clean, byte loop:        %6.2f GB/s\n", gb/t);
+
+    t0 = now_sec();
+    log_clean_string(&b[0]);
+    t = now_sec() - t0;
+    printf("  clean, log_clean_string: %6.2f GB/s\n", gb/t);
+
+    if(a != b)
+      printf("FAIL: log_clean_string differs from the byte loop\n");
+  }
+
+  // split every record
+  {
+    DslRecordView rec;
+    size_t n = 0;
+    t0 = now_sec();
+    for(const char* q = p; q < end; )
+      {
+	const char* nl = (const char*) memchr(q, '\n', end - q);
+	if(nl == NULL)
+	  nl = end;
+	if(text_scan_split_dsl(q, nl, rec) == 0)
+	  n += rec.payload.len;
+	q = nl + 1;
+      }
+    t = now_sec() - t0;
+    sink += n;
+    printf("  split records:           %6.2f GB/s\n", gb/t);
+  }
+
+  (void) sink;
+}
+
+// consume a replay from this thread until it is done
+static void drain_replay(LogReplay& replay, ImuSampleRing& ring, ImuSampleVector* out)
+{
+  ImuSample buf[256];
+  for(;;)
+    {
+      const bool done = replay.done();
+      size_t n = ring.wait_pop(buf, 256, 0.01);
+      if(out != NULL)
+	out->insert(out->end(), buf, buf + n);
+      if(n == 0 && done)
+	break;
+    }
+}
+
+static int check_replay_files(const char* what, const std::vector<std::string>& files, double hz)
+{
+  ImuBatch ref;
+  IngestStats ist;
+  ingest_files(files, ref, &ist, hz);
+
+  ImuSampleRing ring(1024, SPSC_WAKE_FUTEX);
+  LogReplay replay(ring, REPLAY_UNTHROTTLED, hz, 4096);
+  ImuSampleVector got;
+
+  if(replay.open(files) != 0 || replay.start() != 0)
+    {
+      printf("FAIL: %s replay did not start\n", what);
+      return 1;
+    }
+  drain_replay(replay, ring, &got);
+  replay.wait();
+
+  int bad = 0;
+  for(size_t i=0; i<got.size() && i<ref.size(); i++)
+    {
+      const ImuPacket p = ref.packet(i);
+      if(got[i].timestamp != p.t || got[i].diff != p.dt || got[i].seq_num != (uint32_t) p.seq_num ||
+	 got[i].ang_vec() != p.ang || got[i].acc_vec() != p.acc || got[i].mag_vec() != p.mag)
+	bad++;
+    }
+
+  if(bad || got.size() != ref.size() || replay.stats().samples != ref.size() ||
+     replay.stats().bad_records != ist.bad_records || replay.stats().files != (int) files.size())
+    {
+      printf("FAIL: %s replay: %d of %d samples (%d expected), %d differ, %d bad records (%d expected)\n",
+	     what, (int) got.size(), (int) replay.stats().samples, (int) ref.size(), bad,
+	     (int) replay.stats().bad_records, (int) ist.bad_records);
+      return 1;
+    }
+
+  return 0;
+}
+
+static int check_replay(void)
+{
+  int errors = 0;
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_replay_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  write_corpus(dir, false, 3, 200000);
+  write_corpus(dir, true, 3, 100000);
+
+  std::vector<std::string> text, binary;
+  ingest_list_dir(dir, "KVH", text);
+  ingest_list_dir(dir, "BKVH", binary);
+  errors += check_replay_files("text", text, 0.0);
+  errors += check_replay_files("KVH binary", binary, 1000.0);
+  remove_corpus(dir);
+
+  // 3 s of 100 Hz records at 10x, driving the RENAV clock
+  mkdir(dir, 0755);
+  write_corpus(dir, false, 1, 45000);
+  text.clear();
+  ingest_list_dir(dir, "KVH", text);
+
+  ImuSampleRing ring(1024, SPSC_WAKE_FUTEX);
+  LogReplay replay(ring, 10.0);
+  ImuSampleVector got;
+  replay.set_drive_clock(true);
+  replay.open(text);
+  replay.start();
+  drain_replay(replay, ring, &got);
+  replay.wait();
+
+  const double span = got.empty() ? 0.0 : got.back().timestamp - got.front().timestamp;
+  const double clock = rov_get_time();
+  const double expect = rov_time_compute(2026, 10, 19, 0, 0, 0.0) + span;
+  rov_time_mode_set(ROV_TIME_MODE_NORMAL);
+
+  if(got.size() < 200 || fabs(replay.stats().elapsed - span/10.0) > 0.05 + 0.1*span/10.0)
+    {
+      printf("FAIL: replay of %.2f s at 10x took %.3f s\n", span, replay.stats().elapsed);
+      errors++;
+    }
+  if(fabs(clock - expect) > 1e-3 || got.empty() || fabs(got.back().comp_timestamp - expect) > 1e-6)
+    {
+      printf("FAIL: replay left the RENAV clock at %.3f, expected %.3f\n", clock, expect);
+      errors++;
+    }
+  remove_corpus(dir);
+
+  return errors;
+}
+
+static void bench_replay(size_t corpus_mb)
+{
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_replay_bench_%d", (int) getpid());
+  mkdir(dir, 0755);
+  write_corpus(dir, false, INGEST_FILES, (corpus_mb << 20)/INGEST_FILES);
+  write_corpus(dir, true, 2, 4 << 20);
+
+  // unthrottled text
+  {
+    ImuSampleRing ring(4096, SPSC_WAKE_FUTEX);
+    LogReplay replay(ring, REPLAY_UNTHROTTLED);
+    replay.open(dir, "KVH");
+    replay.start();
+    drain_replay(replay, ring, NULL);
+    replay.wait();
+    const ReplayStats& s = replay.stats();
+    printf("replay, text, unthrottled: %5.2f Msamples/s, %d MB\n", 1e-6*s.samples/s.elapsed, (int) corpus_mb);
+  }
+
+  // 1 kHz KVH at 100x for 2 s
+  {
+    ImuSampleRing ring(4096, SPSC_WAKE_FUTEX);
+    LogReplay replay(ring, 100.0, 1000.0);
+    replay.open(dir, "BKVH");
+    replay.start();
+    const double t0 = now_sec();
+    ImuSample buf[256];
+    uint64_t n = 0;
+    while(now_sec() - t0 < 2.0 && !(replay.done() && ring.empty()))
+      n += ring.wait_pop(buf, 256, 0.01);
+    replay.stop();
+    const ReplayStats& s = replay.stats();
+    printf("replay, KVH binary 1 kHz at 100x: %6.0f samples/s, max lag %.2f ms, starved %d times\n",
+	   n/(now_sec() - t0), 1e3*s.max_lag, (int) s.starved);
+  }
+
+  remove_corpus(dir);
+}
+
+// a config file whose gains are all gain, written in place or by rename
+static void write_config(const char* filename, double gain, bool with_hz, bool by_rename)
+{
+  const std::string tmp = std::string(filename) + ".tmp";
+  FILE* fp = fopen(by_rename ? tmp.c_str() : filename, "w");
+
+  if(with_hz)
+    fprintf(fp, "hz = 1000\n");
+  fprintf(fp, "rate = 100\nlat = 39.32\nlast_mod = \"2026-10-19\"\n");
+  const char* gains[8] = {"k_acc", "k_mag", "k_ang_bias", "k_acc_bias", "k_mag_bias", "k_E_n", "k_g", "k_north"};
+  for(int i=0; i<8; i++)
+    fprintf(fp, "%s = [%g,%g,%g]\n", gains[i], gain, gain, gain);
+  fprintf(fp, "rpy_align = [0,0,%g]\nrpy_ro = [0,0,0]\n", 0.001*gain);
+  fprintf(fp, "ang_bias = [0,0,0]\nacc_bias = [0,0,0]\nmag_bias = [0,0,0]\n");
+  fclose(fp);
+
+  if(by_rename)
+    rename(tmp.c_str(), filename);
+}
+
+// wait for the watcher thread to count n loads or rejections
+static bool wait_config(const ConfigWatcher& config, uint64_t loads, uint64_t rejected)
+{
+  const double t0 = now_sec();
+  while(now_sec() - t0 < 5.0)
+    {
+      if(config.version() >= loads && config.rejected() >= rejected)
+	return true;
+      usleep(1000);
+    }
+  return false;
+}
+
+// the same config parsed as the old sscanf chain would have
+static bool same_params(const config_params& a, const config_params& b)
+{
+  return a.hz == b.hz && a.rate == b.rate && a.baud == b.baud && a.lat == b.lat &&
+    a.o_file == b.o_file && a.i_file == b.i_file && a.last_mod == b.last_mod && a.port == b.port &&
+    a.K_acc == b.K_acc && a.K_mag == b.K_mag && a.K_ang_bias == b.K_ang_bias &&
+    a.K_acc_bias == b.K_acc_bias && a.K_mag_bias == b.K_mag_bias && a.K_E_n == b.K_E_n &&
+    a.K_g == b.K_g && a.K_north == b.K_north && a.R0 == b.R0 && a.R_align == b.R_align &&
+    a.ang_bias == b.ang_bias && a.acc_bias == b.acc_bias && a.mag_bias == b.mag_bias &&
+    a.acc_hat == b.acc_hat && a.w_E_north == b.w_E_north;
+}
+
+static int check_config_parse(void)
+{
+  int errors = 0;
+
+  // every field, with the spacing and line ends files have in the wild
+  const char* good =
+    "# test rig\r\n"
+    "hz = 1000\r\n"
+    "rate=100\n"
+    "baud = 115200\n"
+    "lat = 39.32\n"
+    "\n"
+    "o_file = \"out.csv\"\n"
+    "i_file = \"in.csv\"   \n"
+    "last_mod = \"2026-10-19\"\n"
+    "port = /dev/ttyUSB0\n"
+    "k_acc = [1,2,3]\n"
+    "k_mag = [ 0.5 , 0.25 , 0.125 ]\n"
+    "k_ang_bias = [0.01,0.01,0.01]\n"
+    "k_acc_bias = [0.1,0.1,0.1]\n"
+    "k_mag_bias = [0.1,0.1,0.1]\n"
+    "k_E_n = [1e-3,1e-3,1e-3]\n"
+    "k_g = [2,2,2]\n"
+    "k_north = [3,3,3]\n"
+    "rpy_align = [3.14159265358979,0,0]\n"
+    "rpy_ro = [0,0,1.5]\n"
+    "ang_bias = [1e-5,-2e-5,3e-5]\n"
+    "acc_bias = [0,0,0]\n"
+    "mag_bias = [0,0,0]\n"
+    "w_E_north = [0,0,7.29e-5]";
+
+  config_params p;
+  ConfigReport report;
+  const int r = config_parse(good, strlen(good), p, &report);
+  char why[128] = "";
+  const bool usable = (config_params_check(p, why, sizeof(why)) == 0);
+  if(r != 0 || !report.text.empty() || !usable || p.hz != 1000 || p.rate != 100 || p.baud != 115200 ||
+     fabs(p.lat - 39.32*M_PI/180.0) > 1e-6 || p.o_file != "out.csv" || p.port != "/dev/ttyUSB0" ||
+     p.K_mag(2,2) != 0.125 || p.K_mag(0,1) != 0.0 || p.K_E_n(1,1) != 1e-3 ||
+     (p.R0 - rpy2rot(Eigen::Vector3d(0, 0, 1.5))).norm() != 0.0 || p.ang_bias(1) != -2e-5 ||
+     p.w_E_north(2) != 7.29e-5 || p.acc_hat(0) != -100.0)
+    {
+      printf("FAIL: config_parse of a good file: %d, %s %s\n", r, report.text.c_str(), why);
+      errors++;
+    }
+
+  // the same with a comment after every value
+  {
+    std::string commented;
+    for(const char* l=good; *l; )
+      {
+	const char* eol = strchr(l, '\n');
+	std::string line(l, eol ? eol - l : strlen(l));
+	l = eol ? eol + 1 : l + line.size();
+	const bool cr = !line.empty() && line[line.size()-1] == '\r';
+	if(cr)
+	  line.erase(line.size() - 1);
+	if(!line.empty() && line[0] != '#')
+	  line += (line.size() % 2) ? "  # note" : "\t#note";
+	commented += line + (cr ? "\r\n" : "\n");
+      }
+    config_params c;
+    ConfigReport cr;
+    if(config_parse(commented.data(), commented.size(), c, &cr) != 0 || !cr.text.empty() || !same_params(p, c))
+      {
+	printf("FAIL: config_parse with trailing comments: %s", cr.text.c_str());
+	errors++;
+      }
+  }
+
+  // a typo, a bad vector, a repeat and a line without =
+  const char* bad =
+    "hz = 1000\nlat = 39.32\nk_acc = [1,2]\nk_mag = [1,1,1]\nk_ang_bias = [1,1,1]\n"
+    "k_acc_bias = [1,1,1]\nk_mag_bias = [1,1,1]\nk_E_n = [1,1,1]\nk_g = [1,1,1]\n"
+    "k_north = [1,1,1]\nk_north = [4,4,4]\nrpy_align = [0,0,0]\nrpy_r0 = [0,0,0]\n"
+    "ang_bias = [0,0,0]\nacc_bias = [0,0,0]\nmag_bias = [0,0,0]\nnothing here\n"
+    "hz = 100x\nlat = 3 9\n";
+  ConfigReport br;
+  config_params q;
+  if(config_parse(bad, strlen(bad), q, &br) != -1 || br.unknown != 1 || br.missing != 1 ||
+     br.malformed != 4 || br.duplicate != 3 || q.K_north(0,0) != 4.0 ||
+     q.hz != 1000 || fabs(q.lat - 39.32*M_PI/180.0) > 1e-6 ||
+     br.text.find("line 13: unknown key rpy_r0 (rpy_ro?)") == std::string::npos ||
+     br.text.find("missing rpy_ro") == std::string::npos ||
+     br.text.find("line 3: bad value for k_acc") == std::string::npos)
+    {
+      printf("FAIL: config_parse report:\n%s", br.text.c_str());
+      errors++;
+    }
+
+  // parallel load of many files equals loading them one by one
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_config_%d", (int) getpid());
+  mkdir(dir, 0755);
+  std::vector<std::string> files;
+  for(int i=0; i<64; i++)
+    {
+      char filename[512];
+      snprintf(filename, sizeof(filename), "%s/sweep_%02d.cfg", dir, i);
+      write_config(filename, 0.5 + i, i != 17, false);
+      files.push_back(filename);
+    }
+  std::vector<config_params> many;
+  std::vector<ConfigReport> reports;
+  const int failed = config_load_many(files, many, &reports, 4);
+  bool same = (many.size() == files.size());
+  for(size_t i=0; same && i<files.size(); i++)
+    {
+      config_params one;
+      const int ok = config_load(files[i].c_str(), one, NULL);
+      same = same_params(one, many[i]) && (ok < 0) == (i == 17) && (reports[i].missing == (i == 17));
+    }
+  if(failed != 1 || !same)
+    {
+      printf("FAIL: config_load_many: %d failed, same %d\n", failed, (int) same);
+      errors++;
+    }
+  for(size_t i=0; i<files.size(); i++)
+    unlink(files[i].c_str());
+  rmdir(dir);
+
+  return errors;
+}
+
+static void bench_config_parse(void)
+{
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_config_bench_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  const int n = 2000;
+  std::vector<std::string> files;
+  for(int i=0; i<n; i++)
+    {
+      char filename[512];
+      snprintf(filename, sizeof(filename), "%s/sweep_%04d.cfg", dir, i);
+      write_config(filename, 1.0 + 0.01*i, true, false);
+      files.push_back(filename);
+    }
+
+  std::vector<config_params> configs;
+  const int threads[3] = {1, 2, 4};
+  for(int k=0; k<3; k++)
+    {
+      const double t0 = now_sec();
+      config_load_many(files, configs, NULL, threads[k]);
+      const double t = now_sec() - t0;
+      printf("config parse, %d files, %d threads: %5.1f us/file\n", n, threads[k], 1e6*t/n);
+    }
+
+  // one file parsed in memory, no I/O
+  std::string text;
+  {
+    FILE* fp = fopen(files[0].c_str(), "r");
+    char buf[4096];
+    size_t len;
+    while((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+      text.append(buf, len);
+    fclose(fp);
+  }
+  config_params p;
+  const int reps = 20000;
+  const double t0 = now_sec();
+  for(int i=0; i<reps; i++)
+    config_parse(text.data(), text.size(), p, NULL);
+  const double t = now_sec() - t0;
+  printf("config parse, in memory: %5.2f us/file, %4.0f ns/line\n", 1e6*t/reps, 1e9*t/reps/18.0);
+
+  for(int i=0; i<n; i++)
+    unlink(files[i].c_str());
+  rmdir(dir);
+}
+
+static int check_config(void)
+{
+  int errors = 0;
+  char filename[256];
+  snprintf(filename, sizeof(filename), "/tmp/parse_test_%d.cfg", (int) getpid());
+
+  write_config(filename, 1.0, true, false);
+  ConfigWatcher config(filename);
+  if(config.current() != NULL || config.reload() < 0 || config.current()->hz != 1000 ||
+     config.current()->K_acc(1,1) != 1.0 || config.version() != 1)
+    {
+      printf("FAIL: ConfigWatcher did not load %s\n", filename);
+      unlink(filename);
+      return 1;
+    }
+
+  // a reader spinning on the params; every snapshot must be whole
+  std::atomic<bool> done(false);
+  std::atomic<int> torn(0);
+  std::atomic<uint64_t> reads(0);
+  std::thread reader([&]() {
+      while(!done.load())
+	{
+	  const config_params* p = config.current();
+	  const double g = p->K_acc(0,0);
+	  if(p->K_north(2,2) != g || fabs(p->R_align(0,1) + sin(0.001*g)) > 1e-12 || p->hz != 1000)
+	    torn++;
+	  reads++;
+	}
+    });
+
+  config.start();
+  for(int i=2; i<=20; i++)
+    {
+      write_config(filename, (double) i, true, i % 2);
+      if(!wait_config(config, i, 0))
+	break;
+    }
+  const bool loaded = (config.version() == 20 && config.current()->K_mag(0,0) == 20.0);
+
+  // missing hz: rejected, the params stay
+  write_config(filename, 99.0, false, true);
+  const bool rejected = wait_config(config, 20, 1) && config.version() == 20 &&
+    config.current()->K_acc(0,0) == 20.0;
+
+  write_config(filename, 21.0, true, true);
+  const bool recovered = wait_config(config, 21, 1) && config.current()->K_acc(0,0) == 21.0;
+
+  done = true;
+  reader.join();
+  config.stop();
+
+  if(!loaded || !rejected || !recovered || torn.load() != 0)
+    {
+      printf("FAIL: ConfigWatcher: version %d, %d rejected, %d torn reads of %llu\n",
+	     (int) config.version(), (int) config.rejected(), torn.load(), (unsigned long long) reads.load());
+      errors++;
+    }
+
+  // edits to other files in the directory are ignored
+  const std::string other = std::string(filename) + ".other";
+  write_config(other.c_str(), 5.0, true, false);
+  unlink(other.c_str());
+  if(config.poll_once(100) != 0 || config.version() != 21)
+    {
+      printf("FAIL: ConfigWatcher reloaded on another file\n");
+      errors++;
+    }
+
+  unlink(filename);
+
+  return errors;
+}
+
+static void bench_config(void)
+{
+  char filename[256];
+  snprintf(filename, sizeof(filename), "/tmp/parse_test_bench_%d.cfg", (int) getpid());
+  write_config(filename, 1.0, true, false);
+  ConfigWatcher config(filename);
+  config.reload();
+
+  // the hot-path read: one load, then the gains in place
+  const int n = 100000000;
+  double sum = 0.0;
+  double t0 = now_sec();
+  for(int i=0; i<n; i++)
+    sum += config.current()->K_acc(0,0);
+  const double t_read = now_sec() - t0;
+
+  const int loads = 20;
+  t0 = now_sec();
+  for(int i=0; i<loads; i++)
+    config.reload();
+  const double t_load = now_sec() - t0;
+
+  printf("config: current() %.2f ns, reload %.0f us (%.0f)\n", 1e9*t_read/n, 1e6*t_load/loads, sum/n);
+  unlink(filename);
+}
+
+static int check_sweep(void)
+{
+  int errors = 0;
+  char dir[128];
+  snprintf(dir, sizeof(dir), "/tmp/parse_test_sweep_%d", (int) getpid());
+  mkdir(dir, 0755);
+
+  const std::string log_file = std::string(dir) + "/2026_10_19_00_00.KVH";
+  const int num_pkts = 2000;
+  {
+    char payload[IMU_LOG_MAX_PAYLOAD];
+    FILE* fp = fopen(log_file.c_str(), "w");
+    for(int i=0; i<num_pkts; i++)
+      {
+	imu_log_sprintf_payload(payload, make_packet(i));
+	fprintf(fp, "IMU 2026/10/19 00:00:00.000 %s\n", payload);
+      }
+    fclose(fp);
+  }
+
+  // config 3 has no hz
+  const int num_configs = 6;
+  const int broken = 3;
+  std::vector<std::string> files;
+  for(int i=0; i<num_configs; i++)
+    {
+      files.push_back(std::string(dir) + "/sweep_" + std::to_string(i) + ".cfg");
+      write_config(files.back().c_str(), 0.25*(i + 1), i != broken, false);
+    }
+
+  std::vector<config_params> configs;
+  std::vector<config_params> configs_1;
+  std::vector<SweepResult> results;
+  std::vector<SweepResult> results_1;
+  const int num = sweep_files(log_file.c_str(), files, configs, results, 0);
+  const int num_1 = sweep_files(log_file.c_str(), files, configs_1, results_1, 1);
+
+  if(num != num_pkts || num_1 != num_pkts || (int) results.size() != num_configs || (int) results_1.size() != num_configs)
+    {
+      printf("FAIL: sweep loaded %d and %d of %d packets, %d results\n", num, num_1, num_pkts, (int) results.size());
+      errors++;
+    }
+  else
+    for(int i=0; i<num_configs; i++)
+      {
+	const SweepResult& r = results[i];
+	const SweepResult& r1 = results_1[i];
+
+	if(i == broken)
+	  {
+	    if(r.ok || r1.ok || r.num_updates != 0)
+	      {
+		printf("FAIL: sweep ran config %d, which has no hz\n", i);
+		errors++;
+	      }
+	    continue;
+	  }
+
+	if(!r.ok || r.num_updates != num_pkts - 1 || !std::isfinite(r.acc_rms) || !r.rph.allFinite())
+	  {
+	    printf("FAIL: sweep config %d: ok %d, %d updates, acc_rms %g\n", i, r.ok, r.num_updates, r.acc_rms);
+	    errors++;
+	  }
+	else if(!r1.ok || r.num_updates != r1.num_updates || r.acc_rms != r1.acc_rms || r.mag_rms != r1.mag_rms ||
+		r.rph != r1.rph || r.ang_bias != r1.ang_bias || r.acc_bias != r1.acc_bias || r.mag_bias != r1.mag_bias)
+	  {
+	    printf("FAIL: sweep config %d differs between all cores and one thread\n", i);
+	    errors++;
+	  }
+      }
+
+  // one header line and one line per config
+  FILE* fp = tmpfile();
+  sweep_print_table(fp, configs, results);
+  rewind(fp);
+  int lines = 0;
+  int rejected = 0;
+  char line[512];
+  while(fgets(line, sizeof(line), fp))
+    {
+      lines++;
+      rejected += (strstr(line, "rejected") != NULL);
+    }
+  fclose(fp);
+  if(lines != num_configs + 1 || rejected != 1)
+    {
+      printf("FAIL: sweep table has %d lines, %d rejected\n", lines, rejected);
+      errors++;
+    }
+
+  for(int i=0; i<num_configs; i++)
+    unlink(files[i].c_str());
+  unlink(log_file.c_str());
+  rmdir(dir);
+
+  return errors;
+}
+
+int main( int argc, const char* argv[])
+{
+  int errors = 0;
+  const size_t corpus_mb = (argc > 1) ? (size_t) atol(argv[1]) : 128;
+
+  fprintf(stderr, "\nFILE %s compiled on %s %s\n",__FILE__,__TIME__,__DATE__);
+
+  // CRC-32/MPEG-2 check value
+  if(binlog_crc32_kvh((const uint8_t*) "123456789", 9) != 0x0376E6E7u)
+    {
+      printf("FAIL: binlog_crc32_kvh check value\n");
+      errors++;
+    }
+
+  errors += check_format(BINLOG_FORMAT_KVH, "KVH", "BKVH");
+  errors += check_format(BINLOG_FORMAT_MST, "MST", "BMS");
+  errors += check_format(BINLOG_FORMAT_PHINS, "PHINS", "BINS");
+  errors += check_phins_fixture();
+
+  // throughput
+  {
+    const int formats[3] = {BINLOG_FORMAT_KVH, BINLOG_FORMAT_MST, BINLOG_FORMAT_PHINS};
+    const char* names[3] = {"KVH", "MST", "PHINS"};
+
+    for(int f=0; f<3; f++)
+      {
+	std::vector<uint8_t> stream;
+	stream.reserve(BENCH_BYTES + BINLOG_MAX_FRAME);
+	uint8_t buf[BINLOG_MAX_FRAME];
+	for(int i=0; stream.size() < BENCH_BYTES; i++)
+	  {
+	    int len = encode(formats[f], make_packet(i), buf);
+	    stream.insert(stream.end(), buf, buf + len);
+	  }
+
+	BinlogParser parser(formats[f], 1000.0);
+	ImuBatch out;
+	out.reserve(stream.size()/32);
+
+	double t0 = now_sec();
+	parser.parse(&stream[0], stream.size(), out);
+	double t = now_sec() - t0;
+
+	printf("parse %-6s %7.0f MB/s, %6.1f Msamples/s\n", names[f],
+	       1e-6*stream.size()/t, 1e-6*out.size()/t);
+      }
+  }
+
+  errors += check_ingest();
+  bench_ingest(corpus_mb);
+
+  errors += check_merge();
+  bench_merge(corpus_mb);
+
+  errors += check_archive();
+  bench_archive(corpus_mb);
+
+  errors += check_index();
+  bench_index(corpus_mb);
+
+  errors += check_text_scan();
+  bench_text_scan(corpus_mb);
+
+  errors += check_replay();
+  bench_replay(corpus_mb);
+
+  errors += check_config_parse();
+  bench_config_parse();
+
+  errors += check_config();
+  bench_config();
+
+  errors += check_sweep();
+
+  printf("%s\n", errors ? "parse_test FAILED" : "parse_test OK");
+
+  return errors ? 1 : 0;
+}
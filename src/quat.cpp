@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of quat.h.
+ *
+ */
+
+#include <helper_funcs/quat.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+int slerp_batch(const double* t_in, const Eigen::Quaterniond* q_in, int n_in,
+		const double* t_out, Eigen::Quaterniond* q_out, int n_out)
+{
+
+  if(n_in < 1 || n_out < 0)
+    return -1;
+
+  int i = 0;
+
+  for(int j=0; j<n_out; j++)
+    {
+
+      const double t = t_out[j];
+
+      // clamp outside the input span
+      if(t <= t_in[0])
+	{
+	  q_out[j] = q_in[0];
+	  continue;
+	}
+      if(t >= t_in[n_in-1])
+	{
+	  q_out[j] = q_in[n_in-1];
+	  continue;
+	}
+
+      // advance to the bracketing interval, t_in[i] <= t < t_in[i+1]
+      while(t_in[i+1] <= t)
+	i++;
+
+      const double span = t_in[i+1] - t_in[i];
+      const double s = (span > 0.0) ? (t - t_in[i])/span : 0.0;
+
+      q_out[j] = q_in[i].slerp(s, q_in[i+1]);
+
+    }
+
+  return n_out;
+
+}
@@ -0,0 +1,393 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of replay.h.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <helper_funcs/replay.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/imu_log.h>
+#include <helper_funcs/imu_batch.h>
+#include <helper_funcs/ingest.h>
+#include <helper_funcs/log_merge.h>
+#include <helper_funcs/time_util.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define REPLAY_PIECE (1 << 20)  // binary bytes parsed at a time
+#define REPLAY_BURST 256        // samples moved between rings at a time
+#define REPLAY_POLL  0.01       // longest sleep before checking for stop (units: seconds)
+
+static double replay_now(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static void replay_sleep_until(double t)
+{
+  timespec ts;
+  ts.tv_sec = (time_t) t;
+  ts.tv_nsec = (long) ((t - ts.tv_sec)*1e9);
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static void replay_sleep(double secs)
+{
+  replay_sleep_until(replay_now() + secs);
+}
+
+// RENAV time of the first record of a log: its DSL time for text logs,
+// the opening time in the file name for binary ones
+static double replay_clock_base(const std::string& filename, int format)
+{
+
+  if(format == BINLOG_FORMAT_UNKNOWN)
+    {
+      MappedFile map;
+      if(map.open(filename.c_str()) != 0)
+	return 0.0;
+
+      const char* p = (const char*) map.data();
+      const char* end = p + map.size();
+      ImuPacket pkt;
+
+      while(p < end)
+	{
+	  const char* nl = (const char*) memchr(p, '\n', end - p);
+	  const char* le = (nl == NULL) ? end : nl;
+
+	  if(imu_log_parse_record(p, le, pkt) == 0)
+	    {
+	      const int64_t t = log_merge_parse_time(p, le);
+	      return (t == LOG_MERGE_BAD_TIME) ? 0.0 : 1e-9*t;
+	    }
+
+	  p = (nl == NULL) ? end : nl + 1;
+	}
+
+      return 0.0;
+    }
+
+  const size_t slash = filename.rfind('/');
+  const char* name = filename.c_str() + ((slash == std::string::npos) ? 0 : slash + 1);
+  int year, month, day, hour, min;
+
+  if(sscanf(name, "%4d_%2d_%2d_%2d_%2d", &year, &month, &day, &hour, &min) != 5)
+    return 0.0;
+
+  return rov_time_compute(year, month, day, hour, min, 0.0);
+
+}
+
+LogReplay::LogReplay(ImuSampleRing& out_, double speed_, double hz_, size_t read_ahead)
+  : out(out_), speed(speed_), hz(hz_), drive_clock(false), lossy(false),
+    format(BINLOG_FORMAT_UNKNOWN), clock_base(0.0),
+    ahead(read_ahead, SPSC_WAKE_FUTEX), stopping(false), read_done(false), finished(false),
+    bad_records(0), files_read(0)
+{
+
+  memset(&st, 0, sizeof(st));
+
+}
+
+LogReplay::~LogReplay(void)
+{
+
+  stop();
+
+}
+
+int LogReplay::open(const std::vector<std::string>& files_)
+{
+
+  for(size_t i=0; i<files_.size(); i++)
+    if(access(files_[i].c_str(), R_OK) != 0)
+      return -1;
+
+  files = files_;
+  format = files.empty() ? BINLOG_FORMAT_UNKNOWN : binlog_format_from_filename(files[0].c_str());
+  clock_base = files.empty() ? 0.0 : replay_clock_base(files[0], format);
+
+  return 0;
+
+}
+
+int LogReplay::open(const char* dir, const char* suffix)
+{
+
+  std::vector<std::string> list;
+
+  if(ingest_list_dir(dir, suffix, list) < 0)
+    return -1;
+
+  return open(list);
+
+}
+
+int LogReplay::start(void)
+{
+
+  if(files.empty() || read_thread.joinable() || pace_thread.joinable())
+    return -1;
+
+  if(drive_clock)
+    rov_time_mode_set(ROV_TIME_MODE_RENAV);
+
+  stopping = false;
+  read_done = false;
+  finished = false;
+
+  read_thread = std::thread(&LogReplay::reader, this);
+  pace_thread = std::thread(&LogReplay::pacer, this);
+
+  return 0;
+
+}
+
+void LogReplay::stop(void)
+{
+
+  stopping = true;
+  wait();
+
+}
+
+void LogReplay::wait(void)
+{
+
+  if(read_thread.joinable())
+    read_thread.join();
+  if(pace_thread.joinable())
+    pace_thread.join();
+
+}
+
+// reader: push samples into the read-ahead ring, waiting for room
+bool LogReplay::put_ahead(const ImuSample* s, size_t n)
+{
+
+  while(n > 0 && !stopping.load(std::memory_order_relaxed))
+    {
+      const size_t m = ahead.push(s, n);
+      s += m;
+      n -= m;
+      if(n > 0)
+	replay_sleep(0.0002);
+    }
+
+  return n == 0;
+
+}
+
+void LogReplay::reader(void)
+{
+
+  BinlogParser parser(format == BINLOG_FORMAT_UNKNOWN ? BINLOG_FORMAT_KVH : format, hz);
+  ImuBatch batch;
+  ImuSampleVector samples;
+  double t_prev = 0.0;
+  bool first = true;
+  uint64_t count = 0;
+
+  samples.reserve(REPLAY_BURST);
+
+  // ImuPackets to samples with dt from the previous one
+  auto emit = [&](const ImuPacket& pkt) -> bool {
+    ImuSample s = imu_sample_from_packet(pkt);
+    if(format == BINLOG_FORMAT_KVH)
+      {
+	// numbered across files, as ingest_files() does
+	const double step = (hz > 0.0) ? 1.0/hz : 0.0;
+	s.timestamp = count*step;
+	s.diff = step;
+      }
+    else
+      s.diff = first ? 0.0 : s.timestamp - t_prev;
+    s.hz = hz;
+    t_prev = s.timestamp;
+    first = false;
+    count++;
+
+    samples.push_back(s);
+    if(samples.size() < REPLAY_BURST)
+      return true;
+
+    const bool ok = put_ahead(&samples[0], samples.size());
+    samples.clear();
+    return ok;
+  };
+
+  for(size_t f=0; f<files.size() && !stopping; f++)
+    {
+      MappedFile map;
+      if(map.open(files[f].c_str()) != 0)
+	continue;
+
+      if(format == BINLOG_FORMAT_UNKNOWN)
+	{
+	  const char* p = (const char*) map.data();
+	  const char* end = p + map.size();
+	  ImuPacket pkt;
+
+	  while(p < end)
+	    {
+	      const char* nl = (const char*) memchr(p, '\n', end - p);
+	      const char* le = (nl == NULL) ? end : nl;
+	      const char* line = p;
+	      p = (nl == NULL) ? end : nl + 1;
+
+	      if(le == line)
+		continue;
+	      if(imu_log_parse_record(line, le, pkt) != 0)
+		bad_records++;
+	      else if(!emit(pkt))
+		break;
+	    }
+	}
+      else
+	{
+	  const uint8_t* data = map.data();
+	  const size_t size = map.size();
+	  const uint64_t bad_before = parser.stats().bad_checksum;
+	  size_t off = 0;
+
+	  while(off < size && !stopping)
+	    {
+	      size_t n = std::min((size_t) REPLAY_PIECE, size - off);
+	      size_t used = parser.parse(data + off, n, batch, off + n == size);
+	      if(used == 0)
+		used = parser.parse(data + off, n = size - off, batch, true);
+	      off += used;
+
+	      for(size_t i=0; i<batch.size(); i++)
+		if(!emit(batch.packet(i)))
+		  break;
+	      batch.clear();
+	    }
+
+	  bad_records += parser.stats().bad_checksum - bad_before;
+	}
+
+      files_read++;
+    }
+
+  if(!samples.empty())
+    put_ahead(&samples[0], samples.size());
+
+  read_done.store(true, std::memory_order_release);
+
+}
+
+void LogReplay::pacer(void)
+{
+
+  ImuSample buf[REPLAY_BURST];
+  size_t n = 0;
+  size_t i = 0;
+  double t_first = 0.0;
+  double wall_first = 0.0;
+  bool have_first = false;
+  const double wall_start = replay_now();
+
+  while(!stopping.load(std::memory_order_relaxed))
+    {
+      // refill from the read-ahead
+      if(i == n)
+	{
+	  i = 0;
+	  n = ahead.pop(buf, REPLAY_BURST);
+	  if(n == 0)
+	    {
+	      if(read_done.load(std::memory_order_acquire))
+		{
+		  // the reader may have pushed its last samples before finishing
+		  n = ahead.pop(buf, REPLAY_BURST);
+		  if(n == 0)
+		    break;
+		}
+	      else
+		{
+		  if(have_first)
+		    st.starved++;
+		  n = ahead.wait_pop(buf, REPLAY_BURST, REPLAY_POLL);
+		  continue;
+		}
+	    }
+	}
+
+      if(!have_first)
+	{
+	  t_first = buf[i].timestamp;
+	  wall_first = replay_now();
+	  have_first = true;
+	}
+
+      // samples due now
+      size_t j = n;
+      if(speed > 0.0)
+	{
+	  const double now = replay_now();
+	  j = i;
+	  while(j < n && wall_first + (buf[j].timestamp - t_first)/speed <= now)
+	    j++;
+
+	  if(j == i)
+	    {
+	      replay_sleep_until(std::min(wall_first + (buf[i].timestamp - t_first)/speed, now + REPLAY_POLL));
+	      continue;
+	    }
+
+	  st.max_lag = std::max(st.max_lag, now - (wall_first + (buf[i].timestamp - t_first)/speed));
+	}
+
+      for(size_t k=i; k<j; k++)
+	buf[k].comp_timestamp = clock_base + (buf[k].timestamp - t_first);
+
+      if(drive_clock)
+	rov_time_set(buf[j-1].comp_timestamp);
+
+      // publish
+      const size_t m = j - i;
+      size_t pushed = 0;
+      if(lossy)
+	{
+	  pushed = out.push(buf + i, m);
+	  st.dropped += m - pushed;
+	}
+      else
+	while(pushed < m && !stopping.load(std::memory_order_relaxed))
+	  {
+	    // only push what fits, so the ring does not count overruns
+	    const size_t room = out.capacity() - out.size();
+	    if(room == 0)
+	      {
+		std::this_thread::yield();
+		continue;
+	      }
+	    pushed += out.push(buf + i + pushed, std::min(room, m - pushed));
+	  }
+
+      st.samples += pushed;
+      i = j;
+    }
+
+  st.files = files_read.load();
+  st.bad_records = bad_records.load();
+  st.elapsed = replay_now() - wall_start;
+
+  finished.store(true, std::memory_order_release);
+
+}
@@ -0,0 +1,884 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Checks and timings for the IMU sample containers.
+ *
+ * Checks the ImuSample conversions to and from GyroData and ImuPacket
+ * and the alignment of heap samples and rings, and times construct+copy
+ * and queue throughput for GyroData against ImuSample.  Then checks ImuBatch against the packets it was built from
+ * and times window statistics on SoA against AoS storage.  Finally
+ * hands samples between two threads through SpscRing and through a
+ * mutex-protected deque.  Last, checks the Decimator's response, its
+ * block independence and its taps against a direct convolution, and
+ * times it, then checks the Allan deviations against the direct sums,
+ * white noise theory and the streaming form, and times them on an hour
+ * of 1 kHz data (or as many hours as the first argument says).  The
+ * clock aligner is checked on a drifting clock with late arrivals, and
+ * the resamplers for accuracy, block independence and the shared grid,
+ * and timed on three 1 kHz streams.  The work-stealing pool is run
+ * through many short parallel_for calls back to back, where a worker
+ * that wakes late must not take a finished call's task.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <deque>
+#include <random>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <helper_funcs/gyro_data.h>
+#include <helper_funcs/imu_sample.h>
+#include <helper_funcs/imu_batch.h>
+#include <helper_funcs/spsc_ring.h>
+#include <helper_funcs/decimate.h>
+#include <helper_funcs/allan.h>
+#include <helper_funcs/timebase.h>
+#include <helper_funcs/thread_pool.h>
+
+#define NUM_SAMPLES 2000000
+#define QUEUE_DEPTH 1024
+#define BATCH_SAMPLES 4000000
+#define RING_SAMPLES 4000000
+#define DECIMATE_SAMPLES 2000000
+
+static double now_sec(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// producer/consumer hand-off through the ring, returns samples out of order
+static int ring_handoff(int wake_mode, double* seconds, size_t* high_water)
+{
+  ImuSampleRing ring(4096, wake_mode);
+  int bad = 0;
+  double t0 = now_sec();
+
+  std::thread producer([&ring]() {
+      ImuSample block[16];
+      for(int i=0; i<RING_SAMPLES; i+=16)
+	{
+	  for(int j=0; j<16; j++)
+	    {
+	      block[j] = imu_sample_init(1000);
+	      block[j].seq_num = i + j;
+	    }
+	  size_t done = 0;
+	  while(done < 16)
+	    {
+	      done += ring.push(block + done, 16 - done);
+	      if(done < 16)
+		std::this_thread::yield();
+	    }
+	}
+    });
+
+  ImuSample out[64];
+  uint32_t expect = 0;
+  while(expect < RING_SAMPLES)
+    {
+      size_t m = ring.wait_pop(out, 64, 1.0);
+      for(size_t j=0; j<m; j++)
+	if(out[j].seq_num != expect++)
+	  bad++;
+      if(m == 0)
+	{
+	  bad++;
+	  break;
+	}
+    }
+
+  producer.join();
+
+  *seconds = now_sec() - t0;
+  *high_water = ring.high_water_mark();
+
+  return bad;
+}
+
+static int check_conversions(void)
+{
+  int errors = 0;
+
+  GyroData g(1000);
+  g.ang = Eigen::Vector3d(1e-3,-2e-3,3e-3);
+  g.acc = Eigen::Vector3d(0.1,-0.2,9.81);
+  g.mag = Eigen::Vector3d(0.2,0.01,0.45);
+  g.status[1] = true;
+  g.status[4] = true;
+  g.temp = 31.5f;
+  g.seq_num = 12345;
+  g.timestamp = 1539950000.123456789;
+  g.comp_timestamp = 1539950000.125;
+  g.t_start = 1539940000.0;
+  g.fluid_pressure = 101.325f;
+
+  GyroData h(1);
+  imu_sample_to_gyro(imu_sample_from_gyro(g), h);
+
+  if(h.ang != g.ang || h.acc != g.acc || h.mag != g.mag || h.status != g.status ||
+     h.temp != g.temp || h.seq_num != g.seq_num || h.timestamp != g.timestamp ||
+     h.comp_timestamp != g.comp_timestamp || h.diff != g.diff || h.t_start != g.t_start ||
+     h.hz != g.hz || h.fluid_pressure != g.fluid_pressure)
+    {
+      printf("FAIL: GyroData round trip\n");
+      errors++;
+    }
+
+  ImuPacket p;
+  p.ang = g.ang;
+  p.acc = g.acc;
+  p.mag = g.mag;
+  p.seq_num = -7;
+  p.t = g.timestamp;
+  p.dt = 0.001;
+  p.fluid_pressure = g.fluid_pressure;
+
+  ImuPacket q = imu_sample_to_packet(imu_sample_from_packet(p));
+  if(q.ang != p.ang || q.acc != p.acc || q.mag != p.mag || q.seq_num != p.seq_num ||
+     q.t != p.t || q.dt != p.dt || q.fluid_pressure != p.fluid_pressure)
+    {
+      printf("FAIL: ImuPacket round trip\n");
+      errors++;
+    }
+
+  ImuSample s = imu_sample_init(1000);
+  if(s.seq_num != 500 || s.num_status != 6 || s.diff != 0.001)
+    {
+      printf("FAIL: imu_sample_init\n");
+      errors++;
+    }
+
+  // heap samples and rings keep the 64-byte alignment
+  int misaligned = 0;
+  for(size_t n=1; n<40; n+=3)
+    {
+      ImuSampleVector v(n);
+      ImuSampleRing* r = new ImuSampleRing(n);
+      misaligned += ((uintptr_t) v.data() % 64 != 0) + ((uintptr_t) r % 64 != 0);
+      delete r;
+    }
+  if(misaligned)
+    {
+      printf("FAIL: %d misaligned sample vectors or rings\n", misaligned);
+      errors++;
+    }
+
+  return errors;
+}
+
+// n samples at hz, axis a a sine of frequency f[a] (units: Hz) plus an offset
+static void fill_sines(ImuBatch& batch, size_t n, double hz, const double* f)
+{
+  batch.resize(n);
+  for(int a=0; a<9; a++)
+    {
+      double* x = batch.axis((ImuVec) (a/3), a%3);
+      for(size_t i=0; i<n; i++)
+	x[i] = 0.1*a + sin(2.0*M_PI*f[a]*i/hz);
+    }
+  for(size_t i=0; i<n; i++)
+    {
+      batch.t()[i] = 100.0 + i/hz;
+      batch.dt()[i] = 1.0/hz;
+      batch.seq_num()[i] = (int32_t) i;
+      batch.fluid_pressure()[i] = (float) i;
+    }
+}
+
+// sine amplitude from the RMS about the offset, once the filter has settled
+static double settled_amplitude(const ImuBatch& out, int a, int skip)
+{
+  const double* y = out.axis((ImuVec) (a/3), a%3);
+  double sum = 0.0;
+  for(size_t j=skip; j<out.size(); j++)
+    sum += (y[j] - 0.1*a)*(y[j] - 0.1*a);
+  return sqrt(2.0*sum/(out.size() - skip));
+}
+
+static int check_decimate(void)
+{
+  int errors = 0;
+  const double hz = 1000.0;
+  const double rate = 100.0;
+
+  // passband on ang, alias frequencies on acc, DC on mag
+  const double f[9] = {5.0, 12.0, 20.0, 70.0, 130.0, 260.0, 0.0, 0.0, 0.0};
+  ImuBatch in, whole, pieces;
+  fill_sines(in, 20000, hz, f);
+
+  Decimator dec(hz, rate);
+  dec.process(in.view(), whole);
+
+  const int skip = 2*DECIMATE_TAPS_PER_PHASE;
+  for(int a=0; a<9; a++)
+    {
+      const double amp = settled_amplitude(whole, a, skip);
+      const bool ok = (f[a] == 0.0) ? amp < 1e-12 : (f[a] < 0.3*rate) ? fabs(amp - 1.0) < 0.01 : amp < 2e-3;
+      if(!ok)
+	{
+	  printf("FAIL: Decimator, %g Hz comes out at amplitude %g\n", f[a], amp);
+	  errors++;
+	}
+    }
+
+  if(whole.size() != in.size()/10 || dec.factor() != 10 || dec.output_rate() != rate)
+    {
+      printf("FAIL: Decimator, %d samples out of %d\n", (int) whole.size(), (int) in.size());
+      errors++;
+    }
+
+  // random block sizes give the same output, bit for bit
+  Decimator dec2(hz, rate);
+  srand(42);
+  for(size_t off=0; off<in.size(); )
+    {
+      const size_t n = std::min(in.size() - off, (size_t) (rand() % 3000));
+      dec2.process(in.view(off, n), pieces);
+      off += n;
+    }
+
+  bool same = (pieces.size() == whole.size());
+  for(size_t j=0; same && j<whole.size(); j++)
+    {
+      for(int a=0; a<9; a++)
+	same = same && pieces.axis((ImuVec) (a/3), a%3)[j] == whole.axis((ImuVec) (a/3), a%3)[j];
+      same = same && pieces.t()[j] == whole.t()[j] && pieces.seq_num()[j] == whole.seq_num()[j];
+    }
+  if(!same)
+    {
+      printf("FAIL: Decimator, output depends on the block sizes\n");
+      errors++;
+    }
+
+  // against the direct convolution, the first input repeated before the start
+  const std::vector<double>& h = dec.coefficients();
+  const double* x = in.axis(IMU_ACC, 0);
+  for(size_t j=0; j<whole.size(); j+=97)
+    {
+      const long i = 10*j + 9;
+      double y = 0.0;
+      for(size_t k=0; k<h.size(); k++)
+	y += h[k]*x[std::max(0L, i - (long) k)];
+      if(fabs(y - whole.axis(IMU_ACC, 0)[j]) > 1e-12 || whole.seq_num()[j] != i ||
+	 fabs(whole.t()[j] - (in.t()[i] - dec.group_delay())) > 1e-9)
+	{
+	  printf("FAIL: Decimator, output %d differs from the direct convolution\n", (int) j);
+	  errors++;
+	  break;
+	}
+    }
+
+  // rates from config_params, and pass-through
+  config_params params;
+  params.hz = 1000;
+  params.rate = 30;
+  Decimator dec3(params);
+  Decimator dec4(hz, hz);
+  ImuBatch through;
+  dec4.process(in.view(0, 100), through);
+  if(dec3.factor() != 33 || dec3.taps() != 33*DECIMATE_TAPS_PER_PHASE ||
+     through.size() != 100 || through.axis(IMU_MAG, 2)[99] != in.axis(IMU_MAG, 2)[99])
+    {
+      printf("FAIL: Decimator rates\n");
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_decimate(int rate)
+{
+  const double f[9] = {1.0, 2.0, 3.0, 40.0, 50.0, 60.0, 0.5, 0.7, 0.9};
+  ImuBatch in, out;
+  fill_sines(in, DECIMATE_SAMPLES, 1000.0, f);
+  out.reserve(DECIMATE_SAMPLES);
+
+  Decimator dec(1000.0, rate);
+  const double t0 = now_sec();
+  for(size_t off=0; off<in.size(); off+=4096)
+    dec.process(in.view(off, std::min((size_t) 4096, in.size() - off)), out);
+  const double t = now_sec() - t0;
+
+  printf("decimate 1000 Hz to %3d Hz, %3d taps: %5.2f ns/sample/axis\n", rate, dec.taps(), 1e9*t/(9.0*DECIMATE_SAMPLES));
+}
+
+// adev and mdev summed straight from the definitions, O(n m)
+static void allan_direct(const std::vector<double>& x, double hz, uint64_t m, double* adev, double* mdev)
+{
+  const size_t P = x.size() + 1;
+  std::vector<long double> theta(P, 0.0);
+  for(size_t i=0; i<x.size(); i++)
+    theta[i + 1] = theta[i] + x[i]/hz;
+
+  const double tau = m/hz;
+  long double a = 0.0, b = 0.0;
+  for(size_t k=0; k+2*m<P; k++)
+    {
+      const long double d = theta[k + 2*m] - 2*theta[k + m] + theta[k];
+      a += d*d;
+    }
+  for(size_t j=0; j+3*m<=P; j++)
+    {
+      long double s = 0.0;
+      for(size_t i=j; i<j+m; i++)
+	s += theta[i + 2*m] - 2*theta[i + m] + theta[i];
+      b += s*s;
+    }
+  *adev = sqrt((double) (a/(2.0*tau*tau*(P - 2*m))));
+  *mdev = sqrt((double) (b/(2.0*m*m*tau*tau*(P - 3*m + 1))));
+}
+
+static bool allan_close(const std::vector<AllanPoint>& a, const std::vector<AllanPoint>& b, double tol)
+{
+  if(a.size() != b.size())
+    return false;
+  for(size_t t=0; t<a.size(); t++)
+    if(a[t].m != b[t].m || fabs(a[t].adev - b[t].adev) > tol*b[t].adev ||
+       fabs(a[t].mdev - b[t].mdev) > tol*b[t].mdev)
+      return false;
+  return true;
+}
+
+static int check_allan(void)
+{
+  int errors = 0;
+  std::mt19937 gen(43);
+  std::normal_distribution<double> noise(0.0, 0.01);
+
+  // against the direct sums, on one thread and split into ranges
+  std::vector<double> x(3000);
+  for(size_t i=0; i<x.size(); i++)
+    x[i] = 0.3 + noise(gen) + 1e-4*i*noise(gen);
+
+  std::vector<uint64_t> m;
+  allan_tau_m(x.size(), m, 10.0);
+  std::vector<AllanPoint> one, split, direct(m.size());
+  allan_deviation(&x[0], x.size(), 100.0, m, one, ALLAN_ADEV | ALLAN_MDEV, 1);
+  allan_deviation(&x[0], x.size(), 100.0, m, split, ALLAN_ADEV | ALLAN_MDEV, 3);
+  for(size_t t=0; t<m.size(); t++)
+    {
+      direct[t].m = m[t];
+      allan_direct(x, 100.0, m[t], &direct[t].adev, &direct[t].mdev);
+    }
+
+  if(m.back() != 1000 || !allan_close(one, direct, 1e-9) || !allan_close(split, direct, 1e-9) ||
+     fabs(one[0].mdev - one[0].adev) > 1e-12*one[0].adev)
+    {
+      printf("FAIL: allan_deviation differs from the direct sums\n");
+      errors++;
+    }
+
+  // white rate noise: adev = sigma/sqrt(m), mdev/adev -> 1/sqrt(2)
+  x.resize(400000);
+  for(size_t i=0; i<x.size(); i++)
+    x[i] = noise(gen);
+  allan_tau_m(x.size(), m);
+  allan_deviation(&x[0], x.size(), 1000.0, m, one);
+  for(size_t t=0; t<one.size() && one[t].m<=100; t++)
+    if(fabs(one[t].adev*sqrt((double) one[t].m)/0.01 - 1.0) > 0.05 ||
+       (one[t].m >= 25 && fabs(one[t].mdev/one[t].adev - sqrt(0.5)) > 0.05))
+      {
+	printf("FAIL: allan_deviation of white noise, m %d adev %g mdev %g\n",
+	       (int) one[t].m, one[t].adev, one[t].mdev);
+	errors++;
+	break;
+      }
+
+  // streaming, in random pieces, against the batch
+  AllanStream stream(1000.0, m);
+  srand(43);
+  for(size_t off=0; off<x.size(); )
+    {
+      const size_t n = std::min(x.size() - off, (size_t) (rand() % 5000));
+      stream.add(&x[off], n);
+      off += n;
+    }
+  stream.result(split);
+  if(!allan_close(split, one, 1e-9) || stream.size() != x.size())
+    {
+      printf("FAIL: AllanStream differs from allan_deviation\n");
+      errors++;
+    }
+
+  // three axes in one pass
+  ImuBatch batch;
+  batch.resize(x.size()/4);
+  for(int k=0; k<3; k++)
+    for(size_t i=0; i<batch.size(); i++)
+      batch.axis(IMU_ACC, k)[i] = x[3*i + k];
+  std::vector<AllanPoint> axes[3];
+  allan_tau_m(batch.size(), m);
+  allan_deviation(batch.view(), IMU_ACC, 1000.0, m, axes);
+  for(int k=0; k<3; k++)
+    {
+      allan_deviation(batch.axis(IMU_ACC, k), batch.size(), 1000.0, m, one);
+      if(!allan_close(axes[k], one, 1e-12))
+	{
+	  printf("FAIL: allan_deviation of an ImuBatch axis\n");
+	  errors++;
+	  break;
+	}
+    }
+
+  return errors;
+}
+
+static void bench_allan(double hours)
+{
+  const size_t n = (size_t) (hours*3600.0*1000.0);
+  std::mt19937 gen(44);
+  std::normal_distribution<double> noise(0.0, 1e-4);
+  std::vector<double> x(n);
+  double walk = 0.0;
+  for(size_t i=0; i<n; i++)
+    {
+      walk += 1e-7*noise(gen);
+      x[i] = 1e-3 + walk + noise(gen);
+    }
+
+  std::vector<uint64_t> m;
+  std::vector<AllanPoint> out;
+  allan_tau_m(n, m);
+
+  double t0 = now_sec();
+  allan_deviation(&x[0], n, 1000.0, m, out, ALLAN_ADEV);
+  const double t_adev = now_sec() - t0;
+
+  t0 = now_sec();
+  allan_deviation(&x[0], n, 1000.0, m, out);
+  const double t_both = now_sec() - t0;
+
+  printf("allan %g h of 1 kHz, %d taus: adev %.2f s, adev+mdev %.2f s, %.2f ns/sample/tau\n",
+	 hours, (int) m.size(), t_adev, t_both, 1e9*t_both/(n*m.size()));
+}
+
+static int check_thread_pool(void)
+{
+  int errors = 0;
+  WorkStealingPool pool(8);
+  std::atomic<long> sum(0);
+
+  // short calls, so workers are often still waking from the last one
+  const int rounds = 20000;
+  long want = 0;
+  for(int r=0; r<rounds; r++)
+    {
+      const int n = 1 + r % 13;
+      pool.parallel_for(n, [&sum, r](int i) { sum += r + i; });
+      want += (long) n*r + (long) n*(n - 1)/2;
+    }
+  if(sum.load() != want)
+    {
+      printf("FAIL: thread pool back to back: sum %ld, want %ld\n", sum.load(), want);
+      errors++;
+    }
+
+  return errors;
+}
+
+static int check_clock_align(void)
+{
+  int errors = 0;
+  std::mt19937 gen(45);
+  std::exponential_distribution<double> delay(1.0/50e-6);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  // host = 1.7e9 + 0.05 + (1 + 30 ppm)(sensor - 2000) + 200 us + delay,
+  // with 2% of the samples 5-20 ms late
+  ClockAligner plain(1e9, 1e9), robust;
+  const double drift = 30e-6;
+  for(int i=0; i<200000; i++)
+    {
+      const double sensor = 2000.0 + i/1000.0;
+      double late = 200e-6 + delay(gen);
+      if(uniform(gen) < 0.02)
+	late += 5e-3 + 15e-3*uniform(gen);
+      const double host = 1.7e9 + 0.05 + (1.0 + drift)*(sensor - 2000.0) + late;
+      plain.update(sensor, host);
+      robust.update(sensor, host);
+    }
+
+  // the true mapping plus the median delay
+  const double sensor = 2000.0 + 199.999;
+  const double truth = 1.7e9 + 0.05 + (1.0 + drift)*(sensor - 2000.0) + 200e-6 + 50e-6*log(2.0);
+  const double err_robust = robust.to_host(sensor) - truth;
+  const double err_plain = plain.to_host(sensor) - truth;
+
+  if(fabs(err_robust) > 50e-6 || fabs(robust.drift_ppm() - 1e6*drift) > 1.0 ||
+     fabs(robust.to_sensor(robust.to_host(sensor)) - sensor) > 1e-6 || robust.outliers() < 4000)
+    {
+      printf("FAIL: ClockAligner: offset error %.1f us, drift %.3f ppm, %d outliers\n",
+	     1e6*err_robust, robust.drift_ppm(), (int) robust.outliers());
+      errors++;
+    }
+
+  printf("clock align, 2%% late by 5-20 ms: robust error %.1f us, drift %.3f ppm; plain error %.1f us\n",
+	 1e6*err_robust, robust.drift_ppm(), 1e6*err_plain);
+
+  return errors;
+}
+
+static int check_resample(void)
+{
+  int errors = 0;
+  const double hz = 1000.0;
+  const double f[9] = {5.0, 2.0, 1.0, 3.0, 4.0, 0.5, 0.2, 0.3, 0.1};
+
+  // 1 kHz samples starting between grid times, with jittered times
+  ImuBatch in;
+  fill_sines(in, 20000, hz, f);
+  for(size_t i=0; i<in.size(); i++)
+    in.t()[i] = 100.00037 + i/hz + 2e-5*sin(0.37*i);
+  for(int a=0; a<9; a++)
+    for(size_t i=0; i<in.size(); i++)
+      in.axis((ImuVec) (a/3), a%3)[i] = 0.1*a + sin(2.0*M_PI*f[a]*in.t()[i]);
+
+  ImuResampler lin(333.0, RESAMPLE_LINEAR), cub(333.0, RESAMPLE_CUBIC);
+  ImuBatch out_lin, out_cub;
+  lin.process(in.view(), out_lin);
+  lin.flush(out_lin);
+  cub.process(in.view(), out_cub);
+  cub.flush(out_cub);
+
+  double err_lin = 0.0, err_cub = 0.0;
+  bool on_grid = true;
+  for(size_t j=0; j<out_cub.size(); j++)
+    {
+      const double t = out_cub.t()[j];
+      const double k = t*333.0;
+      on_grid = on_grid && fabs(k - floor(k + 0.5)) < 1e-6 && t >= in.t()[0] && t <= in.t()[in.size() - 1];
+      err_cub = std::max(err_cub, fabs(out_cub.axis(IMU_ANG, 0)[j] - sin(2.0*M_PI*f[0]*t)));
+    }
+  for(size_t j=0; j<out_lin.size(); j++)
+    err_lin = std::max(err_lin, fabs(out_lin.axis(IMU_ANG, 0)[j] - sin(2.0*M_PI*f[0]*out_lin.t()[j])));
+
+  if(!on_grid || out_cub.size() != out_lin.size() || out_cub.size() < 6650 || err_cub > 2e-5 || err_lin > 2e-4)
+    {
+      printf("FAIL: ImuResampler: %d samples, linear error %g, cubic error %g\n",
+	     (int) out_cub.size(), err_lin, err_cub);
+      errors++;
+    }
+
+  // random blocks give the same output, bit for bit
+  ImuResampler cub2(333.0, RESAMPLE_CUBIC);
+  ImuBatch pieces;
+  srand(45);
+  for(size_t off=0; off<in.size(); )
+    {
+      const size_t n = std::min(in.size() - off, (size_t) (rand() % 50));
+      cub2.process(in.view(off, n), pieces);
+      off += n;
+    }
+  cub2.flush(pieces);
+  bool same = (pieces.size() == out_cub.size());
+  for(size_t j=0; same && j<pieces.size(); j++)
+    for(int a=0; a<9; a++)
+      same = same && pieces.axis((ImuVec) (a/3), a%3)[j] == out_cub.axis((ImuVec) (a/3), a%3)[j] &&
+	pieces.t()[j] == out_cub.t()[j];
+  if(!same)
+    {
+      printf("FAIL: ImuResampler output depends on the block sizes\n");
+      errors++;
+    }
+
+  // nothing across a gap
+  for(size_t i=10000; i<in.size(); i++)
+    in.t()[i] += 0.1;
+  ImuResampler gap(333.0, RESAMPLE_CUBIC, 0.01);
+  ImuBatch out_gap;
+  gap.process(in.view(), out_gap);
+  for(size_t j=0; j<out_gap.size(); j++)
+    if(out_gap.t()[j] > in.t()[9999] && out_gap.t()[j] < in.t()[10000])
+      {
+	printf("FAIL: ImuResampler interpolated across a gap\n");
+	errors++;
+	break;
+      }
+
+  // constant-rate rotation: SLERP is exact
+  const double w = 0.7;
+  std::vector<double> tq(5000);
+  QuaternionVector q(tq.size()), q_out;
+  std::vector<double> t_out;
+  for(size_t i=0; i<tq.size(); i++)
+    {
+      tq[i] = 50.0002 + i/hz;
+      q[i] = Eigen::Quaterniond(Eigen::AngleAxisd(w*tq[i], Eigen::Vector3d(0.6, 0.0, 0.8)));
+    }
+  AttitudeResampler att(200.0);
+  for(size_t off=0; off<tq.size(); off+=777)
+    att.process(&tq[off], &q[off], std::min((size_t) 777, tq.size() - off), t_out, q_out);
+
+  double err_q = 0.0;
+  for(size_t j=0; j<t_out.size(); j++)
+    {
+      const Eigen::Quaterniond truth(Eigen::AngleAxisd(w*t_out[j], Eigen::Vector3d(0.6, 0.0, 0.8)));
+      err_q = std::max(err_q, truth.angularDistance(q_out[j]));
+    }
+  if(t_out.size() != 999 || err_q > 1e-9)
+    {
+      printf("FAIL: AttitudeResampler: %d samples, error %g rad\n", (int) t_out.size(), err_q);
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_resample(void)
+{
+  const double f[9] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 0.5, 0.7, 0.9};
+  const size_t n = 1000000;
+  ImuBatch in[3], out;
+  ClockAligner clock[3];
+  ImuResampler re[3] = {ImuResampler(1000.0), ImuResampler(1000.0), ImuResampler(1000.0)};
+  for(int s=0; s<3; s++)
+    {
+      fill_sines(in[s], n, 1000.0 + 0.1*s, f);
+      for(size_t i=0; i<n; i++)
+	in[s].t()[i] += 1e-4*s;
+    }
+  out.reserve(4096);
+  std::vector<double> host(4096);
+
+  // three 1 kHz streams: fit the clock, map to host time, resample
+  const double t0 = now_sec();
+  size_t total = 0;
+  for(size_t off=0; off<n; off+=1000)
+    for(int s=0; s<3; s++)
+      {
+	const size_t m = std::min((size_t) 1000, n - off);
+	for(size_t i=0; i<m; i++)
+	  host[i] = in[s].t()[off + i] + 0.01*s;
+	clock[s].update(in[s].t() + off, &host[0], m);
+	clock[s].to_host(in[s].t() + off, in[s].t() + off, m);
+	out.clear();
+	total += re[s].process(in[s].view(off, m), out);
+      }
+  const double t = now_sec() - t0;
+
+  printf("align + cubic resample, 3 streams: %5.1f ns/sample, %.0fx real time at 3 x 1 kHz, %d out\n",
+	 1e9*t/(3.0*n), n/1000.0/t, (int) total);
+}
+
+int main( int argc, const char* argv[])
+{
+  int i;
+  int errors = 0;
+  double t0, t_gyro, t_sample;
+  volatile double sink = 0.0;
+
+  fprintf(stderr, "\nFILE %s compiled on %s %s\n",__FILE__,__TIME__,__DATE__);
+
+  errors += check_conversions();
+
+  // construct + copy
+  {
+    std::vector<GyroData> gyro_out(QUEUE_DEPTH, GyroData(1000));
+    ImuSampleVector sample_out(QUEUE_DEPTH);
+
+    t0 = now_sec();
+    for(i=0; i<NUM_SAMPLES; i++)
+      {
+	GyroData g(1000);
+	g.seq_num = i;
+	gyro_out[i % QUEUE_DEPTH] = g;
+      }
+    t_gyro = now_sec() - t0;
+
+    t0 = now_sec();
+    for(i=0; i<NUM_SAMPLES; i++)
+      {
+	ImuSample s = imu_sample_init(1000);
+	s.seq_num = i;
+	sample_out[i % QUEUE_DEPTH] = s;
+      }
+    t_sample = now_sec() - t0;
+
+    sink += gyro_out[7].seq_num + sample_out[7].seq_num;
+
+    printf("construct+copy, GyroData:  %8.1f ns/sample\n", 1e9*t_gyro/NUM_SAMPLES);
+    printf("construct+copy, ImuSample: %8.1f ns/sample\n", 1e9*t_sample/NUM_SAMPLES);
+  }
+
+  // through a queue, producer and consumer interleaved in blocks
+  {
+    std::deque<GyroData> gyro_queue;
+    ImuSampleVector ring(QUEUE_DEPTH);
+    unsigned head = 0, tail = 0;
+
+    t0 = now_sec();
+    for(i=0; i<NUM_SAMPLES; i+=QUEUE_DEPTH/2)
+      {
+	for(int j=0; j<QUEUE_DEPTH/2; j++)
+	  {
+	    GyroData g(1000);
+	    g.seq_num = i + j;
+	    gyro_queue.push_back(g);
+	  }
+	while(!gyro_queue.empty())
+	  {
+	    sink += gyro_queue.front().seq_num;
+	    gyro_queue.pop_front();
+	  }
+      }
+    t_gyro = now_sec() - t0;
+
+    t0 = now_sec();
+    for(i=0; i<NUM_SAMPLES; i+=QUEUE_DEPTH/2)
+      {
+	for(int j=0; j<QUEUE_DEPTH/2; j++)
+	  {
+	    ImuSample& s = ring[head++ % QUEUE_DEPTH];
+	    s = imu_sample_init(1000);
+	    s.seq_num = i + j;
+	  }
+	while(tail != head)
+	  sink += ring[tail++ % QUEUE_DEPTH].seq_num;
+      }
+    t_sample = now_sec() - t0;
+
+    printf("queue, std::deque<GyroData>: %6.2f Msamples/s\n", 1e-6*NUM_SAMPLES/t_gyro);
+    printf("queue, ImuSample ring:       %6.2f Msamples/s\n", 1e-6*NUM_SAMPLES/t_sample);
+  }
+
+  // structure of arrays
+  {
+    std::vector<ImuPacket> pkts(BATCH_SAMPLES);
+    for(i=0; i<BATCH_SAMPLES; i++)
+      {
+	pkts[i].ang = Eigen::Vector3d(1e-3*sin(0.001*i), 2e-3, -1e-3*cos(0.002*i));
+	pkts[i].acc = Eigen::Vector3d(0.01*sin(0.01*i), -0.02, 9.81);
+	pkts[i].mag = Eigen::Vector3d(0.2, 0.01*cos(0.003*i), 0.45);
+	pkts[i].t   = 1e-3*i;
+	pkts[i].dt  = 1e-3;
+	pkts[i].seq_num = i;
+	pkts[i].fluid_pressure = 101.0f;
+      }
+
+    ImuBatch batch;
+    for(i=0; i<BATCH_SAMPLES/2; i++)
+      batch.push_back(pkts[i]);
+    batch.append(&pkts[BATCH_SAMPLES/2], BATCH_SAMPLES - BATCH_SAMPLES/2);
+
+    ImuPacket back[3];
+    batch.to_packets(BATCH_SAMPLES/2 - 1, 3, back);
+    for(int j=0; j<3; j++)
+      {
+	const ImuPacket& a = pkts[BATCH_SAMPLES/2 - 1 + j];
+	if(back[j].ang != a.ang || back[j].acc != a.acc || back[j].mag != a.mag ||
+	   back[j].t != a.t || back[j].seq_num != a.seq_num || back[j].fluid_pressure != a.fluid_pressure)
+	  {
+	    printf("FAIL: ImuBatch round trip\n");
+	    errors++;
+	    break;
+	  }
+      }
+
+    // window statistics, AoS
+    Eigen::Vector3d mean_aos = Eigen::Vector3d::Zero();
+    Eigen::Vector3d var_aos  = Eigen::Vector3d::Zero();
+    t0 = now_sec();
+    for(i=0; i<BATCH_SAMPLES; i++)
+      mean_aos += pkts[i].ang;
+    mean_aos /= BATCH_SAMPLES;
+    for(i=0; i<BATCH_SAMPLES; i++)
+      var_aos += (pkts[i].ang - mean_aos).cwiseAbs2();
+    var_aos /= (BATCH_SAMPLES - 1);
+    t_gyro = now_sec() - t0;
+
+    // window statistics, SoA
+    Eigen::Vector3d mean_soa;
+    t0 = now_sec();
+    Eigen::Vector3d var_soa = imu_batch_variance(batch.view(), IMU_ANG, &mean_soa);
+    t_sample = now_sec() - t0;
+
+    // summation order differs, so compare to rounding
+    if((mean_aos - mean_soa).norm() > 1e-12 || (var_aos - var_soa).norm() > 1e-9*var_aos.norm())
+      {
+	printf("FAIL: ImuBatch statistics\n");
+	errors++;
+      }
+
+    imu_batch_subtract_bias(batch, IMU_ANG, mean_soa, 0, batch.size());
+    if(imu_batch_mean(batch.view(), IMU_ANG).norm() > 1e-12)
+      {
+	printf("FAIL: imu_batch_subtract_bias\n");
+	errors++;
+      }
+
+    printf("ang mean+variance, AoS ImuPacket: %6.2f ns/sample\n", 1e9*t_gyro/BATCH_SAMPLES);
+    printf("ang mean+variance, SoA ImuBatch:  %6.2f ns/sample\n", 1e9*t_sample/BATCH_SAMPLES);
+  }
+
+  // thread hand-off
+  {
+    std::deque<GyroData> queue;
+    std::mutex lock;
+    size_t hwm_poll, hwm_futex;
+    double t_poll, t_futex;
+
+    t0 = now_sec();
+    std::thread producer([&queue, &lock]() {
+	for(int k=0; k<RING_SAMPLES; k++)
+	  {
+	    GyroData g(1000);
+	    g.seq_num = k;
+	    std::lock_guard<std::mutex> guard(lock);
+	    queue.push_back(g);
+	  }
+      });
+    int received = 0;
+    while(received < RING_SAMPLES)
+      {
+	std::unique_lock<std::mutex> guard(lock);
+	if(queue.empty())
+	  {
+	    guard.unlock();
+	    std::this_thread::yield();
+	    continue;
+	  }
+	sink += queue.front().seq_num;
+	queue.pop_front();
+	received++;
+      }
+    producer.join();
+    t_gyro = now_sec() - t0;
+
+    if(ring_handoff(SPSC_WAKE_POLL, &t_poll, &hwm_poll) != 0)
+      {
+	printf("FAIL: SpscRing (poll) lost or reordered samples\n");
+	errors++;
+      }
+    if(ring_handoff(SPSC_WAKE_FUTEX, &t_futex, &hwm_futex) != 0)
+      {
+	printf("FAIL: SpscRing (futex) lost or reordered samples\n");
+	errors++;
+      }
+
+    printf("thread hand-off, mutex + std::deque<GyroData>: %6.2f Msamples/s\n", 1e-6*RING_SAMPLES/t_gyro);
+    printf("thread hand-off, ImuSampleRing, busy poll:    %6.2f Msamples/s, high water %d\n", 1e-6*RING_SAMPLES/t_poll, (int) hwm_poll);
+    printf("thread hand-off, ImuSampleRing, futex:        %6.2f Msamples/s, high water %d\n", 1e-6*RING_SAMPLES/t_futex, (int) hwm_futex);
+  }
+
+  errors += check_decimate();
+  bench_decimate(100);
+  bench_decimate(10);
+  errors += check_allan();
+  bench_allan((argc > 1) ? atof(argv[1]) : 1.0);
+  errors += check_clock_align();
+  errors += check_resample();
+  bench_resample();
+  errors += check_thread_pool();
+
+  (void) sink;
+
+  printf("%s\n", errors ? "sample_test FAILED" : "sample_test OK");
+
+  return errors ? 1 : 0;
+}
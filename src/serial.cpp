@@ -0,0 +1,373 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of serial.h.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+#include <algorithm>
+#include <helper_funcs/serial.h>
+#include <helper_funcs/imu_batch.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define SERIAL_MAX_EVENTS 16
+
+// one port and its preallocated buffers
+struct SerialPort
+{
+
+  SerialPort(int fd_, int format, ImuSampleRing& out_, double hz_)
+    : fd(fd_), out(&out_), hz(hz_), parser(format, hz_),
+      rx(SERIAL_RX_BYTES + BINLOG_MAX_FRAME), rx_len(0), samples(SERIAL_MAX_BATCH),
+      monitor(NULL)
+  {
+    // one read can frame a whole receive buffer of the shortest frames
+    batch.reserve((SERIAL_RX_BYTES + BINLOG_MAX_FRAME)/BINLOG_MIN_SAMPLE_FRAME);
+    memset(&st, 0, sizeof(st));
+    st.batch_capacity = batch.capacity();
+  }
+
+  int fd;
+  ImuSampleRing* out;
+  double hz;
+  BinlogParser parser;
+
+  std::vector<uint8_t> rx;
+  size_t rx_len;
+  ImuBatch batch;
+  ImuSampleVector samples;
+  StreamMonitor* monitor;
+
+  SerialPortStats st;
+
+};
+
+static speed_t serial_speed(int baud)
+{
+
+  switch(baud)
+    {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+#ifdef B460800
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    case 4000000: return B4000000;
+#endif
+    default:      return B0;
+    }
+
+}
+
+int serial_set_raw(int fd, int baud)
+{
+
+  const speed_t speed = serial_speed(baud);
+  termios tio;
+
+  if(speed == B0 || tcgetattr(fd, &tio) != 0)
+    return -1;
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cc[VMIN]  = 0;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+
+  if(tcsetattr(fd, TCSANOW, &tio) != 0)
+    return -1;
+
+  tcflush(fd, TCIFLUSH);
+
+#ifdef ASYNC_LOW_LATENCY
+  // ask the UART driver to push bytes up at once; not every tty has it
+  serial_struct ss;
+  if(ioctl(fd, TIOCGSERIAL, &ss) == 0)
+    {
+      ss.flags |= ASYNC_LOW_LATENCY;
+      ioctl(fd, TIOCSSERIAL, &ss);
+    }
+#endif
+
+  return 0;
+
+}
+
+int serial_open(const char* port, int baud)
+{
+
+  const int fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+  if(fd < 0)
+    return -1;
+
+  if(serial_set_raw(fd, baud) != 0)
+    {
+      close(fd);
+      return -1;
+    }
+
+  return fd;
+
+}
+
+SerialReader::SerialReader(void)
+  : stopping(false)
+{
+
+  epfd = epoll_create1(EPOLL_CLOEXEC);
+  wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+}
+
+SerialReader::~SerialReader(void)
+{
+
+  stop();
+
+  for(size_t i=0; i<ports.size(); i++)
+    {
+      close(ports[i]->fd);
+      delete ports[i];
+    }
+
+  close(wake_fd);
+  close(epfd);
+
+}
+
+int SerialReader::add_fd(int fd, int format, ImuSampleRing& out, double hz)
+{
+
+  if(fd < 0 || epfd < 0 || thread.joinable())
+    return -1;
+
+  SerialPort* p = new SerialPort(fd, format, out, hz);
+
+  epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = p;
+
+  if(epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+      delete p;
+      return -1;
+    }
+
+  ports.push_back(p);
+
+  return (int) ports.size() - 1;
+
+}
+
+void SerialReader::set_monitor(int port, StreamMonitor* monitor)
+{
+
+  if(port >= 0 && port < (int) ports.size())
+    ports[port]->monitor = monitor;
+
+}
+
+int SerialReader::add_port(const char* port, int baud, int format, ImuSampleRing& out, double hz)
+{
+
+  const int fd = serial_open(port, baud);
+
+  if(fd < 0)
+    return -1;
+
+  const int n = add_fd(fd, format, out, hz);
+  if(n < 0)
+    close(fd);
+
+  return n;
+
+}
+
+int SerialReader::add_port(const config_params& params, int format, ImuSampleRing& out)
+{
+
+  return add_port(params.port.c_str(), params.baud, format, out, params.hz);
+
+}
+
+void SerialReader::read_port(SerialPort* p, double t_host)
+{
+
+  for(;;)
+    {
+      const size_t room = p->rx.size() - p->rx_len;
+      const ssize_t n = read(p->fd, &p->rx[p->rx_len], room);
+
+      if(n < 0)
+	{
+	  if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+	    {
+	      // e.g. EIO when the device goes away: stop watching it
+	      p->st.errors++;
+	      epoll_ctl(epfd, EPOLL_CTL_DEL, p->fd, NULL);
+	    }
+	  return;
+	}
+      if(n == 0)
+	return;
+
+      p->st.reads++;
+      p->st.bytes += n;
+      p->rx_len += n;
+
+      // frame, keeping a partial frame for the next read
+      const size_t used = p->parser.parse(&p->rx[0], p->rx_len, p->batch, false);
+      if(used < p->rx_len)
+	memmove(&p->rx[0], &p->rx[used], p->rx_len - used);
+      p->rx_len -= used;
+
+      // a read of small frames can hold more than SERIAL_MAX_BATCH samples
+      const size_t m = p->batch.size();
+      for(size_t i0=0; i0<m; i0+=SERIAL_MAX_BATCH)
+	{
+	  const size_t k = std::min(m - i0, (size_t) SERIAL_MAX_BATCH);
+	  for(size_t i=0; i<k; i++)
+	    {
+	      ImuSample& s = p->samples[i];
+	      s = imu_sample_from_packet(p->batch.packet(i0 + i));
+	      s.comp_timestamp = t_host;
+	      s.hz = p->hz;
+	      if(p->monitor)
+		p->monitor->observe(s);
+	    }
+	  p->out->push(&p->samples[0], k);
+	}
+      p->batch.clear();
+
+      p->st.samples += m;
+      p->st.bad_checksum = p->parser.stats().bad_checksum;
+      p->st.resync_bytes = p->parser.stats().resync_bytes;
+      p->st.batch_capacity = p->batch.capacity();
+
+      // a short read drained the port
+      if((size_t) n < room)
+	return;
+    }
+
+}
+
+int SerialReader::poll_once(int timeout_ms)
+{
+
+  epoll_event ev[SERIAL_MAX_EVENTS];
+  const int n = epoll_wait(epfd, ev, SERIAL_MAX_EVENTS, timeout_ms);
+
+  if(n < 0)
+    return (errno == EINTR) ? 0 : -1;
+
+  // one host time per wakeup, taken before any read
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  const double t_host = ts.tv_sec + 1e-9*ts.tv_nsec;
+  int num = 0;
+
+  for(int i=0; i<n; i++)
+    {
+      SerialPort* p = (SerialPort*) ev[i].data.ptr;
+
+      if(p == NULL)
+	{
+	  uint64_t v;
+	  const ssize_t r = read(wake_fd, &v, sizeof(v));
+	  (void) r;
+	  continue;
+	}
+
+      p->st.wakeups++;
+
+      if(ev[i].events & EPOLLIN)
+	{
+	  read_port(p, t_host);
+	  num++;
+	}
+      else if(ev[i].events & (EPOLLHUP | EPOLLERR))
+	{
+	  p->st.errors++;
+	  epoll_ctl(epfd, EPOLL_CTL_DEL, p->fd, NULL);
+	}
+    }
+
+  return num;
+
+}
+
+int SerialReader::start(void)
+{
+
+  if(thread.joinable())
+    return -1;
+
+  stopping = false;
+  thread = std::thread([this]() {
+      while(!stopping.load(std::memory_order_relaxed))
+	if(poll_once(-1) < 0)
+	  break;
+    });
+
+  return 0;
+
+}
+
+void SerialReader::stop(void)
+{
+
+  if(!thread.joinable())
+    return;
+
+  stopping = true;
+
+  const uint64_t one = 1;
+  const ssize_t r = write(wake_fd, &one, sizeof(one));
+  (void) r;
+
+  thread.join();
+
+}
+
+const SerialPortStats& SerialReader::stats(int port) const
+{
+
+  return ports[port]->st;
+
+}
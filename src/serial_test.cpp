@@ -0,0 +1,1093 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Checks and timings for the serial port reader.
+ *
+ * Each port is a pseudo-terminal: the SerialReader opens the slave side
+ * by name, as it would a real device, and a generator thread writes
+ * synthetic KVH and Microstrain frames into the master side.
+ *
+ * The framing check writes streams with corrupted frames and junk, in
+ * random-sized pieces, and checks every good frame comes out once, in
+ * order.  A pipe filled with the shortest Microstrain frames checks that
+ * one read framing more than SERIAL_MAX_BATCH samples does not grow the
+ * batch.  The latency run paces KVH at 1 kHz and Microstrain at 500 Hz on
+ * two ports at once and reports the time from a frame's write to its
+ * delivery from the ring (p50, p99, max), and how late comp_timestamp
+ * is against the write.  Last, a burst measures throughput.
+ *
+ * The StreamMonitor is checked on a made-up stream with known drops,
+ * repeats, jitter and clock skew, through its log record, and on the
+ * KVH framing run, where every corrupted frame is a lost sequence number.
+ *
+ * Tracing is checked with threads recording spans and counters, exported
+ * to a file and counted, with a ring overfilled to count drops, and with
+ * the exporter thread writing to the trace log channel.  The cost of a
+ * span with tracing off and on is timed.
+ *
+ * The latency histograms are checked for bucket bounds, for percentiles
+ * of a known distribution recorded from several threads, for no value
+ * lost to a snapshot taken while recording, and through the logger's
+ * one-second snapshots and LAT records.  The cost of a record is timed.
+ *
+ * The flight recorder is checked for the newest records surviving in
+ * order when the ring wraps, for writes from several threads, for the
+ * last-seconds cut, for a second writer refused while the first runs,
+ * and for a child process that logs through it and is killed: the next
+ * start must recover every record, including those lost from the log
+ * file's stdio buffer.  The cost of a write is timed.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pty.h>
+#include <dirent.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <helper_funcs/serial.h>
+#include <helper_funcs/binlog.h>
+#include <helper_funcs/stream_monitor.h>
+#include <helper_funcs/log.h>
+#include <helper_funcs/trace.h>
+#include <helper_funcs/latency_hist.h>
+#include <helper_funcs/flight_rec.h>
+
+#define LATENCY_SECONDS 3.0
+
+static double now_sec(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// CLOCK_REALTIME, the clock comp_timestamp is in
+static double host_sec(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static ImuPacket make_packet(int i)
+{
+  ImuPacket p;
+  p.ang = Eigen::Vector3d(0.01*sin(0.001*i), -0.02, 1e-6*i);
+  p.acc = Eigen::Vector3d(0.1, -0.2*cos(0.002*i), 9.81);
+  p.mag = Eigen::Vector3d(0.2, 0.05, -0.4);
+  p.seq_num = i;
+  p.t = 1000.0 + 0.001*i;
+  p.dt = 0.001;
+  p.fluid_pressure = 0.0f;
+  return p;
+}
+
+static int encode(int format, const ImuPacket& p, uint8_t* buf)
+{
+  return (format == BINLOG_FORMAT_KVH) ? binlog_encode_kvh(p, true, buf) : binlog_encode_mst(p, buf);
+}
+
+struct Pty
+{
+  int master;
+  char name[256];
+};
+
+static int open_pty(Pty& p)
+{
+  int slave;
+  if(openpty(&p.master, &slave, p.name, NULL, NULL) != 0)
+    return -1;
+  // the reader opens the slave by name; the master stays with the generator
+  close(slave);
+  return 0;
+}
+
+static void write_all(int fd, const uint8_t* p, size_t n)
+{
+  while(n > 0)
+    {
+      ssize_t m = write(fd, p, n);
+      if(m <= 0)
+	return;
+      p += m;
+      n -= m;
+    }
+}
+
+static int check_framing(int format, const char* name, bool use_params)
+{
+  Pty pty;
+  if(open_pty(pty) != 0)
+    {
+      printf("FAIL: openpty\n");
+      return 1;
+    }
+
+  ImuSampleRing ring(1 << 16, SPSC_WAKE_FUTEX);
+  SerialReader reader;
+  int port;
+  if(use_params)
+    {
+      config_params params;
+      params.port = pty.name;
+      params.baud = 115200;
+      params.hz = 1000;
+      port = reader.add_port(params, format, ring);
+    }
+  else
+    port = reader.add_port(pty.name, 921600, format, ring, 1000.0);
+
+  // KVH frames carry a 7-bit sequence number
+  StreamMonitor monitor(1000.0, 128);
+  reader.set_monitor(port, &monitor);
+
+  if(port < 0 || reader.add_port(pty.name, 12345, format, ring) >= 0)
+    {
+      printf("FAIL: %s add_port\n", name);
+      close(pty.master);
+      return 1;
+    }
+  reader.start();
+
+  // every 17th frame corrupted, junk every 29th
+  std::vector<uint8_t> stream;
+  std::vector<int> good;
+  uint8_t buf[BINLOG_MAX_FRAME];
+  for(int i=0; i<20000; i++)
+    {
+      const int len = encode(format, make_packet(i), buf);
+      if(i % 17 == 5)
+	buf[len/2] ^= 0x40;
+      else
+	good.push_back(i);
+      stream.insert(stream.end(), buf, buf + len);
+      if(i % 29 == 3)
+	stream.insert(stream.end(), (const uint8_t*) "\x75\xfe\x81junk", (const uint8_t*) "\x75\xfe\x81junk" + 7);
+    }
+
+  std::thread gen([&]() {
+      srand(41);
+      size_t off = 0;
+      while(off < stream.size())
+	{
+	  const size_t n = std::min(stream.size() - off, (size_t) (1 + rand() % 700));
+	  write_all(pty.master, &stream[off], n);
+	  off += n;
+	  if(rand() % 8 == 0)
+	    usleep(100);
+	}
+    });
+
+  ImuSampleVector got;
+  ImuSample out[256];
+  const double t0 = now_sec();
+  while(got.size() < good.size() && now_sec() - t0 < 10.0)
+    {
+      const size_t n = ring.wait_pop(out, 256, 0.1);
+      got.insert(got.end(), out, out + n);
+    }
+  gen.join();
+  reader.stop();
+
+  int bad = 0;
+  for(size_t i=0; i<got.size() && i<good.size(); i++)
+    {
+      const ImuPacket p = make_packet(good[i]);
+      if((got[i].ang_vec() - p.ang).norm() > 1e-6 || (got[i].acc_vec() - p.acc).norm() > 1e-5 ||
+	 got[i].comp_timestamp <= 0.0 || (i > 0 && got[i].comp_timestamp < got[i-1].comp_timestamp))
+	bad++;
+    }
+
+  const SerialPortStats& st = reader.stats(port);
+  StreamStats ms;
+  monitor.snapshot(ms);
+  const uint64_t lost = (format == BINLOG_FORMAT_KVH) ? 20000 - good.size() : 0;
+  if(bad || got.size() != good.size() || st.samples != good.size() ||
+     st.bad_checksum == 0 || st.bytes != stream.size() || ring.overrun_count() != 0 ||
+     ms.samples != good.size() || ms.lost != lost || ms.duplicates != 0 || ms.out_of_order != 0)
+    {
+      printf("FAIL: %s: %d of %d frames, %d differ, %d bad checksums, %d of %d bytes\n", name,
+	     (int) got.size(), (int) good.size(), bad, (int) st.bad_checksum,
+	     (int) st.bytes, (int) stream.size());
+      close(pty.master);
+      return 1;
+    }
+
+  printf("%s framing: %d frames in %d reads, %d wakeups\n", name, (int) got.size(), (int) st.reads, (int) st.wakeups);
+
+  close(pty.master);
+  return 0;
+}
+
+// shortest Microstrain frame that carries a sample: acceleration only
+static int encode_mst_short(int i, uint8_t* buf)
+{
+  const float acc[3] = {0.1f, -0.2f, 9.81f + 1e-3f*(i % 100)};
+  buf[0] = 0x75;
+  buf[1] = 0x65;
+  buf[2] = 0x80;
+  buf[3] = 14;
+  buf[4] = 14;
+  buf[5] = 0x04;
+  for(int k=0; k<3; k++)
+    {
+      uint32_t v;
+      memcpy(&v, &acc[k], 4);
+      v = __builtin_bswap32(v);
+      memcpy(buf + 6 + 4*k, &v, 4);
+    }
+  uint8_t ck1 = 0;
+  uint8_t ck2 = 0;
+  for(int j=0; j<18; j++)
+    {
+      ck1 += buf[j];
+      ck2 += ck1;
+    }
+  buf[18] = ck1;
+  buf[19] = ck2;
+  return BINLOG_MIN_SAMPLE_FRAME;
+}
+
+static int check_batch_alloc(void)
+{
+  int fds[2];
+  if(pipe(fds) != 0)
+    {
+      printf("FAIL: pipe\n");
+      return 1;
+    }
+  fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  // the whole burst waits in the pipe, so the first read takes a full
+  // receive buffer of frames
+  const int pipe_bytes = fcntl(fds[0], F_SETPIPE_SZ, 1 << 20);
+  const int frames = std::min(pipe_bytes > 0 ? pipe_bytes : 65536, 2*(SERIAL_RX_BYTES + BINLOG_MAX_FRAME))/BINLOG_MIN_SAMPLE_FRAME;
+
+  ImuSampleRing ring(1 << 16, SPSC_WAKE_FUTEX);
+  SerialReader reader;
+  const int port = reader.add_fd(fds[0], BINLOG_FORMAT_MST, ring, 1000.0);
+  const size_t cap = reader.stats(port).batch_capacity;
+
+  std::vector<uint8_t> stream(frames*BINLOG_MIN_SAMPLE_FRAME);
+  for(int i=0; i<frames; i++)
+    encode_mst_short(i, &stream[i*BINLOG_MIN_SAMPLE_FRAME]);
+  write_all(fds[1], &stream[0], stream.size());
+
+  const double t0 = now_sec();
+  while(reader.stats(port).samples < (uint64_t) frames && now_sec() - t0 < 10.0)
+    reader.poll_once(100);
+
+  const SerialPortStats& st = reader.stats(port);
+  const double per_read = st.reads ? (double) st.samples/st.reads : 0.0;
+  int errors = 0;
+  if(st.samples != (uint64_t) frames || ring.size() != (size_t) frames || st.bad_checksum != 0)
+    {
+      printf("FAIL: batch burst framed %d of %d frames, %d bad checksums\n",
+	     (int) st.samples, frames, (int) st.bad_checksum);
+      errors++;
+    }
+  else if(cap < (SERIAL_RX_BYTES + BINLOG_MAX_FRAME)/BINLOG_MIN_SAMPLE_FRAME || st.batch_capacity != cap)
+    {
+      printf("FAIL: batch capacity %d, then %d after reads of %.0f samples\n",
+	     (int) cap, (int) st.batch_capacity, per_read);
+      errors++;
+    }
+  else
+    printf("batch burst: %d frames in %d reads, capacity %d unchanged\n", frames, (int) st.reads, (int) cap);
+
+  close(fds[1]);
+  return errors;
+}
+
+static int check_monitor(void)
+{
+  int errors = 0;
+  const double hz = 1000.0;
+  StreamMonitor monitor(hz, 128);
+
+  // 10000 samples with 3 dropped at 500, 700 repeated, 901 before 900,
+  // 5 us of sensor jitter every 100th sample, and a host clock 20 ppm fast
+  // that delivers in bursts of 4
+  std::vector<int> order;
+  for(int i=0; i<10000; i++)
+    if(i < 500 || i > 502)
+      order.push_back(i);
+  order.insert(std::find(order.begin(), order.end(), 700), 700);
+  std::iter_swap(std::find(order.begin(), order.end(), 900), std::find(order.begin(), order.end(), 901));
+
+  const double t_base = 2000.0;
+  for(size_t k=0; k<order.size(); k++)
+    {
+      const int i = order[k];
+      const double t = t_base + i/hz + ((i % 100 == 50) ? 5e-6 : 0.0);
+      const double comp = 1.7e9 + (i | 3)/hz*(1.0 + 20e-6) + 0.0015;
+      monitor.observe((uint32_t) (i % 128), t, comp);
+    }
+
+  StreamStats st;
+  monitor.snapshot(st);
+  if(st.samples != 9998 || st.gaps != 2 || st.lost != 4 || st.duplicates != 1 || st.out_of_order != 1 ||
+     fabs(st.jitter_max - 5e-6) > 1e-7 || fabs(st.skew_ppm - 20.0) > 0.5 ||
+     st.arrival[0] < 7000 || st.arrival[stream_monitor_bin(0.004)] < 2000)
+    {
+      printf("FAIL: StreamMonitor: %d samples, %d gaps, %d lost, %d dup, %d ooo, jitter %g, skew %g ppm\n",
+	     (int) st.samples, (int) st.gaps, (int) st.lost, (int) st.duplicates,
+	     (int) st.out_of_order, st.jitter_max, st.skew_ppm);
+      errors++;
+    }
+
+  // the summary record, through the logger
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/serial_test_%d", (int) getpid());
+  mkdir(dir, 0755);
+  log_set_log_dir(LOG_FID_MST_FILT_FORMAT, dir);
+  monitor.log_summary(LOG_FID_MST_FILT_FORMAT, "MON");
+  log_flush_and_close_log_files();
+
+  std::string text;
+  DIR* d = opendir(dir);
+  struct dirent* e;
+  while(d && (e = readdir(d)) != NULL)
+    {
+      if(e->d_name[0] == '.')
+	continue;
+      const std::string name = std::string(dir) + "/" + e->d_name;
+      FILE* f = fopen(name.c_str(), "r");
+      char line[1024];
+      while(f && fgets(line, sizeof(line), f))
+	text += line;
+      if(f)
+	fclose(f);
+      unlink(name.c_str());
+    }
+  if(d)
+    closedir(d);
+  rmdir(dir);
+
+  if(text.find("MON ") == std::string::npos || text.find("n 9998 gaps 2 lost 4 dup 1 ooo 1") == std::string::npos ||
+     text.find("jitter_max_all_us 5.0 ") == std::string::npos)
+    {
+      printf("FAIL: StreamMonitor summary record: %s\n", text.c_str());
+      errors++;
+    }
+
+  // an empty interval
+  char buf[512];
+  stream_monitor_format(st, st, buf, sizeof(buf));
+  if(strncmp(buf, "n 0 gaps 0 lost 0 dup 0 ooo 0 ", 30) != 0)
+    {
+      printf("FAIL: stream_monitor_format of an empty interval: %s\n", buf);
+      errors++;
+    }
+
+  printf("monitor summary: %s\n", text.c_str() + std::min(text.size(), text.find("MON ")));
+
+  // cost on the acquisition thread
+  const int num = 10000000;
+  const double t0 = now_sec();
+  for(int i=0; i<num; i++)
+    monitor.observe((uint32_t) (i % 128), t_base + i/hz, 1.7e9 + i/hz);
+  const double t = now_sec() - t0;
+  printf("monitor observe: %.1f ns/sample\n", 1e9*t/num);
+
+  return errors;
+}
+
+// lines of a file
+static std::vector<std::string> read_lines(FILE* f)
+{
+  std::vector<std::string> lines;
+  char line[1024];
+  while(fgets(line, sizeof(line), f))
+    lines.push_back(line);
+  return lines;
+}
+
+static int count_lines(const std::vector<std::string>& lines, const char* a, const char* b)
+{
+  int n = 0;
+  for(size_t i=0; i<lines.size(); i++)
+    if(lines[i].find(a) != std::string::npos && lines[i].find(b) != std::string::npos)
+      n++;
+  return n;
+}
+
+// every line after the [ is one event object
+static bool trace_lines_ok(const std::vector<std::string>& lines)
+{
+  if(lines.empty() || lines[0] != "[\n")
+    return false;
+  for(size_t i=1; i<lines.size(); i++)
+    if(lines[i].compare(0, 1, "{") != 0 || lines[i].size() < 3 || lines[i].compare(lines[i].size() - 3, 3, "},\n") != 0)
+      return false;
+  return true;
+}
+
+static int check_trace(void)
+{
+  int errors = 0;
+  const int num_threads = 4;
+  const int num_spans = 1000;
+  const char* names[num_threads] = {"worker 0", "worker 1", "worker 2", "worker 3"};
+
+  trace_enable(true);
+
+  // spans and counters from several threads
+  std::vector<std::thread> threads;
+  for(int k=0; k<num_threads; k++)
+    threads.push_back(std::thread([&, k]() {
+	  trace_thread_name(names[k]);
+	  for(int i=0; i<num_spans; i++)
+	    {
+	      TRACE_SPAN("test", "span");
+	      if(i % 100 == 0)
+		TRACE_COUNTER("test", "progress", i);
+	    }
+	}));
+  for(int k=0; k<num_threads; k++)
+    threads[k].join();
+
+  FILE* f = tmpfile();
+  fputs("[\n", f);
+  const int n = trace_export(f);
+  rewind(f);
+  std::vector<std::string> lines = read_lines(f);
+  fclose(f);
+
+  const int spans = count_lines(lines, "\"cat\":\"test\",\"ph\":\"X\"", "\"name\":\"span\"");
+  const int counters = count_lines(lines, "\"ph\":\"C\"", "\"name\":\"progress\"");
+  const int thread_names = count_lines(lines, "\"thread_name\"", "\"name\":\"worker ");
+  if(spans != num_threads*num_spans || counters != num_threads*num_spans/100 || thread_names != num_threads ||
+     n < spans + counters || !trace_lines_ok(lines))
+    {
+      printf("FAIL: trace export: %d spans, %d counters, %d thread names, %d events\n", spans, counters, thread_names, n);
+      errors++;
+    }
+
+  // a full ring drops, counts, and the rings are empty after an export
+  const unsigned long long dropped = trace_dropped();
+  std::thread([]() {
+      for(int i=0; i<TRACE_BUFFER_EVENTS + 100; i++)
+	trace_event('i', "test", "fill", rov_get_clock_ns(), 0);
+    }).join();
+  f = fopen("/dev/null", "w");
+  const int filled = trace_export(f);
+  const int again = trace_export(f);
+  fclose(f);
+  if(trace_dropped() - dropped != 100 || filled != TRACE_BUFFER_EVENTS || again != 0)
+    {
+      printf("FAIL: trace ring full: %llu dropped, %d and %d exported\n", trace_dropped() - dropped, filled, again);
+      errors++;
+    }
+
+  // the exporter thread, through the trace log channel
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/serial_test_trace_%d", (int) getpid());
+  mkdir(dir, 0755);
+  log_set_log_dir(LOG_FID_TRACE_FORMAT, dir);
+  trace_start_exporter(LOG_FID_TRACE_FORMAT, 0.01);
+  for(int i=0; i<200; i++)
+    {
+      TRACE_SPAN("test", "exported");
+      usleep(100);
+    }
+  trace_stop_exporter();
+  trace_enable(false);
+  log_flush_and_close_log_files();
+
+  lines.clear();
+  DIR* d = opendir(dir);
+  struct dirent* e;
+  while(d && (e = readdir(d)) != NULL)
+    {
+      if(e->d_name[0] == '.')
+	continue;
+      const std::string name = std::string(dir) + "/" + e->d_name;
+      f = fopen(name.c_str(), "r");
+      if(f)
+	{
+	  lines = read_lines(f);
+	  fclose(f);
+	}
+      unlink(name.c_str());
+    }
+  if(d)
+    closedir(d);
+  rmdir(dir);
+
+  const int exported = count_lines(lines, "\"ph\":\"X\"", "\"name\":\"exported\"");
+  if(exported != 200 || count_lines(lines, "\"thread_name\"", "trace_export") != 1 || !trace_lines_ok(lines))
+    {
+      printf("FAIL: trace log channel: %d of 200 spans in %d lines, first line %s\n",
+	     exported, (int) lines.size(), lines.empty() ? "" : lines[0].c_str());
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_trace(void)
+{
+  const int num = 10000000;
+  const int chunk = TRACE_BUFFER_EVENTS/2;
+
+  double t0 = now_sec();
+  for(int i=0; i<num; i++)
+    {
+      TRACE_SPAN("bench", "off");
+    }
+  const double t_off = now_sec() - t0;
+
+  // on, exported every half ring so nothing drops
+  trace_enable(true);
+  FILE* f = fopen("/dev/null", "w");
+  double t_on = 0.0, t_export = 0.0;
+  for(int done=0; done<num/10; done+=chunk)
+    {
+      t0 = now_sec();
+      for(int i=0; i<chunk; i++)
+	{
+	  TRACE_SPAN("bench", "on");
+	}
+      const double t1 = now_sec();
+      trace_export(f);
+      t_on += t1 - t0;
+      t_export += now_sec() - t1;
+    }
+  fclose(f);
+  trace_enable(false);
+
+  const int num_on = (num/10 + chunk - 1)/chunk*chunk;
+  printf("trace span: %.2f ns off, %.1f ns on, %.1f ns to export\n",
+	 1e9*t_off/num, 1e9*t_on/num_on, 1e9*t_export/num_on);
+}
+
+// lines of every file in dir, which is removed
+static std::vector<std::string> read_dir_lines(const char* dir)
+{
+  std::vector<std::string> lines;
+  DIR* d = opendir(dir);
+  struct dirent* e;
+  while(d && (e = readdir(d)) != NULL)
+    {
+      if(e->d_name[0] == '.')
+	continue;
+      const std::string name = std::string(dir) + "/" + e->d_name;
+      FILE* f = fopen(name.c_str(), "r");
+      if(f)
+	{
+	  const std::vector<std::string> more = read_lines(f);
+	  lines.insert(lines.end(), more.begin(), more.end());
+	  fclose(f);
+	}
+      unlink(name.c_str());
+    }
+  if(d)
+    closedir(d);
+  rmdir(dir);
+  return lines;
+}
+
+static bool near(long long got, long long want)
+{
+  return got >= want && got <= want + want/16;
+}
+
+static int check_latency(void)
+{
+  int errors = 0;
+
+  // every value is inside its bucket, and buckets are at most 1/16 wide
+  for(long long v=0; v<(1LL << 40); v = v < 100 ? v + 1 : v + v/7 + 1)
+    {
+      const int b = latency_hist_bucket(v);
+      const long long low = latency_hist_bucket_low(b);
+      const long long high = latency_hist_bucket_high(b);
+      if(low > v || high < v || (b < LATENCY_HIST_BUCKETS - 1 && high - low > low/16))
+	{
+	  printf("FAIL: latency bucket %d [%lld, %lld] for %lld\n", b, low, high, v);
+	  errors++;
+	  break;
+	}
+    }
+
+  // 1 to 100000 ns from each of four threads
+  const int num_threads = 4;
+  const long long num = 100000;
+  LatencyHistogram hist;
+  LatencySnapshot snap;
+  std::vector<std::thread> threads;
+  for(int k=0; k<num_threads; k++)
+    threads.push_back(std::thread([&hist, num, k]() {
+	  for(long long i=0; i<num; i++)
+	    hist.record((i*7919 + k) % num + 1);
+	}));
+  for(int k=0; k<num_threads; k++)
+    threads[k].join();
+  hist.snapshot_and_reset(snap);
+
+  if(snap.count != (uint64_t) (num_threads*num) || snap.sum_ns != num_threads*num*(num + 1)/2 || snap.max_ns != num ||
+     !near(snap.percentile(0.5), num/2) || !near(snap.percentile(0.99), num*99/100) || snap.percentile(1.0) != num ||
+     snap.percentile(0.0) != 1)
+    {
+      printf("FAIL: latency percentiles: n %llu sum %lld max %lld p0 %lld p50 %lld p99 %lld p100 %lld\n",
+	     (unsigned long long) snap.count, snap.sum_ns, snap.max_ns, snap.percentile(0.0),
+	     snap.percentile(0.5), snap.percentile(0.99), snap.percentile(1.0));
+      errors++;
+    }
+  hist.snapshot_and_reset(snap);
+  if(snap.count != 0 || snap.percentile(0.5) != 0)
+    {
+      printf("FAIL: latency histogram not reset: n %llu\n", (unsigned long long) snap.count);
+      errors++;
+    }
+
+  // snapshots taken while recording lose nothing
+  LatencySnapshot total;
+  std::atomic<bool> done(false);
+  std::thread rec([&]() {
+      for(long long i=0; i<10*num; i++)
+	hist.record(i & 0xffff);
+      done.store(true);
+    });
+  while(!done.load())
+    {
+      hist.snapshot_and_reset(snap);
+      total.add(snap);
+    }
+  rec.join();
+  hist.snapshot_and_reset(snap);
+  total.add(snap);
+  if(total.count != (uint64_t) (10*num) || total.max_ns != 0xffff)
+    {
+      printf("FAIL: latency snapshots while recording: %llu of %lld values\n", (unsigned long long) total.count, 10*num);
+      errors++;
+    }
+
+  // through the logger
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/serial_test_latency_%d", (int) getpid());
+  mkdir(dir, 0755);
+  log_set_log_dir(LOG_FID_KVH_FORMAT, dir);
+  log_set_log_dir(LOG_FID_LATENCY_FORMAT, dir);
+  log_one_hertz_update();
+
+  for(int i=0; i<1000; i++)
+    log_this_now_dsl_format(LOG_FID_KVH_FORMAT, (char *) "KVH", (char *) "latency check");
+  for(int i=0; i<100; i++)
+    log_record_queue_wait(LOG_FID_KVH_FORMAT, 5000);
+  log_set_latency_log(1);
+  log_one_hertz_update();
+  log_set_latency_log(0);
+
+  const long long writes = log_latency_count(LOG_FID_KVH_FORMAT, LOG_LATENCY_WRITE);
+  const long long rotations = log_latency_count(LOG_FID_KVH_FORMAT, LOG_LATENCY_ROTATE);
+  const long long waits = log_latency_count(LOG_FID_KVH_FORMAT, LOG_LATENCY_QUEUE);
+  const long long p99 = log_latency_percentile(LOG_FID_KVH_FORMAT, LOG_LATENCY_WRITE, 0.99);
+  const long long wait = log_latency_percentile(LOG_FID_KVH_FORMAT, LOG_LATENCY_QUEUE, 0.5);
+  if(writes != 1000 || rotations != 1 || waits != 100 || wait != 5000 || p99 <= 0 ||
+     log_latency_count(LOG_MAX_NUM_LOG_FILES, LOG_LATENCY_WRITE) != -1 ||
+     log_latency_percentile(LOG_FID_KVH_FORMAT, LOG_LATENCY_NUM, 0.5) != -1)
+    {
+      printf("FAIL: log latency: %lld writes, %lld rotations, %lld waits, wait p50 %lld ns, write p99 %lld ns\n",
+	     writes, rotations, waits, wait, p99);
+      errors++;
+    }
+  log_latency_snapshot(LOG_FID_KVH_FORMAT, LOG_LATENCY_WRITE, &snap);
+  printf("log write latency: p50 %.2f us, p99 %.2f us, p999 %.2f us, max %.2f us; rotation %.1f us\n",
+	 1e-3*snap.percentile(0.5), 1e-3*snap.percentile(0.99), 1e-3*snap.percentile(0.999), 1e-3*snap.max_ns,
+	 1e-3*log_latency_percentile(LOG_FID_KVH_FORMAT, LOG_LATENCY_ROTATE, 1.0));
+  log_flush_and_close_log_files();
+
+  const std::vector<std::string> lines = read_dir_lines(dir);
+  if(count_lines(lines, "LAT ", "KVH write n 1000 p50_us ") != 1 || count_lines(lines, "LAT ", " queue n 100 p50_us 5.0 ") != 1 ||
+     count_lines(lines, "KVH ", "latency check") != 1000)
+    {
+      printf("FAIL: LAT record not written\n");
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_latency(void)
+{
+  const long long num = 10000000;
+  LatencyHistogram hist;
+  LatencySnapshot snap;
+
+  double t0 = now_sec();
+  for(long long i=0; i<num; i++)
+    hist.record(i & 0xfffff);
+  const double t_one = now_sec() - t0;
+
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  t0 = now_sec();
+  for(int k=0; k<num_threads; k++)
+    threads.push_back(std::thread([&hist, num]() {
+	  for(long long i=0; i<num; i++)
+	    hist.record(i & 0xfffff);
+	}));
+  for(int k=0; k<num_threads; k++)
+    threads[k].join();
+  const double t_four = now_sec() - t0;
+
+  t0 = now_sec();
+  for(int i=0; i<1000; i++)
+    hist.snapshot_and_reset(snap);
+  const double t_snap = now_sec() - t0;
+
+  printf("latency record: %.1f ns on one thread, %.1f ns each on %d threads; snapshot %.1f us\n",
+	 1e9*t_one/num, 1e9*t_four/num, num_threads, 1e6*t_snap/1000);
+}
+
+// records of a segment, one per line
+static std::vector<std::string> dump_lines(const char* name, double seconds)
+{
+  FILE* f = tmpfile();
+  flight_rec_dump(name, f, seconds);
+  rewind(f);
+  std::vector<std::string> lines = read_lines(f);
+  fclose(f);
+  return lines;
+}
+
+static int check_flight_rec(void)
+{
+  int errors = 0;
+  char name[64];
+  char rec[128];
+  snprintf(name, sizeof(name), "/serial_test_fr_%d", (int) getpid());
+
+  // a ring that wraps many times keeps the newest records, in order
+  FlightRecorder fr;
+  if(fr.open(name, 1 << 16) != 0)
+    {
+      printf("FAIL: flight recorder open %s\n", name);
+      return 1;
+    }
+  const int num = 10000;
+  for(int i=0; i<num; i++)
+    fr.write(rec, snprintf(rec, sizeof(rec), "rec %05d %.*s\n", i, i % 50, "..................................................."));
+  std::vector<std::string> lines = dump_lines(name, 0.0);
+  int in_order = 0;
+  for(size_t i=0; i<lines.size(); i++)
+    in_order += (atoi(lines[i].c_str() + 4) == num - (int) lines.size() + (int) i);
+  if(lines.size() < 500 || in_order != (int) lines.size())
+    {
+      printf("FAIL: flight recorder wrap: %d records, %d in order\n", (int) lines.size(), in_order);
+      errors++;
+    }
+
+  // several threads at once
+  const int num_threads = 4;
+  fr.open(name, 4 << 20);
+  std::vector<std::thread> threads;
+  for(int k=0; k<num_threads; k++)
+    threads.push_back(std::thread([&fr, k, num]() {
+	  char buf[64];
+	  for(int i=0; i<num; i++)
+	    fr.write(buf, snprintf(buf, sizeof(buf), "%d %d\n", k, i));
+	}));
+  for(int k=0; k<num_threads; k++)
+    threads[k].join();
+  lines = dump_lines(name, 0.0);
+  int next[num_threads] = {0, 0, 0, 0};
+  int bad = 0;
+  for(size_t i=0; i<lines.size(); i++)
+    {
+      int k = -1, j = -1;
+      if(sscanf(lines[i].c_str(), "%d %d", &k, &j) != 2 || k < 0 || k >= num_threads || j != next[k]++)
+	bad++;
+    }
+  if(lines.size() != (size_t) (num_threads*num) || bad)
+    {
+      printf("FAIL: flight recorder threads: %d of %d records, %d out of order\n", (int) lines.size(), num_threads*num, bad);
+      errors++;
+    }
+
+  // the last seconds only
+  fr.open(name, 1 << 16);
+  for(int i=0; i<100; i++)
+    fr.write("old\n", 4);
+  usleep(200000);
+  for(int i=0; i<100; i++)
+    fr.write("new\n", 4);
+  lines = dump_lines(name, 0.1);
+  if(lines.size() != 100 || count_lines(lines, "new", "new") != 100)
+    {
+      printf("FAIL: flight recorder last 0.1 s: %d records\n", (int) lines.size());
+      errors++;
+    }
+  fr.close();
+  if(flight_rec_dump(name, stdout, 0.0) != -1)
+    {
+      printf("FAIL: flight recorder segment left after close\n");
+      errors++;
+    }
+
+  // a second writer while the first is running, then after it is gone
+  int ready[2];
+  if(pipe(ready) != 0)
+    return errors + 1;
+  const pid_t owner = fork();
+  if(owner == 0)
+    {
+      FlightRecorder other;
+      other.open(name, 1 << 16);
+      other.write("owner\n", 6);
+      if(write(ready[1], "x", 1) != 1)
+	_exit(1);
+      pause();
+      _exit(0);
+    }
+  char c;
+  const bool started = read(ready[0], &c, 1) == 1;
+  close(ready[0]);
+  close(ready[1]);
+  const bool refused = fr.open(name, 1 << 16) != 0 && errno == EBUSY;
+  lines = dump_lines(name, 0.0);
+  kill(owner, SIGKILL);
+  waitpid(owner, NULL, 0);
+  const bool replaced = fr.open(name, 1 << 16) == 0 && flight_rec_dump(name, stdout, 0.0) == 0;
+  fr.close();
+  if(!started || !refused || lines.size() != 1 || count_lines(lines, "owner", "owner") != 1 || !replaced)
+    {
+      printf("FAIL: flight recorder of a running process: refused %d, %d records left, replaced once gone %d\n",
+	     (int) refused, (int) lines.size(), (int) replaced);
+      errors++;
+    }
+
+  // a logging process killed with records still in its stdio buffer
+  char dir[256];
+  snprintf(dir, sizeof(dir), "/tmp/serial_test_flight_%d", (int) getpid());
+  mkdir(dir, 0755);
+  log_set_log_dir(LOG_FID_KVH_FORMAT, dir);
+  const int num_logged = 1000;
+  const pid_t child = fork();
+  if(child == 0)
+    {
+      log_set_flight_recorder(LOG_FID_KVH_FORMAT, 1 << 20, 0.0);
+      for(int i=0; i<num_logged; i++)
+	{
+	  snprintf(rec, sizeof(rec), "crash check %d", i);
+	  log_this_now_dsl_format(LOG_FID_KVH_FORMAT, (char *) "KVH", rec);
+	}
+      raise(SIGKILL);
+    }
+  int status = 0;
+  waitpid(child, &status, 0);
+
+  const std::vector<std::string> logged = read_dir_lines(dir);
+  mkdir(dir, 0755);
+  const int recovered = log_set_flight_recorder(LOG_FID_KVH_FORMAT, 1 << 20, 0.0);
+  log_set_flight_recorder(LOG_FID_KVH_FORMAT, 0, 0.0);
+  log_flight_name(LOG_FID_KVH_FORMAT, name, sizeof(name));
+  lines = read_dir_lines(dir);
+  const int last = lines.empty() ? -1 : atoi(lines.back().c_str() + lines.back().rfind(' ') + 1);
+
+  printf("flight recorder: child killed with %d of %d records in its log file, %d recovered\n",
+	 (int) logged.size(), num_logged, recovered);
+  if(!WIFSIGNALED(status) || recovered != num_logged || count_lines(lines, "KVH ", "crash check") != num_logged ||
+     last != num_logged - 1 || flight_rec_dump(name, stdout, 0.0) != -1)
+    {
+      printf("FAIL: flight recorder recovery: %d recovered, %d lines, last %d\n", recovered, (int) lines.size(), last);
+      errors++;
+    }
+
+  return errors;
+}
+
+static void bench_flight_rec(void)
+{
+  char name[64];
+  snprintf(name, sizeof(name), "/serial_test_fr_%d", (int) getpid());
+
+  FlightRecorder fr;
+  if(fr.open(name, 1 << 20) != 0)
+    return;
+
+  const int num = 10000000;
+  const char rec[] = "KVH 2026/10/19 13:01:48.950296 1.0,2,0.1,0.2,0.3,0.4,0.5,0.6,0.7,0.8,0.9\n";
+  const double t0 = now_sec();
+  for(int i=0; i<num; i++)
+    fr.write(rec, sizeof(rec) - 1);
+  const double t = now_sec() - t0;
+
+  printf("flight recorder write: %.1f ns per %d byte record\n", 1e9*t/num, (int) sizeof(rec) - 1);
+}
+
+static double percentile(std::vector<double>& v, double p)
+{
+  if(v.empty())
+    return 0.0;
+  const size_t k = std::min(v.size() - 1, (size_t) (p*v.size()));
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+static int run_latency(void)
+{
+  const int formats[2] = {BINLOG_FORMAT_KVH, BINLOG_FORMAT_MST};
+  const char* names[2] = {"KVH 1 kHz", "MST 500 Hz"};
+  const double hz[2] = {1000.0, 500.0};
+  const int num[2] = {(int) (LATENCY_SECONDS*hz[0]), (int) (LATENCY_SECONDS*hz[1])};
+
+  Pty pty[2];
+  ImuSampleRing* ring[2];
+  SerialReader reader;
+  std::vector<double> written[2];
+
+  for(int k=0; k<2; k++)
+    {
+      if(open_pty(pty[k]) != 0)
+	{
+	  printf("FAIL: openpty\n");
+	  return 1;
+	}
+      ring[k] = new ImuSampleRing(4096, SPSC_WAKE_POLL);
+      reader.add_port(pty[k].name, 921600, formats[k], *ring[k], hz[k]);
+      written[k].resize(num[k]);
+    }
+  reader.start();
+
+  // both streams on one paced thread, as two sensors would arrive
+  std::thread gen([&]() {
+      uint8_t buf[BINLOG_MAX_FRAME];
+      int next[2] = {0, 0};
+      const double t0 = now_sec() + 0.01;
+      while(next[0] < num[0] || next[1] < num[1])
+	{
+	  const double due0 = (next[0] < num[0]) ? t0 + next[0]/hz[0] : HUGE_VAL;
+	  const double due1 = (next[1] < num[1]) ? t0 + next[1]/hz[1] : HUGE_VAL;
+	  const int k = (due0 <= due1) ? 0 : 1;
+	  const double due = std::min(due0, due1);
+
+	  timespec ts;
+	  ts.tv_sec = (time_t) due;
+	  ts.tv_nsec = (long) ((due - ts.tv_sec)*1e9);
+	  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+	  const int len = encode(formats[k], make_packet(next[k]), buf);
+	  written[k][next[k]] = host_sec();
+	  write_all(pty[k].master, buf, len);
+	  next[k]++;
+	}
+    });
+
+  // consumer polls both rings
+  std::vector<double> delivery[2], stamp[2];
+  int count[2] = {0, 0};
+  ImuSample out[64];
+  const double t_end = now_sec() + LATENCY_SECONDS + 2.0;
+  while((count[0] < num[0] || count[1] < num[1]) && now_sec() < t_end)
+    for(int k=0; k<2; k++)
+      {
+	const size_t n = ring[k]->pop(out, 64);
+	const double t = host_sec();
+	for(size_t j=0; j<n && count[k] < num[k]; j++, count[k]++)
+	  {
+	    delivery[k].push_back(t - written[k][count[k]]);
+	    stamp[k].push_back(out[j].comp_timestamp - written[k][count[k]]);
+	  }
+      }
+  gen.join();
+  reader.stop();
+
+  int errors = 0;
+  for(int k=0; k<2; k++)
+    {
+      if(count[k] != num[k])
+	{
+	  printf("FAIL: %s: %d of %d samples delivered\n", names[k], count[k], num[k]);
+	  errors++;
+	}
+      const double p50 = percentile(delivery[k], 0.50);
+      const double p99 = percentile(delivery[k], 0.99);
+      const double dmax = delivery[k].empty() ? 0.0 : *std::max_element(delivery[k].begin(), delivery[k].end());
+      const double s99 = percentile(stamp[k], 0.99);
+      printf("latency %-10s write to delivery p50 %6.1f us, p99 %6.1f us, max %7.1f us; timestamp p99 %6.1f us after write\n",
+	     names[k], 1e6*p50, 1e6*p99, 1e6*dmax, 1e6*s99);
+
+      close(pty[k].master);
+    }
+
+  delete ring[0];
+  delete ring[1];
+
+  return errors;
+}
+
+static void bench_burst(void)
+{
+  Pty pty;
+  if(open_pty(pty) != 0)
+    return;
+
+  ImuSampleRing ring(1 << 16, SPSC_WAKE_FUTEX);
+  SerialReader reader;
+  reader.add_port(pty.name, 921600, BINLOG_FORMAT_KVH, ring, 1000.0);
+  reader.start();
+
+  std::vector<uint8_t> stream;
+  uint8_t buf[BINLOG_MAX_FRAME];
+  int frames = 0;
+  while(stream.size() < (32 << 20))
+    {
+      const int len = encode(BINLOG_FORMAT_KVH, make_packet(frames++), buf);
+      stream.insert(stream.end(), buf, buf + len);
+    }
+
+  const double t0 = now_sec();
+  std::thread gen([&]() { write_all(pty.master, &stream[0], stream.size()); });
+
+  ImuSample out[256];
+  int got = 0;
+  while(got < frames && now_sec() - t0 < 30.0)
+    got += (int) ring.wait_pop(out, 256, 0.1);
+  const double t = now_sec() - t0;
+  gen.join();
+  reader.stop();
+
+  printf("burst, KVH through a pty: %6.1f MB/s, %5.2f Msamples/s, %d of %d frames\n",
+	 1e-6*stream.size()/t, 1e-6*got/t, got, frames);
+
+  close(pty.master);
+}
+
+int main(void)
+{
+  int errors = 0;
+
+  fprintf(stderr, "\nFILE %s compiled on %s %s\n",__FILE__,__TIME__,__DATE__);
+
+  errors += check_framing(BINLOG_FORMAT_KVH, "KVH", false);
+  errors += check_framing(BINLOG_FORMAT_MST, "MST", true);
+  errors += check_batch_alloc();
+  errors += check_monitor();
+  errors += check_trace();
+  errors += check_latency();
+  errors += check_flight_rec();
+  errors += run_latency();
+  bench_burst();
+  bench_trace();
+  bench_latency();
+  bench_flight_rec();
+
+  printf("%s\n", errors ? "serial_test FAILED" : "serial_test OK");
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of the futex helpers in spsc_ring.h.
+ *
+ */
+
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <helper_funcs/spsc_ring.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+void spsc_futex_wait(std::atomic<int>* word, int val, double timeout)
+{
+
+  timespec ts;
+  timespec* tsp = NULL;
+
+  if(timeout >= 0.0)
+    {
+      ts.tv_sec  = (time_t) floor(timeout);
+      ts.tv_nsec = (long) ((timeout - floor(timeout))*1e9);
+      tsp = &ts;
+    }
+
+  // std::atomic<int> is a plain int on Linux
+  syscall(SYS_futex, (int*) word, FUTEX_WAIT_PRIVATE, val, tsp, NULL, 0);
+
+}
+
+void spsc_futex_wake(std::atomic<int>* word)
+{
+
+  syscall(SYS_futex, (int*) word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+
+}
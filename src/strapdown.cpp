@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of strapdown.h.
+ *
+ */
+
+#include <helper_funcs/strapdown.h>
+#include <helper_funcs/quat.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+StrapdownIntegrator::StrapdownIntegrator(int hz, int rate, bool coning_)
+{
+
+  coning = coning_;
+
+  // at least one sample per update
+  decimation = (rate > 0 && hz > rate) ? hz/rate : 1;
+  dt_nominal = (hz > 0) ? 1.0/((double)hz) : 0.0;
+
+  reset();
+
+}
+
+StrapdownIntegrator::StrapdownIntegrator(const config_params& params)
+{
+
+  coning = true;
+  decimation = (params.rate > 0 && params.hz > params.rate) ? params.hz/params.rate : 1;
+  dt_nominal = (params.hz > 0) ? 1.0/((double)params.hz) : 0.0;
+
+  reset();
+
+}
+
+void StrapdownIntegrator::reset(void)
+{
+
+  alpha.setZero();
+  beta.setZero();
+  dtheta_last.setZero();
+  dt_sum = 0.0;
+  count = 0;
+
+}
+
+bool StrapdownIntegrator::push(const ImuPacket& pkt, AttitudeIncrement& out)
+{
+
+  const double dt = (pkt.dt > 0.0) ? pkt.dt : dt_nominal;
+  const Eigen::Vector3d dtheta = pkt.ang*dt;
+
+  if(coning)
+    beta += 0.5*(alpha + dtheta_last/6.0).cross(dtheta);
+
+  alpha += dtheta;
+  dtheta_last = dtheta;
+  dt_sum += dt;
+  count++;
+
+  if(count < decimation)
+    return false;
+
+  out.phi = alpha + beta;
+  out.dq = so3::quat_exp(out.phi);
+  out.t = pkt.t;
+  out.dt = dt_sum;
+  out.num_samples = count;
+
+  // the previous increment carries over into the next interval's coning term
+  alpha.setZero();
+  beta.setZero();
+  dt_sum = 0.0;
+  count = 0;
+
+  return true;
+
+}
+
+int StrapdownIntegrator::integrate(const ImuPacket* pkts, int n, AttitudeIncrement* out, int max_out)
+{
+
+  int num_out = 0;
+
+  for(int i=0; i<n && num_out<max_out; i++)
+    if(push(pkts[i], out[num_out]))
+      num_out++;
+
+  return num_out;
+
+}
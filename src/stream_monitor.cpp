@@ -0,0 +1,257 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of stream_monitor.h.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <helper_funcs/stream_monitor.h>
+#include <helper_funcs/log.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+int stream_monitor_bin(double seconds)
+{
+
+  const double us = seconds*1e6;
+
+  if(!(us >= 1.0))
+    return 0;
+  if(us >= (double) (1ULL << (STREAM_MONITOR_BINS - 2)))
+    return STREAM_MONITOR_BINS - 1;
+
+  return 64 - __builtin_clzll((unsigned long long) us);
+
+}
+
+double stream_monitor_bin_edge(int bin)
+{
+
+  return 1e-6*(double) (1ULL << bin);
+
+}
+
+// upper edge of the bin holding quantile p of the difference of two histograms
+static double stream_monitor_quantile(const uint64_t* now, const uint64_t* prev, double p)
+{
+
+  uint64_t total = 0;
+  for(int i=0; i<STREAM_MONITOR_BINS; i++)
+    total += now[i] - prev[i];
+
+  if(total == 0)
+    return 0.0;
+
+  const double want = p*total;
+  uint64_t sum = 0;
+  for(int i=0; i<STREAM_MONITOR_BINS; i++)
+    {
+      sum += now[i] - prev[i];
+      if(sum > 0 && sum >= want)
+	return stream_monitor_bin_edge(i);
+    }
+
+  return stream_monitor_bin_edge(STREAM_MONITOR_BINS - 1);
+
+}
+
+int stream_monitor_format(const StreamStats& now, const StreamStats& prev, char* buf, size_t len)
+{
+
+  const uint64_t n = now.samples - prev.samples;
+  const double jitter_rms = (n > 0) ? sqrt(std::max(0.0, now.jitter_sum2 - prev.jitter_sum2)/n) : 0.0;
+
+  return snprintf(buf, len,
+		  "n %llu gaps %llu lost %llu dup %llu ooo %llu "
+		  "jitter_rms_us %.1f jitter_max_all_us %.1f "
+		  "arrival_p50_us %.0f arrival_p99_us %.0f arrival_max_us %.0f "
+		  "arrival_jitter_p99_us %.0f arrival_jitter_max_us %.0f "
+		  "skew_ppm %.3f offset %.6f",
+		  (unsigned long long) n,
+		  (unsigned long long) (now.gaps - prev.gaps),
+		  (unsigned long long) (now.lost - prev.lost),
+		  (unsigned long long) (now.duplicates - prev.duplicates),
+		  (unsigned long long) (now.out_of_order - prev.out_of_order),
+		  1e6*jitter_rms, 1e6*now.jitter_max,
+		  1e6*stream_monitor_quantile(now.arrival, prev.arrival, 0.5),
+		  1e6*stream_monitor_quantile(now.arrival, prev.arrival, 0.99),
+		  1e6*stream_monitor_quantile(now.arrival, prev.arrival, 1.0),
+		  1e6*stream_monitor_quantile(now.arrival_jitter, prev.arrival_jitter, 0.99),
+		  1e6*stream_monitor_quantile(now.arrival_jitter, prev.arrival_jitter, 1.0),
+		  now.skew_ppm, now.offset);
+
+}
+
+StreamMonitor::StreamMonitor(double hz, uint64_t seq_modulus)
+  : period((hz > 0.0) ? 1.0/hz : 0.0), modulus(seq_modulus)
+{
+
+  reset();
+
+}
+
+void StreamMonitor::reset(void)
+{
+
+  started = false;
+  last_seq = 0;
+  last_t = last_comp = 0.0;
+  t0 = offset0 = 0.0;
+  sx = sy = sxx = sxy = 0.0;
+  memset(&local, 0, sizeof(local));
+  memset(&last_logged, 0, sizeof(last_logged));
+
+  pub_samples.store(0);
+  pub_gaps.store(0);
+  pub_lost.store(0);
+  pub_duplicates.store(0);
+  pub_out_of_order.store(0);
+  pub_jitter_sum2.store(0.0);
+  pub_jitter_max.store(0.0);
+  pub_skew_ppm.store(0.0);
+  pub_offset.store(0.0);
+  for(int i=0; i<STREAM_MONITOR_BINS; i++)
+    {
+      pub_arrival[i].store(0);
+      pub_arrival_jitter[i].store(0);
+    }
+
+}
+
+void StreamMonitor::observe(uint32_t seq_num, double timestamp, double comp_timestamp)
+{
+
+  const std::memory_order relaxed = std::memory_order_relaxed;
+  const double offset = comp_timestamp - timestamp;
+
+  local.samples++;
+  pub_samples.store(local.samples, relaxed);
+  local.offset = offset;
+  pub_offset.store(offset, relaxed);
+
+  if(!started)
+    {
+      started = true;
+      last_seq = seq_num;
+      last_t = timestamp;
+      last_comp = comp_timestamp;
+      t0 = timestamp;
+      offset0 = offset;
+      return;
+    }
+
+  // step of the sequence counter, modulo its range
+  const uint64_t range = modulus ? modulus : (1ULL << 32);
+  const uint64_t delta = ((uint64_t) seq_num + range - (uint64_t) last_seq % range) % range;
+
+  if(delta == 0)
+    {
+      local.duplicates++;
+      pub_duplicates.store(local.duplicates, relaxed);
+      return;
+    }
+  if(delta >= range/2)
+    {
+      local.out_of_order++;
+      pub_out_of_order.store(local.out_of_order, relaxed);
+      return;
+    }
+  if(delta > 1)
+    {
+      local.gaps++;
+      local.lost += delta - 1;
+      pub_gaps.store(local.gaps, relaxed);
+      pub_lost.store(local.lost, relaxed);
+    }
+
+  // sensor step against the step seq_num says it should be
+  const double dt = timestamp - last_t;
+  const double dcomp = comp_timestamp - last_comp;
+
+  if(period > 0.0)
+    {
+      const double jitter = fabs(dt - delta*period);
+      local.jitter_sum2 += jitter*jitter;
+      pub_jitter_sum2.store(local.jitter_sum2, relaxed);
+      if(jitter > local.jitter_max)
+	{
+	  local.jitter_max = jitter;
+	  pub_jitter_max.store(jitter, relaxed);
+	}
+    }
+
+  const int b0 = stream_monitor_bin(dcomp);
+  const int b1 = stream_monitor_bin(fabs(dcomp - dt));
+  pub_arrival[b0].store(++local.arrival[b0], relaxed);
+  pub_arrival_jitter[b1].store(++local.arrival_jitter[b1], relaxed);
+
+  // least-squares slope of the offset against sensor time
+  const double x = timestamp - t0;
+  const double y = offset - offset0;
+  sx += x;
+  sy += y;
+  sxx += x*x;
+  sxy += x*y;
+
+  if(local.samples % STREAM_MONITOR_SKEW_EVERY == 0)
+    {
+      // the first sample is the origin, (0, 0), and adds nothing to the sums
+      const double n = (double) (local.samples - local.duplicates - local.out_of_order);
+      const double den = n*sxx - sx*sx;
+      if(den > 0.0)
+	{
+	  local.skew_ppm = 1e6*(n*sxy - sx*sy)/den;
+	  pub_skew_ppm.store(local.skew_ppm, relaxed);
+	}
+    }
+
+  last_seq = seq_num;
+  last_t = timestamp;
+  last_comp = comp_timestamp;
+
+}
+
+void StreamMonitor::snapshot(StreamStats& st) const
+{
+
+  const std::memory_order relaxed = std::memory_order_relaxed;
+
+  st.samples = pub_samples.load(relaxed);
+  st.gaps = pub_gaps.load(relaxed);
+  st.lost = pub_lost.load(relaxed);
+  st.duplicates = pub_duplicates.load(relaxed);
+  st.out_of_order = pub_out_of_order.load(relaxed);
+  st.jitter_sum2 = pub_jitter_sum2.load(relaxed);
+  st.jitter_max = pub_jitter_max.load(relaxed);
+  st.skew_ppm = pub_skew_ppm.load(relaxed);
+  st.offset = pub_offset.load(relaxed);
+  for(int i=0; i<STREAM_MONITOR_BINS; i++)
+    {
+      st.arrival[i] = pub_arrival[i].load(relaxed);
+      st.arrival_jitter[i] = pub_arrival_jitter[i].load(relaxed);
+    }
+
+}
+
+int StreamMonitor::log_summary(int log_fid, const char* record_name)
+{
+
+  StreamStats now;
+  char buf[512];
+
+  snapshot(now);
+  stream_monitor_format(now, last_logged, buf, sizeof(buf));
+  last_logged = now;
+
+  return log_this_now_dsl_format(log_fid, (char *) record_name, buf);
+
+}
@@ -0,0 +1,203 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of sweep.h.
+ *
+ */
+
+#include <math.h>
+#include <time.h>
+#include <helper_funcs/sweep.h>
+#include <helper_funcs/observer.h>
+#include <helper_funcs/imu_log.h>
+#include <helper_funcs/thread_pool.h>
+#include <helper_funcs/config_parse.h>
+#include <helper_funcs/config_watch.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+static double sweep_now(void)
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// result of a config that is not run
+static void sweep_skip(SweepResult& result)
+{
+
+  result.ok = 0;
+  result.num_updates = 0;
+  result.elapsed = 0.0;
+  result.acc_rms = 0.0;
+  result.mag_rms = 0.0;
+  result.rph.setZero();
+  result.ang_bias.setZero();
+  result.acc_bias.setZero();
+  result.mag_bias.setZero();
+
+}
+
+// one observer run over the whole log
+static void sweep_one(const std::vector<ImuPacket>& pkts, const config_params& params, SweepResult& result)
+{
+
+  if(config_params_check(params, NULL, 0) < 0)
+    {
+      sweep_skip(result);
+      return;
+    }
+
+  const double t0 = sweep_now();
+  const int n = (int) pkts.size();
+  double acc_sq = 0.0;
+  double mag_sq = 0.0;
+
+  ObserverGains k = observer_gains(params);
+  ObserverState x;
+
+  if(n > 0)
+    observer_init(params, pkts[0], x);
+
+  for(int i=1; i<n; i++)
+    {
+      const ImuPacket& pkt = pkts[i];
+
+      acc_sq += (x.acc_hat - (pkt.acc - x.acc_bias)).squaredNorm();
+      mag_sq += (x.mag_hat - (pkt.mag - x.mag_bias)).squaredNorm();
+
+      observer_step(k, pkt, x, x);
+    }
+
+  result.ok = 1;
+  result.num_updates = (n > 1) ? n - 1 : 0;
+  result.acc_rms = (n > 1) ? sqrt(acc_sq/(n - 1)) : 0.0;
+  result.mag_rms = (n > 1) ? sqrt(mag_sq/(n - 1)) : 0.0;
+
+  if(n > 0)
+    {
+      result.rph      = rot2rph(observer_vehicle_attitude(k, x));
+      result.ang_bias = x.ang_bias;
+      result.acc_bias = x.acc_bias;
+      result.mag_bias = x.mag_bias;
+    }
+  else
+    {
+      result.rph.setZero();
+      result.ang_bias.setZero();
+      result.acc_bias.setZero();
+      result.mag_bias.setZero();
+    }
+
+  result.elapsed = sweep_now() - t0;
+
+}
+
+void sweep_run(const std::vector<ImuPacket>& pkts,
+	       const std::vector<config_params>& configs,
+	       std::vector<SweepResult>& results,
+	       int num_threads)
+{
+
+  results.resize(configs.size());
+
+  WorkStealingPool pool(num_threads);
+
+  pool.parallel_for((int) configs.size(), [&](int i) {
+      sweep_one(pkts, configs[i], results[i]);
+    });
+
+}
+
+int sweep_files(const char* log_file,
+		const std::vector<std::string>& config_files,
+		std::vector<config_params>& configs,
+		std::vector<SweepResult>& results,
+		int num_threads)
+{
+
+  std::vector<ImuPacket> pkts;
+
+  int num = imu_log_load(log_file, pkts);
+  if(num < 0)
+    return -1;
+
+  std::vector<ConfigReport> reports;
+  config_load_many(config_files, configs, &reports, num_threads);
+
+  // run only the configs that loaded and pass the check, as ConfigWatcher
+  // would accept them
+  std::vector<config_params> good;
+  std::vector<int> which;
+  for(size_t i=0; i<config_files.size(); i++)
+    {
+      char why[128];
+
+      config_report_print(stdout, config_files[i].c_str(), reports[i]);
+
+      if(reports[i].missing > 0 || reports[i].malformed > 0)
+	{
+	  const std::string first = reports[i].text.substr(0, reports[i].text.find('\n'));
+	  snprintf(why, sizeof(why), "%s", first.c_str());
+	}
+      else if(config_params_check(configs[i], why, sizeof(why)) == 0)
+	why[0] = '\0';
+
+      if(why[0] != '\0')
+	{
+	  printf("CONFIG FILE %s REJECTED: %s, not swept\n", config_files[i].c_str(), why);
+	  continue;
+	}
+
+      good.push_back(configs[i]);
+      which.push_back((int) i);
+    }
+
+  std::vector<SweepResult> good_results;
+  sweep_run(pkts, good, good_results, num_threads);
+
+  results.resize(configs.size());
+  for(size_t i=0; i<results.size(); i++)
+    sweep_skip(results[i]);
+  for(size_t j=0; j<which.size(); j++)
+    results[which[j]] = good_results[j];
+
+  return num;
+
+}
+
+void sweep_print_table(FILE* fp, const std::vector<config_params>& configs, const std::vector<SweepResult>& results)
+{
+
+  // gains are diagonal, print the first element of each
+  fprintf(fp, "%4s %9s %9s %9s %9s %9s %9s %9s %9s %12s %12s %10s %10s %10s %8s\n",
+	  "#", "k_acc", "k_mag", "k_ang_b", "k_acc_b", "k_mag_b", "k_E_n", "k_g", "k_north",
+	  "acc_rms", "mag_rms", "roll", "pitch", "heading", "time");
+
+  for(size_t i=0; i<results.size() && i<configs.size(); i++)
+    {
+      const config_params& c = configs[i];
+      const SweepResult& r = results[i];
+
+      if(!r.ok)
+	{
+	  fprintf(fp, "%4d rejected, not run\n", (int) i);
+	  continue;
+	}
+
+      fprintf(fp, "%4d %9.3g %9.3g %9.3g %9.3g %9.3g %9.3g %9.3g %9.3g %12.6e %12.6e %+10.4f %+10.4f %+10.4f %8.3f\n",
+	      (int) i,
+	      c.K_acc(0,0), c.K_mag(0,0), c.K_ang_bias(0,0), c.K_acc_bias(0,0),
+	      c.K_mag_bias(0,0), c.K_E_n(0,0), c.K_g(0,0), c.K_north(0,0),
+	      r.acc_rms, r.mag_rms,
+	      (180.0/M_PI)*r.rph(0), (180.0/M_PI)*r.rph(1), (180.0/M_PI)*r.rph(2),
+	      r.elapsed);
+    }
+
+}
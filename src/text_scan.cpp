@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of text_scan.h.
+ *
+ */
+
+#include <string.h>
+#include <helper_funcs/text_scan.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+static inline bool text_scan_is_bad(unsigned char c, int mode)
+{
+  if(mode == TEXT_SCAN_CLEAN_EOL)
+    return c == '\n' || c == '\r';
+  return (c < 0x20 && c != '\t') || c == 0x7f;
+}
+
+size_t text_scan_clean(char* str, size_t len, int mode)
+{
+
+  size_t n = 0;
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i nl    = _mm_set1_epi8('\n');
+  const __m128i cr    = _mm_set1_epi8('\r');
+  const __m128i tab   = _mm_set1_epi8('\t');
+  const __m128i del   = _mm_set1_epi8(0x7f);
+  const __m128i max   = _mm_set1_epi8(0x1f);
+
+  for(; i + 16 <= len; i += 16)
+    {
+      __m128i x = _mm_loadu_si128((const __m128i*) (str + i));
+      __m128i bad;
+
+      if(mode == TEXT_SCAN_CLEAN_EOL)
+	bad = _mm_or_si128(_mm_cmpeq_epi8(x, nl), _mm_cmpeq_epi8(x, cr));
+      else
+	{
+	  // unsigned x <= 0x1f
+	  bad = _mm_cmpeq_epi8(_mm_min_epu8(x, max), x);
+	  bad = _mm_andnot_si128(_mm_cmpeq_epi8(x, tab), bad);
+	  bad = _mm_or_si128(bad, _mm_cmpeq_epi8(x, del));
+	}
+
+      const int m = _mm_movemask_epi8(bad);
+      if(m != 0)
+	{
+	  x = _mm_or_si128(_mm_andnot_si128(bad, x), _mm_and_si128(bad, space));
+	  _mm_storeu_si128((__m128i*) (str + i), x);
+	  n += __builtin_popcount(m);
+	}
+    }
+#endif
+
+  for(; i < len; i++)
+    if(text_scan_is_bad((unsigned char) str[i], mode))
+      {
+	str[i] = ' ';
+	n++;
+      }
+
+  return n;
+
+}
+
+// [p, end) of the next space or tab delimited token at or after p
+static inline const char* text_scan_token(const char*& p, const char* end)
+{
+
+  while(p < end && (*p == ' ' || *p == '\t'))
+    p++;
+
+  const char* start = p;
+
+  while(p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+    p++;
+
+  return start;
+
+}
+
+int text_scan_split_dsl(const char* line, const char* end, DslRecordView& rec)
+{
+
+  const char* p = line;
+
+  if(end == NULL)
+    end = line + strlen(line);
+
+  // drop the line terminator
+  while(end > line && (end[-1] == '\n' || end[-1] == '\r'))
+    end--;
+
+  // name, date, time
+  const char* name = text_scan_token(p, end);
+  rec.name.p = name;
+  rec.name.len = p - name;
+
+  const char* date = text_scan_token(p, end);
+  const char* date_end = p;
+  const char* time = text_scan_token(p, end);
+
+  if(rec.name.len == 0 || date_end == date || p == time)
+    return -1;
+
+  rec.time.p = date;
+  rec.time.len = p - date;
+
+  while(p < end && (*p == ' ' || *p == '\t'))
+    p++;
+
+  rec.payload.p = p;
+  rec.payload.len = end - p;
+
+  return 0;
+
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of thread_pool.h.
+ *
+ */
+
+#include <helper_funcs/thread_pool.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+WorkStealingPool::WorkStealingPool(int num_threads)
+  : task(NULL), generation(0), active(0), joined(0), stop(false), remaining(0)
+{
+
+  if(num_threads <= 0)
+    num_threads = std::thread::hardware_concurrency();
+  if(num_threads <= 0)
+    num_threads = 1;
+
+  for(int i=0; i<num_threads; i++)
+    queues.push_back(new Queue);
+
+  for(int i=0; i<num_threads; i++)
+    threads.push_back(std::thread(&WorkStealingPool::worker, this, i));
+
+}
+
+WorkStealingPool::~WorkStealingPool(void)
+{
+
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    stop = true;
+  }
+  cv_start.notify_all();
+
+  for(size_t i=0; i<threads.size(); i++)
+    threads[i].join();
+
+  for(size_t i=0; i<queues.size(); i++)
+    delete queues[i];
+
+}
+
+void WorkStealingPool::parallel_for(int n, const std::function<void(int)>& task_)
+{
+
+  if(n <= 0)
+    return;
+
+  const int num_queues = (int) queues.size();
+
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+
+    // contiguous blocks per worker, stealing evens out the rest
+    for(int q=0; q<num_queues; q++)
+      {
+	std::lock_guard<std::mutex> qguard(queues[q]->lock);
+	for(int i=(q*n)/num_queues; i<((q+1)*n)/num_queues; i++)
+	  queues[q]->items.push_back(i);
+      }
+
+    remaining = n;
+    task = &task_;
+    joined = 0;
+    generation++;
+  }
+  cv_start.notify_all();
+
+  // wait for every task to finish and for every worker to have taken
+  // this generation and gone idle again, so no worker still holds this
+  // task, or wakes late and takes it, when we return
+  const int num_workers = (int) threads.size();
+  std::unique_lock<std::mutex> lock(mtx);
+  while(remaining > 0 || active > 0 || joined < num_workers)
+    cv_done.wait(lock);
+
+  task = NULL;
+
+}
+
+bool WorkStealingPool::pop_or_steal(int id, int& item)
+{
+
+  const int num_queues = (int) queues.size();
+
+  {
+    std::lock_guard<std::mutex> guard(queues[id]->lock);
+    if(!queues[id]->items.empty())
+      {
+	item = queues[id]->items.back();
+	queues[id]->items.pop_back();
+	return true;
+      }
+  }
+
+  for(int k=1; k<num_queues; k++)
+    {
+      Queue* victim = queues[(id + k) % num_queues];
+      std::lock_guard<std::mutex> guard(victim->lock);
+      if(!victim->items.empty())
+	{
+	  item = victim->items.front();
+	  victim->items.pop_front();
+	  return true;
+	}
+    }
+
+  return false;
+
+}
+
+void WorkStealingPool::worker(int id)
+{
+
+  unsigned seen = 0;
+
+  for(;;)
+    {
+      const std::function<void(int)>* my_task;
+
+      {
+	std::unique_lock<std::mutex> lock(mtx);
+	while(!stop && generation == seen)
+	  cv_start.wait(lock);
+	if(stop)
+	  return;
+	seen = generation;
+	my_task = task;
+	active++;
+	joined++;
+      }
+
+      int item;
+      while(pop_or_steal(id, item))
+	{
+	  (*my_task)(item);
+	  remaining--;
+	}
+
+      {
+	std::lock_guard<std::mutex> guard(mtx);
+	active--;
+      }
+      cv_done.notify_all();
+    }
+
+}
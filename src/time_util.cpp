@@ -14,6 +14,7 @@
    2008-08-13    mvj    Fixed non-threadsafe use of gmtime.
    2018-07-18   LLW     revised to extend precision of clock from ms to perhaps ns, OS dependent, for ROV_TIME_MODE_NORMAL 
                         ROV_TIME_MODE_RENAV and ROV_TIME_MODE_FASTTIME are still 1ms resolution
+   2026-10-19   AGT     Added rov_get_clock_ns() and trace spans
 ---------------------------------------------------------------------- */
 #include <stdio.h>
 #include <math.h>
@@ -34,6 +35,7 @@
 
 #include "helper_funcs/time_util.h"		/* time utilities */
 #include "helper_funcs/fasttime.h"           /* defines fasttime type */
+#include "helper_funcs/trace.h"              /* trace spans */
 
 /* variables used for controlling time */
 #define ROV_TIME_MODE_SYSTEM 0  /* Normal time, use O/S time */
@@ -349,6 +351,7 @@ rov_time_t rov_get_time(int time_mode)
    ---------------------------------------------------------------------- */
 int rov_sprintf_dsl_time_string(char * str, int time_mode)
 {
+   TRACE_SPAN("time", "rov_sprintf_dsl_time_string");
 
    // 09 JAN 2004 LLW Modified to use time_util.cpp
    rov_time_struct_t     now;
@@ -443,6 +446,7 @@ rov_time_struct_t rov_get_time_struct(void)
    ---------------------------------------------------------------------- */
 rov_time_struct_t rov_get_time_struct(int time_mode)
 {
+  TRACE_SPAN("time", "rov_get_time_struct");
 
   static int first_time = 1;
 
@@ -645,3 +649,109 @@ int rov_convert_dsl_time_string (double total_secs, char *str)
 
 }
 
+
+/* ----------------------------------------------------------------------
+
+   parses a dsl time string "YYYY/MM/DD HH:MM:SS.fraction" such as
+   written by rov_sprintf_dsl_time_string() into integer nanoseconds
+   since midnight GMT Jan 1, 1970.  The fraction may have 0 to 9 digits.
+   Parsing stops at end (or at the first NUL if end is NULL); if after
+   is not NULL it is set to the first character past the time string.
+   Returns ROV_TIME_NS_INVALID if the string is not a valid time.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written for log seeking
+
+   ---------------------------------------------------------------------- */
+static int rov_parse_digits(const char ** p, const char * end, int max_digits, long long * v)
+{
+  int n = 0;
+
+  *v = 0;
+  while((end == NULL || *p < end) && n < max_digits && **p >= '0' && **p <= '9')
+    {
+      *v = 10 * (*v) + (**p - '0');
+      (*p)++;
+      n++;
+    }
+
+  return n;
+}
+
+static int rov_parse_char(const char ** p, const char * end, char c)
+{
+  if((end != NULL && *p >= end) || **p != c)
+    return 0;
+
+  (*p)++;
+  return 1;
+}
+
+long long rov_parse_dsl_time_string_ns(const char * str, const char * end, const char ** after)
+{
+  const char * p = str;
+  long long year, month, day, hour, min, sec;
+  long long frac = 0;
+  long long y, era, yoe, doy, doe, days;
+  int n;
+
+  if((rov_parse_digits(&p, end, 4, &year) != 4) || !rov_parse_char(&p, end, '/') ||
+     (rov_parse_digits(&p, end, 2, &month) < 1) || !rov_parse_char(&p, end, '/') ||
+     (rov_parse_digits(&p, end, 2, &day) < 1)   || !rov_parse_char(&p, end, ' ') ||
+     (rov_parse_digits(&p, end, 2, &hour) < 1)  || !rov_parse_char(&p, end, ':') ||
+     (rov_parse_digits(&p, end, 2, &min) < 1)   || !rov_parse_char(&p, end, ':') ||
+     (rov_parse_digits(&p, end, 2, &sec) < 1))
+    return ROV_TIME_NS_INVALID;
+
+  if((month < 1) || (month > 12) || (day < 1) || (day > 31) ||
+     (hour > 23) || (min > 59) || (sec > 60))
+    return ROV_TIME_NS_INVALID;
+
+  if(rov_parse_char(&p, end, '.'))
+    {
+      n = rov_parse_digits(&p, end, 9, &frac);
+      for(; n < 9; n++)
+	frac *= 10;
+      // ignore digits past ns
+      while((end == NULL || p < end) && (*p >= '0') && (*p <= '9'))
+	p++;
+    }
+
+  if(after != NULL)
+    *after = p;
+
+  // days since 1970-01-01 in the proleptic Gregorian calendar
+  y    = year - (month <= 2);
+  era  = (y >= 0 ? y : y - 399) / 400;
+  yoe  = y - era * 400;
+  doy  = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  doe  = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  days = era * 146097 + doe - 719468;
+
+  return (((days * 86400) + (hour * 3600) + (min * 60) + sec) * 1000000000LL) + frac;
+}
+
+
+/* ----------------------------------------------------------------------
+
+   returns a monotonic clock in integer nanoseconds from an arbitrary
+   origin, for timing intervals.  Unlike rov_get_time() it ignores the
+   time mode and does no calendar arithmetic, so it is cheap enough to
+   call around every log record.
+
+   MODIFICATION HISTORY
+   DATE         WHO             WHAT
+   -----------  --------------  ----------------------------
+   2026-10-19   AGT             Created and written for tracing
+
+   ---------------------------------------------------------------------- */
+long long rov_get_clock_ns(void)
+{
+  timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
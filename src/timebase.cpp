@@ -0,0 +1,358 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of timebase.h.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <helper_funcs/timebase.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+#define CLOCK_ALIGN_WARMUP   20    // pairs fitted before any is down-weighted
+#define CLOCK_ALIGN_SCALE_N  1000  // memory of the residual scale (units: pairs)
+#define CLOCK_ALIGN_RECENTER 1024  // pairs between moves of the origin
+#define CLOCK_ALIGN_MIN_SCALE 1e-9 // floor of the residual scale (units: seconds)
+
+ClockAligner::ClockAligner(double memory, double huber_)
+  : lambda(1.0 - 1.0/std::max(memory, 2.0)), inv_lambda(1.0/lambda), huber(huber_)
+{
+
+  reset();
+
+}
+
+void ClockAligner::reset(void)
+{
+
+  sensor_0 = host_0 = 0.0;
+  a = 0.0;
+  b = 1.0;
+  P[0] = 1.0;
+  P[1] = 0.0;
+  P[2] = 1e-4;
+  scale = 0.0;
+  num = 0;
+  num_outliers = 0;
+
+}
+
+void ClockAligner::update(double sensor_t, double host_t)
+{
+
+  if(num == 0)
+    {
+      sensor_0 = sensor_t;
+      host_0 = host_t;
+    }
+  num++;
+
+  const double x = sensor_t - sensor_0;
+  const double r = (host_t - host_0) - (a + b*x);
+  const double abs_r = fabs(r);
+
+  // Huber weight of the residual
+  double weight = 1.0;
+  if(num > CLOCK_ALIGN_WARMUP && scale > 0.0 && abs_r > huber*scale)
+    {
+      weight = huber*scale/abs_r;
+      num_outliers++;
+    }
+
+  // weighted recursive least squares with forgetting, phi = (1, x)
+  const double Pphi0 = P[0] + P[1]*x;
+  const double Pphi1 = P[1] + P[2]*x;
+  const double inv_den = 1.0/(lambda/weight + Pphi0 + Pphi1*x);
+  const double K0 = Pphi0*inv_den;
+  const double K1 = Pphi1*inv_den;
+
+  a += K0*r;
+  b += K1*r;
+  P[0] = (P[0] - K0*Pphi0)*inv_lambda;
+  P[1] = (P[1] - K0*Pphi1)*inv_lambda;
+  P[2] = (P[2] - K1*Pphi1)*inv_lambda;
+
+  // scale from the mean absolute residual, clipped like the fit; the floor
+  // keeps exact timestamps out of denormals
+  const double alpha = (num < CLOCK_ALIGN_SCALE_N) ? 1.0/num : 1.0/CLOCK_ALIGN_SCALE_N;
+  const double clipped = (scale > 0.0) ? std::min(abs_r, huber*scale) : abs_r;
+  scale = std::max(scale + alpha*(1.2533*clipped - scale), CLOCK_ALIGN_MIN_SCALE);
+
+  // keep the origin near the data so a stays the offset here
+  if(num % CLOCK_ALIGN_RECENTER == 0)
+    {
+      const double c = x;
+      a += b*c;
+      P[0] += 2.0*c*P[1] + c*c*P[2];
+      P[1] += c*P[2];
+      sensor_0 += c;
+    }
+
+}
+
+void ClockAligner::update(const double* sensor_t, const double* host_t, size_t n)
+{
+
+  for(size_t i=0; i<n; i++)
+    update(sensor_t[i], host_t[i]);
+
+}
+
+void ClockAligner::to_host(const double* sensor_t, double* host_t, size_t n) const
+{
+
+  const double c = host_0 + a - b*sensor_0;
+
+  for(size_t i=0; i<n; i++)
+    host_t[i] = c + b*sensor_t[i];
+
+}
+
+ImuResampler::ImuResampler(double rate, int method_, double max_gap_)
+  : step(1.0/rate), method(method_), max_gap(max_gap_)
+{
+
+  reset();
+
+}
+
+void ImuResampler::reset(void)
+{
+
+  started = false;
+  k_next = 0;
+  work.clear();
+
+}
+
+size_t ImuResampler::process(const ImuBatchView& in, ImuBatch& out)
+{
+
+  const size_t old = work.size();
+  const size_t n = in.size;
+
+  work.resize(old + n);
+  for(int a=0; a<9; a++)
+    memcpy(work.axis((ImuVec) (a/3), a%3) + old, in.axis[a], n*sizeof(double));
+  memcpy(work.t() + old, in.t, n*sizeof(double));
+  memcpy(work.dt() + old, in.dt, n*sizeof(double));
+  memcpy(work.seq_num() + old, in.seq_num, n*sizeof(int32_t));
+  memcpy(work.fluid_pressure() + old, in.fluid_pressure, n*sizeof(float));
+
+  return run(out, false);
+
+}
+
+size_t ImuResampler::flush(ImuBatch& out)
+{
+
+  const size_t n = run(out, true);
+  reset();
+
+  return n;
+
+}
+
+// drop the samples before from
+void ImuResampler::keep(size_t from)
+{
+
+  const size_t n = work.size() - from;
+
+  if(from == 0)
+    return;
+
+  for(int a=0; a<9; a++)
+    {
+      double* x = work.axis((ImuVec) (a/3), a%3);
+      memmove(x, x + from, n*sizeof(double));
+    }
+  memmove(work.t(), work.t() + from, n*sizeof(double));
+  memmove(work.dt(), work.dt() + from, n*sizeof(double));
+  memmove(work.seq_num(), work.seq_num() + from, n*sizeof(int32_t));
+  memmove(work.fluid_pressure(), work.fluid_pressure() + from, n*sizeof(float));
+  work.resize(n);
+
+}
+
+size_t ImuResampler::run(ImuBatch& out, bool final)
+{
+
+  const size_t W = work.size();
+  const double* t = work.t();
+  const bool cubic = (method == RESAMPLE_CUBIC);
+
+  if(W == 0)
+    return 0;
+
+  if(!started)
+    {
+      k_next = (int64_t) ceil(t[0]/step);
+      started = true;
+    }
+
+  // plan: the bracketing sample and weights of every grid time we can do,
+  // into arrays sized for the most grid times the block can hold
+  const int stride = cubic ? 4 : 1;
+  const size_t most = (size_t) std::max(0.0, (t[W - 1] - k_next*step)/step) + 2;
+  if(grid.size() < most)
+    {
+      grid.resize(most);
+      nb.resize(stride*most);
+      w.resize(stride*most);
+    }
+
+  size_t i = 0;
+  size_t n_out = 0;
+  for(;;)
+    {
+      const double g = k_next*step;
+
+      while(i + 1 < W && t[i + 1] <= g)
+	i++;
+
+      if(i + 1 >= W || (cubic && i + 2 >= W && !final))
+	break;
+
+      if(g < t[i] || (max_gap > 0.0 && t[i + 1] - t[i] > max_gap))
+	{
+	  k_next++;
+	  continue;
+	}
+
+      const double u = (g - t[i])/(t[i + 1] - t[i]);
+      grid[n_out] = g;
+      if(cubic)
+	{
+	  // Catmull-Rom; the missing neighbour at either end is repeated
+	  const double u2 = u*u, u3 = u2*u;
+	  int* k = &nb[4*n_out];
+	  double* c = &w[4*n_out];
+	  k[0] = (int) ((i > 0) ? i - 1 : 0);
+	  k[1] = (int) i;
+	  k[2] = (int) i + 1;
+	  k[3] = (int) std::min(i + 2, W - 1);
+	  c[0] = 0.5*(-u3 + 2.0*u2 - u);
+	  c[1] = 0.5*(3.0*u3 - 5.0*u2 + 2.0);
+	  c[2] = 0.5*(-3.0*u3 + 4.0*u2 + u);
+	  c[3] = 0.5*(u3 - u2);
+	}
+      else
+	{
+	  nb[n_out] = (int) i;
+	  w[n_out] = u;
+	}
+      n_out++;
+      k_next++;
+    }
+
+  // apply it to every axis
+  const size_t old = out.size();
+  out.resize(old + n_out);
+
+  for(int a=0; a<9; a++)
+    {
+      const double* x = work.axis((ImuVec) (a/3), a%3);
+      double* y = out.axis((ImuVec) (a/3), a%3) + old;
+
+      if(cubic)
+	for(size_t j=0; j<n_out; j++)
+	  {
+	    const int* k = &nb[4*j];
+	    const double* c = &w[4*j];
+	    y[j] = c[0]*x[k[0]] + c[1]*x[k[1]] + c[2]*x[k[2]] + c[3]*x[k[3]];
+	  }
+      else
+	for(size_t j=0; j<n_out; j++)
+	  {
+	    const int k = nb[j];
+	    y[j] = x[k] + w[j]*(x[k + 1] - x[k]);
+	  }
+    }
+
+  const int left = cubic ? 1 : 0;
+  for(size_t j=0; j<n_out; j++)
+    {
+      const int k = nb[stride*j + left];
+      const double tk = t[k];
+      const double u = (grid[j] - tk)/(t[k + 1] - tk);
+      const float* fp = work.fluid_pressure();
+      out.t()[old + j] = grid[j];
+      out.dt()[old + j] = step;
+      out.seq_num()[old + j] = work.seq_num()[k];
+      out.fluid_pressure()[old + j] = (float) (fp[k] + u*(fp[k + 1] - fp[k]));
+    }
+
+  // keep what the next grid time needs: the bracketing sample, and the one
+  // before it for cubic
+  keep((cubic && i > 0) ? i - 1 : i);
+
+  return n_out;
+
+}
+
+AttitudeResampler::AttitudeResampler(double rate, double max_gap_)
+  : step(1.0/rate), max_gap(max_gap_)
+{
+
+  reset();
+
+}
+
+void AttitudeResampler::reset(void)
+{
+
+  started = false;
+  k_next = 0;
+  t_last = 0.0;
+  q_last = Eigen::Quaterniond::Identity();
+
+}
+
+size_t AttitudeResampler::process(const double* t, const Eigen::Quaterniond* q, size_t n,
+				  std::vector<double>& t_out, QuaternionVector& q_out)
+{
+
+  const size_t old = t_out.size();
+  size_t i = 0;
+
+  if(n == 0)
+    return 0;
+
+  if(!started)
+    {
+      t_last = t[0];
+      q_last = q[0];
+      k_next = (int64_t) ceil(t[0]/step);
+      started = true;
+      i = 1;
+    }
+
+  // grid times in [t_last, t[i]) come from that segment
+  for(; i<n; i++)
+    {
+      const double span = t[i] - t_last;
+      const bool gap = (max_gap > 0.0 && span > max_gap);
+
+      for(double g = k_next*step; g < t[i]; g = (++k_next)*step)
+	if(g >= t_last && !gap)
+	  {
+	    t_out.push_back(g);
+	    q_out.push_back(q_last.slerp((g - t_last)/span, q[i]));
+	  }
+
+      t_last = t[i];
+      q_last = q[i];
+    }
+
+  return t_out.size() - old;
+
+}
@@ -0,0 +1,324 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Implementation of trace.h.
+ *
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <helper_funcs/trace.h>
+#include <helper_funcs/log.h>
+
+
+/*
+ *
+ * SEE HEADER FILE FOR DOCUMENTATION
+ *
+ */
+
+std::atomic<bool> trace_on(false);
+
+struct TraceRecord
+{
+
+  const char* cat;
+  const char* name;
+  long long ts_ns;
+  union
+  {
+    long long dur_ns;
+    double value;
+  };
+  char phase;
+
+};
+
+// one thread's ring: the thread pushes at head, the exporter pops at tail
+struct TraceBuffer
+{
+
+  TraceRecord ev[TRACE_BUFFER_EVENTS];
+  std::atomic<unsigned long long> head;
+  std::atomic<unsigned long long> tail;
+  std::atomic<bool> alive;
+  int tid;
+  char name[32]; // under trace_mutex
+
+  TraceBuffer(void) : head(0), tail(0), alive(true), tid(0) { name[0] = '\0'; }
+
+};
+
+static std::mutex trace_mutex; // the registry and its names
+static std::vector<TraceBuffer*> trace_buffers;
+static std::atomic<unsigned long long> trace_num_dropped(0);
+
+// marks the thread's ring free for reuse when the thread ends
+struct TraceThread
+{
+
+  TraceBuffer* buf;
+
+  TraceThread(void) : buf(NULL) {}
+  ~TraceThread(void) { if(buf) buf->alive.store(false, std::memory_order_release); }
+
+};
+
+static thread_local TraceThread trace_thread;
+
+static TraceBuffer* trace_buffer(void)
+{
+
+  if(trace_thread.buf)
+    return trace_thread.buf;
+
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  TraceBuffer* b = NULL;
+
+  // a ring whose thread has ended and whose events are all exported
+  for(size_t i=0; i<trace_buffers.size() && !b; i++)
+    if(!trace_buffers[i]->alive.load(std::memory_order_acquire) &&
+       trace_buffers[i]->head.load() == trace_buffers[i]->tail.load())
+      b = trace_buffers[i];
+
+  if(!b)
+    {
+      b = new TraceBuffer;
+      trace_buffers.push_back(b);
+    }
+
+  b->alive.store(true);
+  b->tid = (int) syscall(SYS_gettid);
+  b->name[0] = '\0';
+  trace_thread.buf = b;
+
+  return b;
+
+}
+
+void trace_enable(bool on)
+{
+
+  trace_on.store(on);
+
+}
+
+static void trace_push(const TraceRecord& rec)
+{
+
+  TraceBuffer* b = trace_buffer();
+  const unsigned long long h = b->head.load(std::memory_order_relaxed);
+
+  if(h - b->tail.load(std::memory_order_acquire) >= TRACE_BUFFER_EVENTS)
+    {
+      trace_num_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+  b->ev[h & (TRACE_BUFFER_EVENTS - 1)] = rec;
+  b->head.store(h + 1, std::memory_order_release);
+
+}
+
+void trace_event(char phase, const char* cat, const char* name, long long ts_ns, long long arg)
+{
+
+  TraceRecord r;
+  r.cat = cat;
+  r.name = name;
+  r.ts_ns = ts_ns;
+  r.dur_ns = arg;
+  r.phase = phase;
+
+  trace_push(r);
+
+}
+
+void trace_counter(const char* cat, const char* name, double value)
+{
+
+  TraceRecord r;
+  r.cat = cat;
+  r.name = name;
+  r.ts_ns = rov_get_clock_ns();
+  r.value = value;
+  r.phase = 'C';
+
+  trace_push(r);
+
+}
+
+void trace_thread_name(const char* name)
+{
+
+  TraceBuffer* b = trace_buffer();
+  std::lock_guard<std::mutex> lock(trace_mutex);
+
+  // nothing that needs escaping in JSON
+  size_t i = 0;
+  for(; name[i] && i < sizeof(b->name) - 1; i++)
+    b->name[i] = (name[i] == '"' || name[i] == '\\' || (unsigned char) name[i] < ' ') ? '_' : name[i];
+  b->name[i] = '\0';
+
+}
+
+unsigned long long trace_dropped(void)
+{
+
+  return trace_num_dropped.load(std::memory_order_relaxed);
+
+}
+
+// append the events of every ring, and the thread names if asked, as JSON
+// lines; oldest_ns is lowered to the earliest event's start
+static int trace_drain(std::string& out, bool names, long long& oldest_ns)
+{
+
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  const int pid = (int) getpid();
+  char line[512];
+  int n = 0;
+
+  for(size_t k=0; k<trace_buffers.size(); k++)
+    {
+      TraceBuffer* b = trace_buffers[k];
+      const unsigned long long t = b->tail.load(std::memory_order_relaxed);
+      const unsigned long long h = b->head.load(std::memory_order_acquire);
+
+      if(names && b->name[0])
+	{
+	  snprintf(line, sizeof(line),
+		   "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+		   pid, b->tid, b->name);
+	  out += line;
+	}
+
+      for(unsigned long long i=t; i<h; i++)
+	{
+	  const TraceRecord& r = b->ev[i & (TRACE_BUFFER_EVENTS - 1)];
+	  const double ts = 1e-3*r.ts_ns;
+
+	  if(r.phase == 'X')
+	    snprintf(line, sizeof(line),
+		     "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d},\n",
+		     r.name, r.cat, ts, 1e-3*r.dur_ns, pid, b->tid);
+	  else if(r.phase == 'C')
+	    snprintf(line, sizeof(line),
+		     "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"value\":%.9g}},\n",
+		     r.name, r.cat, ts, pid, b->tid, r.value);
+	  else
+	    snprintf(line, sizeof(line),
+		     "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d},\n",
+		     r.name, r.cat, ts, pid, b->tid);
+	  out += line;
+	  n++;
+	  if(r.ts_ns < oldest_ns)
+	    oldest_ns = r.ts_ns;
+	}
+
+      b->tail.store(h, std::memory_order_release);
+    }
+
+  return n;
+
+}
+
+int trace_export(FILE* fp)
+{
+
+  std::string out;
+  long long oldest_ns = LLONG_MAX;
+  const int n = trace_drain(out, true, oldest_ns);
+
+  fwrite(out.data(), 1, out.size(), fp);
+
+  return n;
+
+}
+
+int trace_export_log(int log_fid)
+{
+
+  static std::mutex export_mutex;
+  static std::string last_file;
+  std::lock_guard<std::mutex> lock(export_mutex);
+  std::string out;
+  long long oldest_ns = LLONG_MAX;
+
+  const int n = trace_drain(out, false, oldest_ns);
+  if(!out.empty())
+    {
+      log_this_now(log_fid, (char *) out.data(), (int) out.size());
+      // how long the oldest event waited in its ring
+      log_record_queue_wait(log_fid, rov_get_clock_ns() - oldest_ns);
+    }
+
+  // names go to every file; order does not matter in the format
+  const char* file = log_get_filename(log_fid);
+  if(last_file != file)
+    {
+      last_file = file;
+      out.clear();
+      trace_drain(out, true, oldest_ns);
+      log_this_now(log_fid, (char *) out.data(), (int) out.size());
+    }
+
+  return n;
+
+}
+
+static std::thread trace_exporter;
+static std::mutex trace_exporter_mutex;
+static std::condition_variable trace_exporter_cv;
+static bool trace_exporter_stop = false;
+
+int trace_start_exporter(int log_fid, double period)
+{
+
+  if(trace_exporter.joinable())
+    return -1;
+
+  trace_exporter_stop = false;
+  trace_enable(true);
+
+  trace_exporter = std::thread([log_fid, period]() {
+      trace_thread_name("trace_export");
+      std::unique_lock<std::mutex> lock(trace_exporter_mutex);
+      while(!trace_exporter_stop)
+	{
+	  trace_exporter_cv.wait_for(lock, std::chrono::microseconds((long long) (1e6*period)));
+	  lock.unlock();
+	  trace_export_log(log_fid);
+	  lock.lock();
+	}
+      lock.unlock();
+      trace_export_log(log_fid);
+    });
+
+  return 0;
+
+}
+
+void trace_stop_exporter(void)
+{
+
+  if(!trace_exporter.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(trace_exporter_mutex);
+    trace_exporter_stop = true;
+  }
+  trace_exporter_cv.notify_all();
+  trace_exporter.join();
+
+}